@@ -0,0 +1,836 @@
+#pragma once
+
+#include "../../meta_reader.h"
+#include "../../task_group.h"
+#include "pe_writer.h"
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace xlang::impl
+{
+    enum class column_type : uint8_t
+    {
+        fixed2,
+        fixed4,
+        string,
+        guid,
+        blob,
+        index,
+        coded_index,
+    };
+
+    struct metadata_column
+    {
+        column_type type;
+        uint8_t table{}; // For index columns
+        uint8_t const* tables{}; // For coded index columns, where zero is used for unused tags
+        uint8_t table_count{};
+    };
+
+    namespace columns
+    {
+        inline constexpr metadata_column fixed2{ column_type::fixed2 };
+        inline constexpr metadata_column fixed4{ column_type::fixed4 };
+        inline constexpr metadata_column string{ column_type::string };
+        inline constexpr metadata_column guid{ column_type::guid };
+        inline constexpr metadata_column blob{ column_type::blob };
+
+        constexpr metadata_column index(uint8_t const table) noexcept
+        {
+            return { column_type::index, table };
+        }
+
+        template <std::size_t N>
+        constexpr metadata_column coded_index(uint8_t const (&tables)[N]) noexcept
+        {
+            return { column_type::coded_index, 0, tables, static_cast<uint8_t>(N) };
+        }
+
+        // The tables that each coded index can refer to, in tag order. 0xff marks a tag that is not used
+        inline constexpr uint8_t TypeDefOrRef[]{ 0x02, 0x01, 0x1b };
+        inline constexpr uint8_t HasConstant[]{ 0x04, 0x08, 0x17 };
+        inline constexpr uint8_t HasCustomAttribute[]{ 0x06, 0x04, 0x01, 0x02, 0x08, 0x09, 0x0a, 0x00, 0x17, 0x14, 0x11, 0x1a, 0x1b, 0x20, 0x23, 0x26, 0x27, 0x28, 0x2a, 0x2c, 0x2b };
+        inline constexpr uint8_t HasFieldMarshal[]{ 0x04, 0x08 };
+        inline constexpr uint8_t HasDeclSecurity[]{ 0x02, 0x06, 0x20 };
+        inline constexpr uint8_t MemberRefParent[]{ 0x02, 0x01, 0x1a, 0x06, 0x1b };
+        inline constexpr uint8_t HasSemantics[]{ 0x14, 0x17 };
+        inline constexpr uint8_t MethodDefOrRef[]{ 0x06, 0x0a };
+        inline constexpr uint8_t MemberForwarded[]{ 0x04, 0x06 };
+        inline constexpr uint8_t Implementation[]{ 0x26, 0x23, 0x27 };
+        inline constexpr uint8_t CustomAttributeType[]{ 0xff, 0xff, 0x06, 0x0a, 0xff };
+        inline constexpr uint8_t ResolutionScope[]{ 0x00, 0x1a, 0x23, 0x01 };
+        inline constexpr uint8_t TypeOrMethodDef[]{ 0x02, 0x06 };
+    }
+
+    inline void write_u16(uint8_t*& data, uint32_t const value) noexcept
+    {
+        XLANG_ASSERT(value <= UINT16_MAX);
+        data[0] = static_cast<uint8_t>(value);
+        data[1] = static_cast<uint8_t>(value >> 8);
+        data += 2;
+    }
+
+    inline void write_u32(uint8_t*& data, uint32_t const value) noexcept
+    {
+        data[0] = static_cast<uint8_t>(value);
+        data[1] = static_cast<uint8_t>(value >> 8);
+        data[2] = static_cast<uint8_t>(value >> 16);
+        data[3] = static_cast<uint8_t>(value >> 24);
+        data += 4;
+    }
+
+    inline uint32_t round_up(uint32_t const size) noexcept
+    {
+        return (size + 3) & ~3u;
+    }
+
+    // Stably sorts the row numbers in order by their keys. Tables large enough to be worth it are split into one run per
+    // thread, which are sorted concurrently and then merged
+    inline void parallel_stable_sort(std::vector<uint32_t>& order, std::vector<uint64_t> const& keys,
+        std::size_t const threads = (std::max)(1u, std::thread::hardware_concurrency()))
+    {
+        auto compare = [&](uint32_t const lhs, uint32_t const rhs)
+        {
+            return keys[lhs] < keys[rhs];
+        };
+
+        // Split into one run per thread, sort the runs concurrently and then merge neighbouring runs until one is left
+        std::size_t const min_run{ 64 * 1024 };
+        std::size_t const runs = (std::min)(threads, (order.size() + min_run - 1) / min_run);
+
+        if (runs <= 1)
+        {
+            std::stable_sort(order.begin(), order.end(), compare);
+            return;
+        }
+
+        std::vector<std::size_t> bounds;
+
+        for (std::size_t run{}; run <= runs; ++run)
+        {
+            bounds.push_back(order.size() * run / runs);
+        }
+
+        {
+            task_group group;
+
+            for (std::size_t run{}; run < runs; ++run)
+            {
+                group.add([&, run]
+                {
+                    std::stable_sort(order.begin() + bounds[run], order.begin() + bounds[run + 1], compare);
+                });
+            }
+
+            group.get();
+        }
+
+        while (bounds.size() > 2)
+        {
+            std::vector<std::size_t> merged;
+            task_group group;
+
+            for (std::size_t run{}; run + 1 < bounds.size(); run += 2)
+            {
+                merged.push_back(bounds[run]);
+
+                if (run + 2 < bounds.size())
+                {
+                    group.add([&, run]
+                    {
+                        std::inplace_merge(order.begin() + bounds[run], order.begin() + bounds[run + 1], order.begin() + bounds[run + 2], compare);
+                    });
+                }
+            }
+
+            group.get();
+            merged.push_back(bounds.back());
+            bounds = std::move(merged);
+        }
+    }
+
+    // The '#Strings' and '#Blob' heaps. Entries are written once, into chunks that never move, so that the index used to
+    // deduplicate them can refer to the heap's own copy of each entry
+    struct heap_builder
+    {
+        heap_builder(heap_builder const&) = delete;
+        heap_builder& operator=(heap_builder const&) = delete;
+
+        heap_builder()
+        {
+            // Both heaps start with the empty entry
+            *allocate(1).second = 0;
+        }
+
+        uint32_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        void write(uint8_t* data) const noexcept
+        {
+            for (auto&& chunk : m_chunks)
+            {
+                std::memcpy(data, chunk.data.get(), chunk.size);
+                data += chunk.size;
+            }
+
+            std::memset(data, 0, round_up(m_size) - m_size);
+        }
+
+    protected:
+        std::pair<uint32_t, uint8_t*> allocate(std::size_t const size)
+        {
+            if (m_chunks.empty() || m_chunks.back().capacity - m_chunks.back().size < size)
+            {
+                auto const capacity = (std::max)(size, chunk_size);
+                m_chunks.push_back({ std::make_unique<uint8_t[]>(capacity), 0, capacity });
+            }
+
+            if (size > UINT32_MAX - m_size)
+            {
+                throw_invalid("Metadata heap exceeds 4GB");
+            }
+
+            auto& chunk = m_chunks.back();
+            auto data = chunk.data.get() + chunk.size;
+            chunk.size += size;
+            auto const offset = m_size;
+            m_size += static_cast<uint32_t>(size);
+            return { offset, data };
+        }
+
+        std::unordered_map<std::string_view, uint32_t> m_index;
+
+    private:
+        static constexpr std::size_t chunk_size{ 64 * 1024 };
+
+        struct chunk
+        {
+            std::unique_ptr<uint8_t[]> data;
+            std::size_t size;
+            std::size_t capacity;
+        };
+
+        std::vector<chunk> m_chunks;
+        uint32_t m_size{};
+    };
+}
+
+namespace xlang::meta::writer
+{
+    struct string_heap : impl::heap_builder
+    {
+        uint32_t add(std::string_view const& value)
+        {
+            if (value.empty())
+            {
+                return 0;
+            }
+
+            if (auto existing = m_index.find(value); existing != m_index.end())
+            {
+                return existing->second;
+            }
+
+            auto [offset, data] = allocate(value.size() + 1);
+            std::memcpy(data, value.data(), value.size());
+            data[value.size()] = 0;
+            m_index.emplace(std::string_view{ reinterpret_cast<char const*>(data), value.size() }, offset);
+            return offset;
+        }
+    };
+
+    struct blob_heap : impl::heap_builder
+    {
+        uint32_t add(uint8_t const* const first, std::size_t const size)
+        {
+            if (size == 0)
+            {
+                return 0;
+            }
+
+            std::string_view const value{ reinterpret_cast<char const*>(first), size };
+
+            if (auto existing = m_index.find(value); existing != m_index.end())
+            {
+                return existing->second;
+            }
+
+            if (size > 0x1fffffff)
+            {
+                throw_invalid("Blob exceeds the maximum encodable size");
+            }
+
+            auto const length = static_cast<uint32_t>(size);
+            uint8_t const prefix = length < 0x80 ? 1 : length < 0x4000 ? 2 : 4;
+            auto [offset, data] = allocate(prefix + size);
+
+            switch (prefix)
+            {
+            case 1:
+                data[0] = static_cast<uint8_t>(length);
+                break;
+            case 2:
+                data[0] = static_cast<uint8_t>(0x80 | (length >> 8));
+                data[1] = static_cast<uint8_t>(length);
+                break;
+            default:
+                data[0] = static_cast<uint8_t>(0xc0 | (length >> 24));
+                data[1] = static_cast<uint8_t>(length >> 16);
+                data[2] = static_cast<uint8_t>(length >> 8);
+                data[3] = static_cast<uint8_t>(length);
+                break;
+            }
+
+            std::memcpy(data + prefix, first, size);
+            m_index.emplace(std::string_view{ reinterpret_cast<char const*>(data + prefix), size }, offset);
+            return offset;
+        }
+
+        uint32_t add(std::vector<uint8_t> const& value)
+        {
+            return add(value.data(), value.size());
+        }
+    };
+
+    struct guid_heap
+    {
+        // GUID indexes are one-based
+        uint32_t add(std::array<uint8_t, 16> const& value)
+        {
+            auto [pos, inserted] = m_index.try_emplace(value, static_cast<uint32_t>(m_guids.size() + 1));
+
+            if (inserted)
+            {
+                m_guids.push_back(value);
+            }
+
+            return pos->second;
+        }
+
+        uint32_t size() const noexcept
+        {
+            return static_cast<uint32_t>(m_guids.size() * 16);
+        }
+
+        uint32_t count() const noexcept
+        {
+            return static_cast<uint32_t>(m_guids.size());
+        }
+
+        void write(uint8_t* data) const noexcept
+        {
+            for (auto&& guid : m_guids)
+            {
+                data = std::copy(guid.begin(), guid.end(), data);
+            }
+        }
+
+    private:
+        std::vector<std::array<uint8_t, 16>> m_guids;
+        std::map<std::array<uint8_t, 16>, uint32_t> m_index;
+    };
+
+    // Coded indexes are encoded with the same tags that the reader uses to decode them
+    template <typename T>
+    uint32_t encode_index(T const type, uint32_t const row) noexcept
+    {
+        XLANG_ASSERT(row);
+        return (row << reader::coded_index_bits_v<T>) | static_cast<uint32_t>(type);
+    }
+
+    struct table_builder
+    {
+        table_builder(table_builder const&) = delete;
+        table_builder& operator=(table_builder const&) = delete;
+
+        table_builder(uint8_t const id, std::initializer_list<impl::metadata_column> columns) :
+            m_id{ id },
+            m_columns{ columns }
+        {
+        }
+
+        // Rows are one-based, as are the indexes that refer to them
+        uint32_t add(std::initializer_list<uint32_t> values)
+        {
+            XLANG_ASSERT(values.size() == m_columns.size());
+            m_values.insert(m_values.end(), values.begin(), values.end());
+            return size();
+        }
+
+        uint32_t size() const noexcept
+        {
+            return static_cast<uint32_t>(m_values.size() / m_columns.size());
+        }
+
+        uint32_t& value(uint32_t const row, uint32_t const column) noexcept
+        {
+            XLANG_ASSERT(row && row <= size());
+            XLANG_ASSERT(column < m_columns.size());
+            return m_values[(row - 1) * m_columns.size() + column];
+        }
+
+        uint32_t value(uint32_t const row, uint32_t const column) const noexcept
+        {
+            XLANG_ASSERT(row && row <= size());
+            XLANG_ASSERT(column < m_columns.size());
+            return m_values[(row - 1) * m_columns.size() + column];
+        }
+
+        uint8_t id() const noexcept
+        {
+            return m_id;
+        }
+
+        std::vector<impl::metadata_column> const& columns() const noexcept
+        {
+            return m_columns;
+        }
+
+        void reserve(uint32_t const rows)
+        {
+            m_values.reserve(static_cast<std::size_t>(rows) * m_columns.size());
+        }
+
+    private:
+        friend struct metadata_builder;
+
+        uint8_t m_id;
+        std::vector<impl::metadata_column> m_columns;
+        std::vector<uint32_t> m_values;
+    };
+
+    // Builds the '#~', '#Strings', '#Blob' and '#GUID' streams of a metadata file. The tables mirror the reader's
+    // 'database', and rows are added in the order in which they are to be written, except for the tables that must be
+    // sorted, which are sorted when the metadata is saved. Index columns are sized once all of the rows are known
+    struct metadata_builder
+    {
+        metadata_builder(metadata_builder const&) = delete;
+        metadata_builder& operator=(metadata_builder const&) = delete;
+
+        explicit metadata_builder(std::string_view const& version = "WindowsRuntime 1.4") : m_version{ version }
+        {
+        }
+
+        uint32_t string(std::string_view const& value)
+        {
+            return m_strings.add(value);
+        }
+
+        uint32_t blob(std::vector<uint8_t> const& value)
+        {
+            return m_blobs.add(value);
+        }
+
+        uint32_t blob(uint8_t const* const first, std::size_t const size)
+        {
+            return m_blobs.add(first, size);
+        }
+
+        uint32_t guid(std::array<uint8_t, 16> const& value)
+        {
+            return m_guids.add(value);
+        }
+
+        table_builder TypeRef{ 0x01, { impl::columns::coded_index(impl::columns::ResolutionScope), impl::columns::string, impl::columns::string } };
+        table_builder GenericParamConstraint{ 0x2c, { impl::columns::index(0x2a), impl::columns::coded_index(impl::columns::TypeDefOrRef) } };
+        table_builder TypeSpec{ 0x1b, { impl::columns::blob } };
+        table_builder TypeDef{ 0x02, { impl::columns::fixed4, impl::columns::string, impl::columns::string, impl::columns::coded_index(impl::columns::TypeDefOrRef), impl::columns::index(0x04), impl::columns::index(0x06) } };
+        table_builder CustomAttribute{ 0x0c, { impl::columns::coded_index(impl::columns::HasCustomAttribute), impl::columns::coded_index(impl::columns::CustomAttributeType), impl::columns::blob } };
+        table_builder MethodDef{ 0x06, { impl::columns::fixed4, impl::columns::fixed2, impl::columns::fixed2, impl::columns::string, impl::columns::blob, impl::columns::index(0x08) } };
+        table_builder MemberRef{ 0x0a, { impl::columns::coded_index(impl::columns::MemberRefParent), impl::columns::string, impl::columns::blob } };
+        table_builder Module{ 0x00, { impl::columns::fixed2, impl::columns::string, impl::columns::guid, impl::columns::guid, impl::columns::guid } };
+        table_builder Param{ 0x08, { impl::columns::fixed2, impl::columns::fixed2, impl::columns::string } };
+        table_builder InterfaceImpl{ 0x09, { impl::columns::index(0x02), impl::columns::coded_index(impl::columns::TypeDefOrRef) } };
+        table_builder Constant{ 0x0b, { impl::columns::fixed2, impl::columns::coded_index(impl::columns::HasConstant), impl::columns::blob } };
+        table_builder Field{ 0x04, { impl::columns::fixed2, impl::columns::string, impl::columns::blob } };
+        table_builder FieldMarshal{ 0x0d, { impl::columns::coded_index(impl::columns::HasFieldMarshal), impl::columns::blob } };
+        table_builder DeclSecurity{ 0x0e, { impl::columns::fixed2, impl::columns::coded_index(impl::columns::HasDeclSecurity), impl::columns::blob } };
+        table_builder ClassLayout{ 0x0f, { impl::columns::fixed2, impl::columns::fixed4, impl::columns::index(0x02) } };
+        table_builder FieldLayout{ 0x10, { impl::columns::fixed4, impl::columns::index(0x04) } };
+        table_builder StandAloneSig{ 0x11, { impl::columns::blob } };
+        table_builder EventMap{ 0x12, { impl::columns::index(0x02), impl::columns::index(0x14) } };
+        table_builder Event{ 0x14, { impl::columns::fixed2, impl::columns::string, impl::columns::coded_index(impl::columns::TypeDefOrRef) } };
+        table_builder PropertyMap{ 0x15, { impl::columns::index(0x02), impl::columns::index(0x17) } };
+        table_builder Property{ 0x17, { impl::columns::fixed2, impl::columns::string, impl::columns::blob } };
+        table_builder MethodSemantics{ 0x18, { impl::columns::fixed2, impl::columns::index(0x06), impl::columns::coded_index(impl::columns::HasSemantics) } };
+        table_builder MethodImpl{ 0x19, { impl::columns::index(0x02), impl::columns::coded_index(impl::columns::MethodDefOrRef), impl::columns::coded_index(impl::columns::MethodDefOrRef) } };
+        table_builder ModuleRef{ 0x1a, { impl::columns::string } };
+        table_builder ImplMap{ 0x1c, { impl::columns::fixed2, impl::columns::coded_index(impl::columns::MemberForwarded), impl::columns::string, impl::columns::index(0x1a) } };
+        table_builder FieldRVA{ 0x1d, { impl::columns::fixed4, impl::columns::index(0x04) } };
+        // The four 16-bit version numbers are written as separate columns
+        table_builder Assembly{ 0x20, { impl::columns::fixed4, impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed4, impl::columns::blob, impl::columns::string, impl::columns::string } };
+        table_builder AssemblyProcessor{ 0x21, { impl::columns::fixed4 } };
+        table_builder AssemblyOS{ 0x22, { impl::columns::fixed4, impl::columns::fixed4, impl::columns::fixed4 } };
+        table_builder AssemblyRef{ 0x23, { impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed2, impl::columns::fixed4, impl::columns::blob, impl::columns::string, impl::columns::string, impl::columns::blob } };
+        table_builder AssemblyRefProcessor{ 0x24, { impl::columns::fixed4, impl::columns::index(0x23) } };
+        table_builder AssemblyRefOS{ 0x25, { impl::columns::fixed4, impl::columns::fixed4, impl::columns::fixed4, impl::columns::index(0x23) } };
+        table_builder File{ 0x26, { impl::columns::fixed4, impl::columns::string, impl::columns::blob } };
+        table_builder ExportedType{ 0x27, { impl::columns::fixed4, impl::columns::fixed4, impl::columns::string, impl::columns::string, impl::columns::coded_index(impl::columns::Implementation) } };
+        table_builder ManifestResource{ 0x28, { impl::columns::fixed4, impl::columns::fixed4, impl::columns::string, impl::columns::coded_index(impl::columns::Implementation) } };
+        table_builder NestedClass{ 0x29, { impl::columns::index(0x02), impl::columns::index(0x02) } };
+        table_builder GenericParam{ 0x2a, { impl::columns::fixed2, impl::columns::fixed2, impl::columns::coded_index(impl::columns::TypeOrMethodDef), impl::columns::string } };
+        table_builder MethodSpec{ 0x2b, { impl::columns::coded_index(impl::columns::MethodDefOrRef), impl::columns::blob } };
+
+        // Sorts the tables that must be sorted and writes the metadata directly into the image's metadata section
+        void save(pe_writer& writer)
+        {
+            sort();
+
+            auto const tables = table_layout();
+            uint32_t const version_length = impl::round_up(static_cast<uint32_t>(m_version.size() + 1));
+
+            struct stream
+            {
+                std::string_view name;
+                uint32_t size;
+            };
+
+            std::array<stream, 4> const streams
+            { {
+                { "#~", tables.size },
+                { "#Strings", impl::round_up(m_strings.size()) },
+                { "#GUID", m_guids.size() },
+                { "#Blob", impl::round_up(m_blobs.size()) },
+            } };
+
+            uint32_t header_size = 20 + version_length;
+
+            for (auto&& s : streams)
+            {
+                header_size += 8 + impl::round_up(static_cast<uint32_t>(s.name.size() + 1));
+            }
+
+            uint32_t size = header_size;
+
+            for (auto&& s : streams)
+            {
+                size += s.size;
+            }
+
+            auto const first = writer.add_metadata(size);
+            auto data = first;
+
+            impl::write_u32(data, 0x424a5342); // BSJB
+            impl::write_u16(data, 1); // MajorVersion
+            impl::write_u16(data, 1); // MinorVersion
+            impl::write_u32(data, 0); // Reserved
+            impl::write_u32(data, version_length);
+            std::memcpy(data, m_version.data(), m_version.size());
+            data += version_length;
+            impl::write_u16(data, 0); // Flags
+            impl::write_u16(data, static_cast<uint16_t>(streams.size()));
+
+            uint32_t offset = header_size;
+
+            for (auto&& s : streams)
+            {
+                impl::write_u32(data, offset);
+                impl::write_u32(data, s.size);
+                std::memcpy(data, s.name.data(), s.name.size());
+                data += impl::round_up(static_cast<uint32_t>(s.name.size() + 1));
+                offset += s.size;
+            }
+
+            XLANG_ASSERT(data == first + header_size);
+            write_tables(data, tables);
+            data += tables.size;
+            m_strings.write(data);
+            data += streams[1].size;
+            m_guids.write(data);
+            data += streams[2].size;
+            m_blobs.write(data);
+            XLANG_ASSERT(data + streams[3].size == first + size);
+        }
+
+    private:
+        template <typename F>
+        void for_each_table(F&& callback)
+        {
+            for (auto table : { &Module, &TypeRef, &TypeDef, &Field, &MethodDef, &Param, &InterfaceImpl, &MemberRef, &Constant,
+                &CustomAttribute, &FieldMarshal, &DeclSecurity, &ClassLayout, &FieldLayout, &StandAloneSig, &EventMap, &Event,
+                &PropertyMap, &Property, &MethodSemantics, &MethodImpl, &ModuleRef, &TypeSpec, &ImplMap, &FieldRVA, &Assembly,
+                &AssemblyProcessor, &AssemblyOS, &AssemblyRef, &AssemblyRefProcessor, &AssemblyRefOS, &File, &ExportedType,
+                &ManifestResource, &NestedClass, &GenericParam, &MethodSpec, &GenericParamConstraint })
+            {
+                callback(*table);
+            }
+        }
+
+        table_builder const* find_table(uint8_t const id) noexcept
+        {
+            table_builder const* result{};
+
+            for_each_table([&](table_builder const& table)
+            {
+                if (table.id() == id)
+                {
+                    result = &table;
+                }
+            });
+
+            return result;
+        }
+
+        // Sorts the table's rows by the key and returns the new row number of each old row, or nothing if the rows are
+        // already in order. The sort is stable so that rows with the same key (e.g. the attributes of a type) stay in the
+        // order in which they were added
+        template <typename Key>
+        static std::vector<uint32_t> sort_table(table_builder& table, Key&& key)
+        {
+            auto const rows = table.size();
+            std::vector<uint64_t> keys(rows);
+
+            for (uint32_t row{}; row < rows; ++row)
+            {
+                keys[row] = key(table.m_values.data() + static_cast<std::size_t>(row) * table.m_columns.size());
+            }
+
+            if (std::is_sorted(keys.begin(), keys.end()))
+            {
+                return {};
+            }
+
+            std::vector<uint32_t> order(rows);
+            std::iota(order.begin(), order.end(), 0);
+            impl::parallel_stable_sort(order, keys);
+
+            auto const columns = table.m_columns.size();
+            std::vector<uint32_t> values(table.m_values.size());
+            std::vector<uint32_t> remap(rows + 1);
+
+            for (uint32_t row{}; row < rows; ++row)
+            {
+                auto const source = table.m_values.begin() + static_cast<std::size_t>(order[row]) * columns;
+                std::copy(source, source + columns, values.begin() + static_cast<std::size_t>(row) * columns);
+                remap[order[row] + 1] = row + 1;
+            }
+
+            table.m_values = std::move(values);
+            return remap;
+        }
+
+        void sort()
+        {
+            auto by_column = [](uint32_t const column)
+            {
+                return [column](uint32_t const* row) { return uint64_t{ row[column] }; };
+            };
+
+            // InterfaceImpl, GenericParam and GenericParamConstraint rows may be the parents of custom attributes, so they
+            // are sorted first and the references to them updated before the tables that refer to them are sorted in turn.
+            // GenericParamConstraint rows are owned by GenericParam rows, so they are sorted once their owners are.
+            // DeclSecurity rows are sorted too, but like the reader this doesn't support attributes on them
+            std::vector<uint32_t> interface_impls;
+            std::vector<uint32_t> generic_params;
+            std::vector<uint32_t> generic_param_constraints;
+
+            {
+                task_group group;
+                group.add([&] { interface_impls = sort_table(InterfaceImpl, by_column(0)); });
+                group.add([&]
+                {
+                    generic_params = sort_table(GenericParam, [](uint32_t const* row) { return (uint64_t{ row[2] } << 32) | row[0]; });
+
+                    if (!generic_params.empty())
+                    {
+                        for (uint32_t row = 1; row <= GenericParamConstraint.size(); ++row)
+                        {
+                            auto& owner = GenericParamConstraint.value(row, 0);
+                            owner = generic_params[owner];
+                        }
+                    }
+
+                    generic_param_constraints = sort_table(GenericParamConstraint, by_column(0));
+                });
+                group.get();
+            }
+
+            auto const tag_bits = reader::coded_index_bits_v<reader::HasCustomAttribute>;
+            auto const tag_mask = (1u << tag_bits) - 1;
+
+            if (!interface_impls.empty() || !generic_params.empty() || !generic_param_constraints.empty() || DeclSecurity.size())
+            {
+                for (uint32_t row = 1; row <= CustomAttribute.size(); ++row)
+                {
+                    auto& parent = CustomAttribute.value(row, 0);
+                    auto const tag = static_cast<reader::HasCustomAttribute>(parent & tag_mask);
+
+                    if (tag == reader::HasCustomAttribute::InterfaceImpl && !interface_impls.empty())
+                    {
+                        parent = encode_index(tag, interface_impls[parent >> tag_bits]);
+                    }
+                    else if (tag == reader::HasCustomAttribute::GenericParam && !generic_params.empty())
+                    {
+                        parent = encode_index(tag, generic_params[parent >> tag_bits]);
+                    }
+                    else if (tag == reader::HasCustomAttribute::GenericParamConstraint && !generic_param_constraints.empty())
+                    {
+                        parent = encode_index(tag, generic_param_constraints[parent >> tag_bits]);
+                    }
+                    else if (tag == reader::HasCustomAttribute::Permission)
+                    {
+                        throw_invalid("Custom attributes on DeclSecurity rows are not supported");
+                    }
+                }
+            }
+
+            task_group group;
+            group.add([&] { sort_table(CustomAttribute, by_column(0)); });
+            group.add([&] { sort_table(Constant, by_column(1)); });
+            group.add([&] { sort_table(FieldMarshal, by_column(0)); });
+            group.add([&] { sort_table(DeclSecurity, by_column(1)); });
+            group.add([&] { sort_table(ClassLayout, by_column(2)); });
+            group.add([&] { sort_table(FieldLayout, by_column(1)); });
+            group.add([&] { sort_table(MethodSemantics, by_column(2)); });
+            group.add([&] { sort_table(MethodImpl, by_column(0)); });
+            group.add([&] { sort_table(ImplMap, by_column(1)); });
+            group.add([&] { sort_table(FieldRVA, by_column(1)); });
+            group.add([&] { sort_table(NestedClass, by_column(0)); });
+            group.get();
+        }
+
+        struct layout
+        {
+            uint32_t size{};
+            std::array<std::vector<uint8_t>, 64> column_sizes;
+        };
+
+        uint8_t column_size(impl::metadata_column const& column) noexcept
+        {
+            auto const large = [](uint32_t const value) { return value >= (1u << 16); };
+
+            switch (column.type)
+            {
+            case impl::column_type::fixed2: return 2;
+            case impl::column_type::fixed4: return 4;
+            case impl::column_type::string: return large(m_strings.size()) ? 4 : 2;
+            case impl::column_type::guid: return large(m_guids.count()) ? 4 : 2;
+            case impl::column_type::blob: return large(m_blobs.size()) ? 4 : 2;
+            case impl::column_type::index: return large(find_table(column.table)->size()) ? 4 : 2;
+            case impl::column_type::coded_index:
+            {
+                auto const bits = xlang::impl::bits_needed(column.table_count);
+
+                for (uint8_t i{}; i < column.table_count; ++i)
+                {
+                    if (column.tables[i] != 0xff && find_table(column.tables[i])->size() >= (1u << (16 - bits)))
+                    {
+                        return 4;
+                    }
+                }
+
+                return 2;
+            }
+            }
+
+            XLANG_ASSERT(false);
+            return 4;
+        }
+
+        layout table_layout()
+        {
+            layout result;
+            uint32_t size = 24;
+
+            for_each_table([&](table_builder const& table)
+            {
+                if (!table.size())
+                {
+                    return;
+                }
+
+                auto& sizes = result.column_sizes[table.id()];
+
+                for (auto&& column : table.columns())
+                {
+                    sizes.push_back(column_size(column));
+                }
+
+                size += 4 + table.size() * std::accumulate(sizes.begin(), sizes.end(), 0u);
+            });
+
+            result.size = impl::round_up(size);
+            return result;
+        }
+
+        void write_tables(uint8_t* data, layout const& tables)
+        {
+            auto const last = data + tables.size;
+            uint64_t valid{};
+
+            for_each_table([&](table_builder const& table)
+            {
+                if (table.size())
+                {
+                    valid |= 1ull << table.id();
+                }
+            });
+
+            uint8_t heap_sizes{};
+            heap_sizes |= m_strings.size() >= (1u << 16) ? 0x1 : 0;
+            heap_sizes |= m_guids.count() >= (1u << 16) ? 0x2 : 0;
+            heap_sizes |= m_blobs.size() >= (1u << 16) ? 0x4 : 0;
+
+            // Every table that the format requires to be sorted is sorted
+            uint64_t const sorted{ (1ull << 0x09) | (1ull << 0x0b) | (1ull << 0x0c) | (1ull << 0x0d) | (1ull << 0x0e) | (1ull << 0x0f) |
+                (1ull << 0x10) | (1ull << 0x18) | (1ull << 0x19) | (1ull << 0x1c) | (1ull << 0x1d) | (1ull << 0x29) | (1ull << 0x2a) | (1ull << 0x2c) };
+
+            impl::write_u32(data, 0); // Reserved
+            *data++ = 2; // MajorVersion
+            *data++ = 0; // MinorVersion
+            *data++ = heap_sizes;
+            *data++ = 1; // Reserved
+            impl::write_u32(data, static_cast<uint32_t>(valid));
+            impl::write_u32(data, static_cast<uint32_t>(valid >> 32));
+            impl::write_u32(data, static_cast<uint32_t>(sorted));
+            impl::write_u32(data, static_cast<uint32_t>(sorted >> 32));
+
+            // The row counts and the rows are both in table number order
+            for (uint8_t id{}; id < 64; ++id)
+            {
+                if (valid & (1ull << id))
+                {
+                    impl::write_u32(data, find_table(id)->size());
+                }
+            }
+
+            for (uint8_t id{}; id < 64; ++id)
+            {
+                if (!(valid & (1ull << id)))
+                {
+                    continue;
+                }
+
+                auto const& sizes = tables.column_sizes[id];
+                auto const& values = find_table(id)->m_values;
+
+                for (std::size_t i{}; i < values.size(); ++i)
+                {
+                    if (sizes[i % sizes.size()] == 2)
+                    {
+                        impl::write_u16(data, values[i]);
+                    }
+                    else
+                    {
+                        impl::write_u32(data, values[i]);
+                    }
+                }
+            }
+
+            XLANG_ASSERT(data <= last);
+            std::memset(data, 0, last - data);
+        }
+
+        std::string m_version;
+        string_heap m_strings;
+        blob_heap m_blobs;
+        guid_heap m_guids;
+    };
+}
@@ -4,6 +4,7 @@
 #include "../meta_reader/pe.h"
 #include <algorithm>
 #include <fstream>
+#include <optional>
 #include <stdint.h>
 #include <string>
 #include <string_view>
@@ -20,75 +21,59 @@ namespace xlang::meta::writer
         }
 
         void add_metadata(std::vector<uint8_t> const& metadata)
+        {
+            std::copy(metadata.begin(), metadata.end(), add_metadata(metadata.size()));
+        }
+
+        // Reserves room for the metadata in the image and returns where it is to be written
+        uint8_t* add_metadata(std::size_t const size)
         {
             auto& s = get_section(".text");
-            s.resize(sizeof(impl::image_cor20_header) + metadata.size());
+            s.resize(sizeof(impl::image_cor20_header) + size);
             auto md_dest = s.as<uint8_t>(sizeof(impl::image_cor20_header));
-            std::copy(metadata.begin(), metadata.end(), md_dest);
             auto cli_header = s.as<impl::image_cor20_header>(0);
             cli_header->cb = sizeof(impl::image_cor20_header);
             cli_header->MajorRuntimeVersion = 2;
             cli_header->MinorRuntimeVersion = 5;
-            cli_header->MetaData.Size = static_cast<uint32_t>(metadata.size());
+            cli_header->MetaData.Size = static_cast<uint32_t>(size);
             s.defer_rva(&(cli_header->MetaData.VirtualAddress), &s, md_dest);
             cli_header->Flags = 0x1; // COMIMAGE_FLAGS_ILONLY
 
             auto nt_header = get_nt_header();
             nt_header->OptionalHeader.DataDirectory[com_directory].Size = sizeof(impl::image_cor20_header);
             m_header.defer_rva(&(nt_header->OptionalHeader.DataDirectory[com_directory].VirtualAddress), &s, cli_header);
+            return md_dest;
         }
 
+        // The image is written to the file as it is laid out, without first being copied into memory
         void save_to_file(std::filesystem::path const& path)
         {
-            std::basic_ofstream<uint8_t> output_file{ path, std::ios::binary };
-            auto const output = save_to_memory();
-            output_file.write(output.data(), output.size());
+            std::ofstream output_file{ path, std::ios::binary };
+
+            write_image([&](uint8_t const* data, std::size_t size)
+            {
+                output_file.write(reinterpret_cast<char const*>(data), size);
+            });
+
+            if (!output_file)
+            {
+                throw_invalid("Could not write '", path.string(), "'");
+            }
         }
 
         std::vector<uint8_t> save_to_memory()
         {
-            resolve();
-            update_header();
-            uint32_t raw_size = m_sections.back().physical_offset() + static_cast<uint32_t>(m_sections.back().size());
             std::vector<uint8_t> output;
 
-            // Write the top headers
-            output.reserve(raw_size);
-            {
-                auto headers_start = m_header.as<uint8_t>(0);
-                auto headers_end = headers_start + m_header.size();
-                output.insert(output.end(), headers_start, headers_end);
-            }
-            
-            // Write each section header
-            for (auto const& s : m_sections)
+            write_image([&](uint8_t const* data, std::size_t size)
             {
-                impl::image_section_header header{};
-                XLANG_ASSERT(s.name().size() <= 8);
-                std::copy(s.name().begin(), s.name().end(), header.Name);
-                header.Misc.VirtualSize = static_cast<uint32_t>(s.size());
-                header.VirtualAddress = s.virtual_offset();
-                header.SizeOfRawData = round_up(header.Misc.VirtualSize, file_alignment);
-                header.PointerToRawData = s.physical_offset();
-                header.Characteristics = 0x40000020; // IMAGE_SCN_MEM_READ | IMAGE_SCN_CNT_CODE
-                
-                auto begin = reinterpret_cast<uint8_t*>(&header);
-                auto end = begin + sizeof(impl::image_section_header);
-                output.insert(output.end(), begin, end);
-            }
+                if (output.empty())
+                {
+                    output.reserve(m_sections.back().physical_offset() + m_sections.back().size());
+                }
 
-            // Write the sections
-            for (auto const& s : m_sections)
-            {
-                // Alignment padding
-                XLANG_ASSERT(output.size() <= s.physical_offset());
-                XLANG_ASSERT((s.physical_offset() & (file_alignment - 1)) == 0);
-                output.resize(s.physical_offset());
-
-                auto begin = s.as<uint8_t>(0);
-                auto end = begin + s.size();
-                output.insert(output.end(), begin, end);
-            }
+                output.insert(output.end(), data, data + size);
+            });
 
             return output;
         }
@@ -233,6 +218,12 @@ namespace xlang::meta::writer
             return m_header;
         }
 
+        // Images are stamped with the current time unless a fixed stamp is provided, which makes the output reproducible
+        void time_date_stamp(uint32_t value) noexcept
+        {
+            m_time_date_stamp = value;
+        }
+
     private:
         static constexpr uint32_t dos_header_offset{ 0 };
         static constexpr uint32_t nt_header_offset{ dos_header_offset + sizeof(impl::image_dos_header) };
@@ -303,7 +294,7 @@ namespace xlang::meta::writer
                 auto& file_header = nt_header->FileHeader;
                 file_header.Machine = 0x014c; // IMAGE_FILE_MACHINE_I386
                 file_header.NumberOfSections = static_cast<uint16_t>(m_sections.size());
-                file_header.TimeDateStamp = static_cast<uint32_t>(time(nullptr));
+                file_header.TimeDateStamp = m_time_date_stamp ? *m_time_date_stamp : static_cast<uint32_t>(time(nullptr));
                 file_header.SizeOfOptionalHeader = static_cast<uint16_t>(sizeof(impl::image_optional_header32));
                 file_header.Characteristics = 0x2102; // IMAGE_FILE_DLL | IMAGE_FILE_32BIT_MACHINE | IMAGE_FILE_EXECUTABLE_IMAGE
 
@@ -327,7 +318,49 @@ namespace xlang::meta::writer
             }
         }
 
+        template <typename Write>
+        void write_image(Write&& write)
+        {
+            resolve();
+            update_header();
+            uint32_t written{};
+
+            // Write the top headers
+            write(m_header.as<uint8_t>(0), m_header.size());
+            written += static_cast<uint32_t>(m_header.size());
+
+            // Write each section header
+            for (auto const& s : m_sections)
+            {
+                impl::image_section_header header{};
+                XLANG_ASSERT(s.name().size() <= 8);
+                std::copy(s.name().begin(), s.name().end(), header.Name);
+                header.Misc.VirtualSize = static_cast<uint32_t>(s.size());
+                header.VirtualAddress = s.virtual_offset();
+                header.SizeOfRawData = round_up(header.Misc.VirtualSize, file_alignment);
+                header.PointerToRawData = s.physical_offset();
+                header.Characteristics = 0x40000020; // IMAGE_SCN_MEM_READ | IMAGE_SCN_CNT_CODE
+
+                write(reinterpret_cast<uint8_t const*>(&header), sizeof(impl::image_section_header));
+                written += sizeof(impl::image_section_header);
+            }
+
+            // Write the sections
+            for (auto const& s : m_sections)
+            {
+                // Alignment padding
+                XLANG_ASSERT(written <= s.physical_offset());
+                XLANG_ASSERT((s.physical_offset() & (file_alignment - 1)) == 0);
+                static constexpr uint8_t padding[file_alignment]{};
+                write(padding, s.physical_offset() - written);
+
+                write(s.as<uint8_t>(0), s.size());
+                written = s.physical_offset() + static_cast<uint32_t>(s.size());
+            }
+        }
+
         section m_header{ "" };
         std::vector<section> m_sections;
+        std::optional<uint32_t> m_time_date_stamp;
     };
 }
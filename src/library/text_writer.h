@@ -163,6 +163,11 @@ namespace xlang::text
             flush_to_file(filename.string());
         }
 
+        void reserve(std::size_t size)
+        {
+            m_first.reserve(size);
+        }
+
         std::string flush_to_string()
         {
             std::string result;
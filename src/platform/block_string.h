@@ -0,0 +1,203 @@
+#pragma once
+
+#include "string_base.h"
+#include "atomic_ref_count.h"
+#include "cache_string.h"
+#include "string_statistics.h"
+
+namespace xlang::impl
+{
+    struct string_block;
+
+    // block_string is a shared, immutable string whose header and character data live in a
+    // string_block together with the other strings created by the same batch call. Each
+    // block_string behaves exactly like a heap_string to callers; duplicating or releasing one
+    // adjusts the reference count of the block, which is freed when its last string is released.
+    struct block_string : string_base
+    {
+        void addref() noexcept;
+        void release() noexcept;
+
+        string_block* get_block() const noexcept;
+
+        // Read the ptr, but don't create it. May be null.
+        cache_string* get_alternate() noexcept;
+
+    private:
+        friend struct string_block;
+
+        template <typename char_type>
+        block_string(char_type const* storage, uint32_t length, string_block* block) noexcept;
+
+        block_string() = delete;
+        ~block_string() = delete;
+        block_string(block_string const&) = delete;
+        block_string& operator=(block_string const&) = delete;
+
+        string_block* block_{};
+    };
+
+    // A string_block packs a header, an array of block_string headers, and the null-terminated
+    // character data for every string into a single allocation:
+    //
+    //      [string_block][block_string 0]...[block_string n-1][chars 0\0]...[chars n-1\0]
+    //
+    // Empty strings are represented by a null handle, so they take no space in the block. The header
+    // is padded to the alignment of block_string, since the first of them follows it directly.
+    struct alignas(alignof(block_string)) string_block
+    {
+        template <typename char_type>
+        static void create(
+            uint32_t count,
+            uint32_t const* lengths,
+            char_type const* source_strings,
+            xlang_string* strings);
+
+        void addref() noexcept;
+        void release(int32_t count = 1) noexcept;
+
+    private:
+        explicit string_block(uint32_t string_count, uint32_t size) noexcept
+            : count{ static_cast<int32_t>(string_count) }
+            , string_count_{ string_count }
+            , size_{ size }
+        {}
+
+        string_block() = delete;
+        ~string_block() = delete;
+        string_block(string_block const&) = delete;
+        string_block& operator=(string_block const&) = delete;
+
+        block_string* get_strings() noexcept;
+
+        atomic_ref_count count;
+        uint32_t string_count_{};
+        uint32_t size_{};
+    };
+
+    static_assert(sizeof(string_block) % alignof(block_string) == 0, "block_string headers must be aligned");
+
+    template <typename char_type>
+    inline block_string::block_string(char_type const* storage, uint32_t length, string_block* block) noexcept
+        : string_base(storage, length, string_flags::is_block)
+        , block_{ block }
+    {
+    }
+
+    inline void block_string::addref() noexcept
+    {
+        block_->addref();
+    }
+
+    inline void block_string::release() noexcept
+    {
+        block_->release();
+    }
+
+    inline string_block* block_string::get_block() const noexcept
+    {
+        return block_;
+    }
+
+    inline cache_string* block_string::get_alternate() noexcept
+    {
+        return this->get_alternate_ptr<cache_string>();
+    }
+
+    inline block_string* string_block::get_strings() noexcept
+    {
+        return reinterpret_cast<block_string*>(this + 1);
+    }
+
+    inline void string_block::addref() noexcept
+    {
+        ++count;
+    }
+
+    inline void string_block::release(int32_t release_count) noexcept
+    {
+        if ((count -= release_count) == 0)
+        {
+            block_string* strings = get_strings();
+            for (uint32_t i = 0; i < string_count_; ++i)
+            {
+                auto alternate = strings[i].get_alternate();
+                if (alternate)
+                {
+                    alternate->release();
+                }
+            }
+            record_strings_destroyed(strings[0].is_utf8(), string_count_, size_);
+            xlang_mem_free(this);
+        }
+    }
+
+    template <typename char_type>
+    inline void string_block::create(
+        uint32_t count,
+        uint32_t const* lengths,
+        char_type const* source_strings,
+        xlang_string* strings)
+    {
+        static_assert(std::disjunction_v<std::is_same<char_type, xlang_char8>, std::is_same<char_type, char16_t>>, "char_t must be either xlang_char8 or char16_t");
+        static_assert(alignof(block_string) % alignof(char_type) == 0, "Character data must be aligned");
+
+        // Size the block in 64 bits, so that overflow is detected before narrowing to size_t.
+        uint64_t string_count{};
+        uint64_t char_count{};
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (lengths[i] != 0)
+            {
+                ++string_count;
+                char_count += static_cast<uint64_t>(lengths[i]) + 1;
+            }
+        }
+
+        if (string_count == 0)
+        {
+            std::fill(strings, strings + count, nullptr);
+            return;
+        }
+
+        if (!source_strings)
+        {
+            throw_result(xlang_result::pointer);
+        }
+
+        uint64_t const block_size = sizeof(string_block) + string_count * sizeof(block_string) + char_count * sizeof(char_type);
+        if (block_size > std::numeric_limits<uint32_t>::max())
+        {
+            throw_result(xlang_result::invalid_arg, "Insufficient buffer size");
+        }
+
+        string_block* block = reinterpret_cast<string_block*>(xlang_mem_alloc(static_cast<size_t>(block_size)));
+        if (!block)
+        {
+            throw std::bad_alloc{};
+        }
+        new (block) string_block(static_cast<uint32_t>(string_count), static_cast<uint32_t>(block_size));
+        record_strings_created(string_statistic::batch_strings_created, std::is_same_v<char_type, xlang_char8>, string_count, block_size);
+
+        block_string* next_string = block->get_strings();
+        char_type* next_char = reinterpret_cast<char_type*>(next_string + string_count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t const length = lengths[i];
+            if (length == 0)
+            {
+                strings[i] = nullptr;
+                continue;
+            }
+
+            next_char = std::copy(source_strings, source_strings + length, next_char);
+            *next_char = 0;
+            new (next_string) block_string(next_char - length, length, block);
+            strings[i] = reinterpret_cast<xlang_string>(static_cast<string_base*>(next_string));
+
+            source_strings += length;
+            ++next_char;
+            ++next_string;
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "string_allocate.h"
 #include "string_convert.h"
 #include "string_traits.h"
+#include "string_statistics.h"
 
 namespace xlang::impl
 {
@@ -31,13 +32,15 @@ namespace xlang::impl
         uint32_t get_length() const noexcept;
 
     private:
-        explicit cache_string(uint32_t length)
+        explicit cache_string(uint32_t length, uint32_t size)
             : length_(length)
+            , size_(size)
         {}
 
         cache_string() = delete;
         atomic_ref_count count;
         uint32_t length_{};
+        uint32_t size_{};
     };
 
     inline void cache_string::addref() noexcept
@@ -49,6 +52,7 @@ namespace xlang::impl
     {
         if (--count == 0)
         {
+            record_bytes_released(size_);
             xlang_mem_free(this);
         }
     }
@@ -72,7 +76,8 @@ namespace xlang::impl
         convert_string({ source_string, length }, alternate_buffer, alternate_length);
         alternate_buffer[alternate_length] = 0;
 
-        new (new_string.get()) cache_string(alternate_length);
+        new (new_string.get()) cache_string(alternate_length, packed_size);
+        record_cache_created(std::is_same_v<alternate_char_type, xlang_char8>, packed_size);
         return new_string;
     }
 
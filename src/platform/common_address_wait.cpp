@@ -0,0 +1,83 @@
+#include "pal_internal.h"
+#include "platform_threadpool.h"
+#include <atomic>
+
+#ifdef _WIN32
+#error "This file is for targeting platforms other than Windows"
+#endif
+
+#if defined(__linux__)
+
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wait_on_address(
+    void const* address,
+    uint32_t compare_value
+) noexcept
+{
+    xlang::impl::blocking_region const blocking;
+    ::syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, compare_value, nullptr, nullptr, 0);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wake_by_address_all(void const* address) noexcept
+{
+    ::syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace xlang::impl
+{
+    namespace
+    {
+        // Without futexes, waiters park on one of a fixed set of condition variables, chosen by
+        // hashing the address. Unrelated addresses may share a bucket, which only costs a spurious wake.
+        struct alignas(64) address_wait_bucket
+        {
+            std::mutex lock;
+            std::condition_variable condition;
+        };
+
+        constexpr size_t address_wait_bucket_count = 64;
+        address_wait_bucket address_wait_buckets[address_wait_bucket_count];
+
+        address_wait_bucket& get_address_wait_bucket(void const* address) noexcept
+        {
+            return address_wait_buckets[std::hash<void const*>{}(address) % address_wait_bucket_count];
+        }
+    }
+}
+
+using namespace xlang::impl;
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wait_on_address(
+    void const* address,
+    uint32_t compare_value
+) noexcept
+{
+    blocking_region const blocking;
+    auto& bucket = get_address_wait_bucket(address);
+    std::unique_lock lock(bucket.lock);
+    if (static_cast<std::atomic<uint32_t> const*>(address)->load(std::memory_order_acquire) == compare_value)
+    {
+        bucket.condition.wait(lock);
+    }
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wake_by_address_all(void const* address) noexcept
+{
+    auto& bucket = get_address_wait_bucket(address);
+    {
+        std::lock_guard const guard(bucket.lock);
+    }
+    bucket.condition.notify_all();
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include "pal_internal.h"
+#include "platform_execution_trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#ifdef _WIN32
+#error "This file is for targeting platforms other than Windows"
+#endif
+
+namespace xlang::impl
+{
+    uint32_t capture_stack_trace(void** frames, uint32_t max_frames, uint32_t skip_frames) noexcept
+    {
+        void* buffer[max_execution_trace_frames + 8];
+        uint32_t const requested = std::min<uint32_t>(max_frames + skip_frames + 1, static_cast<uint32_t>(std::size(buffer)));
+        int const captured = ::backtrace(buffer, static_cast<int>(requested));
+
+        uint32_t const first = skip_frames + 1;
+        if (captured <= 0 || static_cast<uint32_t>(captured) <= first)
+        {
+            return 0;
+        }
+
+        uint32_t const count = std::min<uint32_t>(static_cast<uint32_t>(captured) - first, max_frames);
+        std::copy(buffer + first, buffer + first + count, frames);
+        return count;
+    }
+
+    std::string describe_stack_frame(void const* address)
+    {
+        char text[32];
+        Dl_info info{};
+        if (!::dladdr(address, &info) || !info.dli_fname)
+        {
+            std::snprintf(text, std::size(text), "%p", address);
+            return text;
+        }
+
+        std::string result{ info.dli_fname };
+        auto const slash = result.rfind('/');
+        if (slash != result.npos)
+        {
+            result.erase(0, slash + 1);
+        }
+
+        if (info.dli_sname && info.dli_saddr)
+        {
+            std::snprintf(text, std::size(text), "+0x%zx", static_cast<size_t>(static_cast<char const*>(address) - static_cast<char const*>(info.dli_saddr)));
+            result += '!';
+            result += info.dli_sname;
+        }
+        else
+        {
+            std::snprintf(text, std::size(text), "+0x%zx", static_cast<size_t>(static_cast<char const*>(address) - static_cast<char const*>(info.dli_fbase)));
+        }
+        result += text;
+        return result;
+    }
+}
@@ -0,0 +1,891 @@
+#include "pal_internal.h"
+#include "pal_error.h"
+#include "atomic_ref_count.h"
+#include "platform_threadpool.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#error "This file is for targeting platforms other than Windows"
+#endif
+
+namespace xlang::impl
+{
+    namespace
+    {
+        struct work_item
+        {
+            xlang_threadpool_callback callback;
+            void* context;
+        };
+
+        struct alignas(64) worker_queue
+        {
+            std::mutex lock;
+            std::deque<work_item> items;
+
+            // Only written under the lock, so that counting costs no more than a plain increment.
+            std::atomic<uint64_t> dequeued{};
+        };
+
+        // Each worker owns a queue. Callbacks submitted from a worker are pushed to and popped from the
+        // back of its own queue, so a coroutine's continuation tends to run next on the same thread.
+        // Idle workers steal from the front of other queues, and submissions from threads outside the
+        // pool are spread round-robin across all of the queues.
+        //
+        // A callback may block on work queued behind it, for example by calling get() on an async
+        // operation that completes on the pool. Once every worker is blocked like this no queued
+        // callback makes progress, so a monitor thread watches the pool while it has a backlog and adds
+        // compensating workers. Compensating workers have no queue of their own and exit once there is
+        // nothing left to steal.
+        //
+        // Pool threads that block in xlang_wait_on_address are known not to be using a processor, so the
+        // monitor replaces each of them as soon as it blocks. Other blocking can only be inferred from a
+        // backlog that makes no progress, which a few long running callbacks also look like. For that the
+        // monitor waits a while before adding a worker, waits twice as long before adding the next, and
+        // adds no more than one per queue, so that a backlog of busy callbacks cannot pile up threads.
+        struct executor
+        {
+            static executor& instance();
+
+            void submit(work_item item);
+            void enter_blocking_region() noexcept;
+            void leave_blocking_region() noexcept;
+
+        private:
+            static constexpr std::chrono::milliseconds starvation_delay{ 250 };
+            static constexpr std::chrono::milliseconds max_starvation_delay{ 4000 };
+            static constexpr uint32_t max_compensating_workers{ 512 };
+
+            explicit executor(uint32_t worker_count);
+            void run(uint32_t index) noexcept;
+            bool try_pop(uint32_t index, work_item& item) noexcept;
+            void watch() noexcept;
+            void monitor() noexcept;
+            bool add_compensating_worker() noexcept;
+            uint64_t dequeued() const noexcept;
+
+            uint32_t const m_worker_count;
+            std::unique_ptr<worker_queue[]> m_queues;
+            std::atomic<uint32_t> m_next_queue{};
+
+            std::atomic<uint32_t> m_compensating_workers{};
+            std::atomic<uint32_t> m_blocked_workers{};
+            std::atomic<bool> m_watching{ false };
+            std::mutex m_monitor_lock;
+            std::condition_variable m_monitor;
+
+            // Workers only sleep once m_pending is zero, and submitters only take m_idle_lock when
+            // a worker is (or is about to be) sleeping, so the common path never touches it.
+            std::atomic<int64_t> m_pending{};
+            std::atomic<uint32_t> m_sleeping{};
+            std::mutex m_idle_lock;
+            std::condition_variable m_idle;
+        };
+
+        inline constexpr uint32_t not_a_worker = ~0u;
+        thread_local uint32_t current_worker_index{ not_a_worker };
+
+        // Set on workers and compensating workers alike, since the latter have no index.
+        thread_local bool current_thread_is_pooled{ false };
+
+        executor& executor::instance()
+        {
+            // The pool lives until the process exits. Joining workers from a static destructor would
+            // race with callbacks that are still queued during shutdown.
+            static executor* const pool = new executor(std::max(2u, std::thread::hardware_concurrency()));
+            return *pool;
+        }
+
+        executor::executor(uint32_t worker_count)
+            : m_worker_count{ worker_count }
+            , m_queues{ new worker_queue[worker_count] }
+        {
+            for (uint32_t i = 0; i < worker_count; ++i)
+            {
+                std::thread([this, i] { run(i); }).detach();
+            }
+
+            std::thread([this] { monitor(); }).detach();
+        }
+
+        void executor::submit(work_item item)
+        {
+            uint32_t index = current_worker_index;
+            if (index == not_a_worker)
+            {
+                index = m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_worker_count;
+            }
+
+            {
+                worker_queue& queue = m_queues[index];
+                std::lock_guard const guard(queue.lock);
+                queue.items.push_back(item);
+            }
+
+            m_pending.fetch_add(1);
+            if (m_sleeping.load() != 0)
+            {
+                {
+                    std::lock_guard const guard(m_idle_lock);
+                }
+                m_idle.notify_one();
+            }
+            else
+            {
+                watch();
+            }
+        }
+
+        void executor::watch() noexcept
+        {
+            // Only the first caller after the monitor went idle takes its lock.
+            if (!m_watching.load(std::memory_order_relaxed) && !m_watching.exchange(true))
+            {
+                {
+                    std::lock_guard const guard(m_monitor_lock);
+                }
+                m_monitor.notify_one();
+            }
+        }
+
+        void executor::enter_blocking_region() noexcept
+        {
+            m_blocked_workers.fetch_add(1);
+            if (m_pending.load() != 0)
+            {
+                m_watching.store(true);
+                {
+                    std::lock_guard const guard(m_monitor_lock);
+                }
+                m_monitor.notify_one();
+            }
+        }
+
+        void executor::leave_blocking_region() noexcept
+        {
+            m_blocked_workers.fetch_sub(1);
+        }
+
+        void executor::monitor() noexcept
+        {
+            std::unique_lock lock(m_monitor_lock);
+            auto delay = starvation_delay;
+
+            while (true)
+            {
+                m_monitor.wait(lock, [this] { return m_watching.load(); });
+                uint64_t const before = dequeued();
+
+                // Blocked workers outnumbering the compensating ones leave fewer threads running than there are queues.
+                bool const blocked = m_monitor.wait_for(lock, delay, [this]
+                {
+                    return m_blocked_workers.load() > m_compensating_workers.load();
+                });
+
+                if (m_pending.load() == 0)
+                {
+                    // A submission may have found the monitor still watching before it stopped.
+                    delay = starvation_delay;
+                    m_watching.store(false);
+                    if (m_pending.load() == 0 || m_watching.exchange(true))
+                    {
+                        continue;
+                    }
+                }
+
+                if (m_compensating_workers.load() >= max_compensating_workers)
+                {
+                    continue;
+                }
+
+                bool added = true;
+                if (blocked)
+                {
+                    added = add_compensating_worker();
+                }
+                else if (dequeued() == before && m_compensating_workers.load() < m_blocked_workers.load() + m_worker_count)
+                {
+                    added = add_compensating_worker();
+                    delay = std::min(delay * 2, max_starvation_delay);
+                }
+
+                if (!added)
+                {
+                    // Out of threads. Try again after the next interval, even if workers are still blocked.
+                    m_monitor.wait_for(lock, delay);
+                }
+            }
+        }
+
+        bool executor::add_compensating_worker() noexcept
+        {
+            ++m_compensating_workers;
+            try
+            {
+                std::thread([this] { run(not_a_worker); }).detach();
+                return true;
+            }
+            catch (...)
+            {
+                --m_compensating_workers;
+                return false;
+            }
+        }
+
+        uint64_t executor::dequeued() const noexcept
+        {
+            uint64_t total{};
+            for (uint32_t i = 0; i < m_worker_count; ++i)
+            {
+                total += m_queues[i].dequeued.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        bool executor::try_pop(uint32_t index, work_item& item) noexcept
+        {
+            auto const popped = [this](worker_queue& queue)
+            {
+                queue.dequeued.store(queue.dequeued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if (m_pending.fetch_sub(1) > 1)
+                {
+                    watch();
+                }
+                return true;
+            };
+
+            if (index != not_a_worker)
+            {
+                worker_queue& own = m_queues[index];
+                std::lock_guard const guard(own.lock);
+                if (!own.items.empty())
+                {
+                    item = own.items.back();
+                    own.items.pop_back();
+                    return popped(own);
+                }
+            }
+
+            // Compensating workers have no queue of their own and start stealing at a different queue each time.
+            uint32_t const start = index != not_a_worker ? index : m_next_queue.fetch_add(1, std::memory_order_relaxed);
+            for (uint32_t offset = index != not_a_worker ? 1 : 0; offset < m_worker_count; ++offset)
+            {
+                worker_queue& victim = m_queues[(start + offset) % m_worker_count];
+                std::lock_guard const guard(victim.lock);
+                if (!victim.items.empty())
+                {
+                    item = victim.items.front();
+                    victim.items.pop_front();
+                    return popped(victim);
+                }
+            }
+
+            return false;
+        }
+
+        void executor::run(uint32_t index) noexcept
+        {
+            current_worker_index = index;
+            current_thread_is_pooled = true;
+            work_item item{};
+
+            while (true)
+            {
+                if (try_pop(index, item))
+                {
+                    item.callback(item.context);
+                    continue;
+                }
+
+                if (index == not_a_worker)
+                {
+                    --m_compensating_workers;
+                    return;
+                }
+
+                std::unique_lock lock(m_idle_lock);
+                m_sleeping.fetch_add(1);
+                m_idle.wait(lock, [this] { return m_pending.load() > 0; });
+                m_sleeping.fetch_sub(1);
+            }
+        }
+
+        enum class reactor_object_kind : uint8_t
+        {
+            timer,
+            wait,
+        };
+
+        // Timers and waits share a header so that both can be linked into the timer wheel. The reference
+        // count holds one reference for the owner's handle and one for each dispatched callback. Fields
+        // other than the reference count and closed flag are guarded by the reactor lock.
+        struct reactor_object
+        {
+            explicit reactor_object(reactor_object_kind kind, void* context) noexcept
+                : kind{ kind }
+                , context{ context }
+            {}
+
+            void release() noexcept;
+
+            atomic_ref_count references;
+            std::atomic<bool> closed{ false };
+            reactor_object_kind const kind;
+            bool scheduled{ false };
+            void* const context;
+            reactor_object* wheel_next{};
+            reactor_object* wheel_prev{};
+            uint64_t due_tick{};
+
+            // Callbacks that could not be queued, which the reactor runs itself once it has released its lock.
+            reactor_object* deferred_next{};
+            xlang_threadpool_callback deferred_callback{};
+            uint32_t deferred_count{};
+        };
+
+        struct threadpool_timer : reactor_object
+        {
+            threadpool_timer(xlang_threadpool_callback callback, void* context) noexcept
+                : reactor_object{ reactor_object_kind::timer, context }
+                , callback{ callback }
+            {}
+
+            xlang_threadpool_callback const callback;
+        };
+
+        struct threadpool_wait : reactor_object
+        {
+            threadpool_wait(xlang_threadpool_wait_callback callback, void* context) noexcept
+                : reactor_object{ reactor_object_kind::wait, context }
+                , callback{ callback }
+            {}
+
+            xlang_threadpool_wait_callback const callback;
+            int file_descriptor{ -1 };
+            uint64_t registration{};
+            bool watching{ false };
+        };
+
+        void reactor_object::release() noexcept
+        {
+            if (--references == 0)
+            {
+                if (kind == reactor_object_kind::timer)
+                {
+                    delete static_cast<threadpool_timer*>(this);
+                }
+                else
+                {
+                    delete static_cast<threadpool_wait*>(this);
+                }
+            }
+        }
+
+        // Timers and waits are serviced by a single reactor thread, which blocks in poll() on the file
+        // descriptors being waited for until the next timer tick. Timers live in a hashed timer wheel
+        // with a one millisecond tick, so arming and cancelling are constant time regardless of how many
+        // timers are outstanding. Callbacks are dispatched to the executor and never run on the reactor.
+        struct reactor
+        {
+            static reactor& instance();
+
+            void schedule_timer(threadpool_timer* timer, int64_t due_time) noexcept;
+            void schedule_wait(threadpool_wait* wait, int file_descriptor, int64_t timeout) noexcept;
+            void cancel(reactor_object* object) noexcept;
+
+        private:
+            static constexpr uint32_t wheel_size = 512;
+            static constexpr uint64_t never = ~0ull;
+
+            reactor();
+            void run() noexcept;
+            uint64_t current_tick() const noexcept;
+            uint64_t due_tick(int64_t relative_time) const noexcept;
+            void link(reactor_object* object, uint64_t due_tick) noexcept;
+            void unlink(reactor_object* object) noexcept;
+            void unwatch(threadpool_wait* wait) noexcept;
+            void expire(uint64_t now) noexcept;
+            uint64_t next_due_tick(uint64_t now) const noexcept;
+            void wake(uint64_t due_tick) noexcept;
+            void dispatch(reactor_object* object, bool signaled = false) noexcept;
+            void run_deferred(std::unique_lock<std::mutex>& lock) noexcept;
+
+            std::chrono::steady_clock::time_point const m_start;
+            std::mutex m_lock;
+            reactor_object* m_wheel[wheel_size]{};
+            uint32_t m_scheduled_count{};
+            uint64_t m_processed_tick{};
+            uint64_t m_wake_tick{ never };
+            bool m_waits_changed{ false };
+            std::vector<threadpool_wait*> m_waits;
+            reactor_object* m_deferred{};
+            uint64_t m_next_registration{};
+            int m_wake_pipe[2]{ -1, -1 };
+        };
+
+        reactor& reactor::instance()
+        {
+            static reactor* const instance = new reactor();
+            return *instance;
+        }
+
+        reactor::reactor()
+            : m_start{ std::chrono::steady_clock::now() }
+        {
+            if (::pipe(m_wake_pipe) != 0)
+            {
+                throw_result(xlang_result::fail);
+            }
+
+            for (int fd : m_wake_pipe)
+            {
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+
+            std::thread([this] { run(); }).detach();
+        }
+
+        uint64_t reactor::current_tick() const noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count());
+        }
+
+        uint64_t reactor::due_tick(int64_t relative_time) const noexcept
+        {
+            // Round up to whole ticks, plus one since the current tick has already partly elapsed, so
+            // that a timer never expires early.
+            constexpr int64_t intervals_per_tick = 10000;
+            return current_tick() + static_cast<uint64_t>((relative_time + intervals_per_tick - 1) / intervals_per_tick) + 1;
+        }
+
+        void reactor::link(reactor_object* object, uint64_t due_tick) noexcept
+        {
+            XLANG_ASSERT(!object->scheduled);
+            reactor_object*& head = m_wheel[due_tick % wheel_size];
+            object->due_tick = due_tick;
+            object->wheel_prev = nullptr;
+            object->wheel_next = head;
+            if (head)
+            {
+                head->wheel_prev = object;
+            }
+            head = object;
+            object->scheduled = true;
+            ++m_scheduled_count;
+        }
+
+        void reactor::unlink(reactor_object* object) noexcept
+        {
+            if (!object->scheduled)
+            {
+                return;
+            }
+
+            if (object->wheel_prev)
+            {
+                object->wheel_prev->wheel_next = object->wheel_next;
+            }
+            else
+            {
+                m_wheel[object->due_tick % wheel_size] = object->wheel_next;
+            }
+
+            if (object->wheel_next)
+            {
+                object->wheel_next->wheel_prev = object->wheel_prev;
+            }
+
+            object->wheel_next = nullptr;
+            object->wheel_prev = nullptr;
+            object->scheduled = false;
+            --m_scheduled_count;
+        }
+
+        void reactor::unwatch(threadpool_wait* wait) noexcept
+        {
+            if (!wait->watching)
+            {
+                return;
+            }
+
+            auto const position = std::find(m_waits.begin(), m_waits.end(), wait);
+            XLANG_ASSERT(position != m_waits.end());
+            *position = m_waits.back();
+            m_waits.pop_back();
+            wait->watching = false;
+            m_waits_changed = true;
+        }
+
+        void reactor::wake(uint64_t due_tick) noexcept
+        {
+            // Only interrupt poll() when the reactor would otherwise sleep past the new deadline.
+            if (due_tick < m_wake_tick)
+            {
+                m_wake_tick = due_tick;
+                char const signal{};
+                (void)::write(m_wake_pipe[1], &signal, 1);
+            }
+        }
+
+        void XLANG_CALL run_timer_callback(void* context) noexcept
+        {
+            auto const timer = static_cast<threadpool_timer*>(context);
+            if (!timer->closed.load(std::memory_order_acquire))
+            {
+                timer->callback(timer->context);
+            }
+            timer->release();
+        }
+
+        template <bool signaled>
+        void XLANG_CALL run_wait_callback(void* context) noexcept
+        {
+            auto const wait = static_cast<threadpool_wait*>(context);
+            if (!wait->closed.load(std::memory_order_acquire))
+            {
+                wait->callback(wait->context, signaled);
+            }
+            wait->release();
+        }
+
+        void reactor::dispatch(reactor_object* object, bool signaled) noexcept
+        {
+            xlang_threadpool_callback callback = run_timer_callback;
+            if (object->kind == reactor_object_kind::wait)
+            {
+                callback = signaled ? run_wait_callback<true> : run_wait_callback<false>;
+            }
+
+            ++object->references;
+            try
+            {
+                executor::instance().submit({ callback, object });
+            }
+            catch (...)
+            {
+                // Out of memory queueing the callback. Rather than lose it, or run it while holding the lock
+                // that every timer and wait needs, leave it for the reactor thread to run after unlocking.
+                if (object->deferred_count++ == 0)
+                {
+                    object->deferred_callback = callback;
+                    object->deferred_next = m_deferred;
+                    m_deferred = object;
+                }
+                wake(0);
+            }
+        }
+
+        void reactor::run_deferred(std::unique_lock<std::mutex>& lock) noexcept
+        {
+            // Only timers can be deferred more than once before this runs, and their callback is always the same.
+            while (reactor_object* const object = m_deferred)
+            {
+                xlang_threadpool_callback const callback = object->deferred_callback;
+                if (--object->deferred_count == 0)
+                {
+                    m_deferred = object->deferred_next;
+                    object->deferred_next = nullptr;
+                }
+
+                lock.unlock();
+                callback(object);
+                lock.lock();
+            }
+        }
+
+        void reactor::schedule_timer(threadpool_timer* timer, int64_t due_time) noexcept
+        {
+            std::lock_guard const guard(m_lock);
+            unlink(timer);
+
+            if (due_time <= 0)
+            {
+                dispatch(timer);
+                return;
+            }
+
+            uint64_t const tick = due_tick(due_time);
+            link(timer, tick);
+            wake(tick);
+        }
+
+        void reactor::schedule_wait(threadpool_wait* wait, int file_descriptor, int64_t timeout) noexcept
+        {
+            std::lock_guard const guard(m_lock);
+            unlink(wait);
+            unwatch(wait);
+
+            wait->file_descriptor = file_descriptor;
+            wait->registration = ++m_next_registration;
+            wait->watching = true;
+            m_waits.push_back(wait);
+            m_waits_changed = true;
+
+            if (timeout > 0)
+            {
+                link(wait, due_tick(timeout));
+            }
+
+            // The reactor has to rebuild its poll set, so wake it regardless of the deadline.
+            wake(0);
+        }
+
+        void reactor::cancel(reactor_object* object) noexcept
+        {
+            std::lock_guard const guard(m_lock);
+            unlink(object);
+            if (object->kind == reactor_object_kind::wait)
+            {
+                unwatch(static_cast<threadpool_wait*>(object));
+            }
+        }
+
+        void reactor::expire(uint64_t now) noexcept
+        {
+            // Visit each slot that has come due since the last pass, at most once per revolution.
+            uint64_t const last = std::min(now, m_processed_tick + wheel_size - 1);
+            for (uint64_t tick = m_processed_tick; tick <= last && m_scheduled_count != 0; ++tick)
+            {
+                reactor_object* next = m_wheel[tick % wheel_size];
+                while (next)
+                {
+                    reactor_object* const object = next;
+                    next = object->wheel_next;
+
+                    // Objects due in a later revolution of the wheel share the slot; leave them be.
+                    if (object->due_tick > now)
+                    {
+                        continue;
+                    }
+
+                    unlink(object);
+                    if (object->kind == reactor_object_kind::wait)
+                    {
+                        unwatch(static_cast<threadpool_wait*>(object));
+                    }
+                    dispatch(object);
+                }
+            }
+            m_processed_tick = now + 1;
+        }
+
+        uint64_t reactor::next_due_tick(uint64_t now) const noexcept
+        {
+            if (m_scheduled_count == 0)
+            {
+                return never;
+            }
+
+            // The first occupied slot may hold only objects for a later revolution, in which case the
+            // reactor wakes early once per revolution and goes back to sleep.
+            for (uint64_t tick = now + 1; tick <= now + wheel_size; ++tick)
+            {
+                if (m_wheel[tick % wheel_size])
+                {
+                    return tick;
+                }
+            }
+            return now + wheel_size;
+        }
+
+        void reactor::run() noexcept
+        {
+            std::vector<pollfd> poll_set;
+            std::vector<std::pair<threadpool_wait*, uint64_t>> poll_waits;
+            std::unique_lock lock(m_lock);
+
+            while (true)
+            {
+                run_deferred(lock);
+                uint64_t const now = current_tick();
+                expire(now);
+
+                if (m_waits_changed || poll_set.empty())
+                {
+                    poll_set.clear();
+                    poll_waits.clear();
+                    poll_set.push_back({ m_wake_pipe[0], POLLIN, 0 });
+                    for (threadpool_wait* wait : m_waits)
+                    {
+                        poll_set.push_back({ wait->file_descriptor, POLLIN, 0 });
+                        poll_waits.emplace_back(wait, wait->registration);
+                    }
+                    m_waits_changed = false;
+                }
+
+                m_wake_tick = next_due_tick(now);
+                int const timeout = m_wake_tick == never ? -1 : static_cast<int>(m_wake_tick - now);
+
+                lock.unlock();
+                int const ready = ::poll(poll_set.data(), static_cast<nfds_t>(poll_set.size()), timeout);
+                lock.lock();
+
+                if (ready <= 0)
+                {
+                    continue;
+                }
+
+                if (poll_set[0].revents != 0)
+                {
+                    char buffer[64];
+                    while (::read(m_wake_pipe[0], buffer, sizeof(buffer)) > 0)
+                    {
+                    }
+                }
+
+                for (size_t i = 1; i < poll_set.size(); ++i)
+                {
+                    if (poll_set[i].revents == 0)
+                    {
+                        continue;
+                    }
+
+                    // The wait may have been cancelled, closed or set again while the lock was released.
+                    // Only a wait that is still registered can be dereferenced.
+                    auto const [wait, registration] = poll_waits[i - 1];
+                    if (std::find(m_waits.begin(), m_waits.end(), wait) == m_waits.end() || wait->registration != registration)
+                    {
+                        continue;
+                    }
+
+                    // Errors, hang ups and invalid descriptors complete the wait rather than spinning on them.
+                    unlink(wait);
+                    unwatch(wait);
+                    dispatch(wait, true);
+                }
+            }
+        }
+    }
+}
+
+void xlang::impl::enter_blocking_region() noexcept
+{
+    // Checked first so that threads outside the pool don't start it.
+    if (current_thread_is_pooled)
+    {
+        executor::instance().enter_blocking_region();
+    }
+}
+
+void xlang::impl::leave_blocking_region() noexcept
+{
+    if (current_thread_is_pooled)
+    {
+        executor::instance().leave_blocking_region();
+    }
+}
+
+using namespace xlang::impl;
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_submit_threadpool_callback(
+    xlang_threadpool_callback callback,
+    void* context
+) noexcept
+try
+{
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    executor::instance().submit({ callback, context });
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_timer(
+    xlang_threadpool_callback callback,
+    void* context,
+    xlang_threadpool_timer* timer
+) noexcept
+try
+{
+    *timer = nullptr;
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    // Start the reactor now, so that setting the timer cannot fail.
+    reactor::instance();
+    *timer = reinterpret_cast<xlang_threadpool_timer>(new threadpool_timer(callback, context));
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_timer(
+    xlang_threadpool_timer timer,
+    int64_t due_time
+) noexcept
+{
+    reactor::instance().schedule_timer(reinterpret_cast<threadpool_timer*>(timer), due_time);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_timer(xlang_threadpool_timer timer) noexcept
+{
+    if (timer)
+    {
+        auto const object = reinterpret_cast<threadpool_timer*>(timer);
+        object->closed.store(true, std::memory_order_release);
+        reactor::instance().cancel(object);
+        object->release();
+    }
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_wait(
+    xlang_threadpool_wait_callback callback,
+    void* context,
+    xlang_threadpool_wait* wait
+) noexcept
+try
+{
+    *wait = nullptr;
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    reactor::instance();
+    *wait = reinterpret_cast<xlang_threadpool_wait>(new threadpool_wait(callback, context));
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_wait(
+    xlang_threadpool_wait wait,
+    void* handle,
+    int64_t timeout
+) noexcept
+{
+    reactor::instance().schedule_wait(reinterpret_cast<threadpool_wait*>(wait), static_cast<int>(reinterpret_cast<intptr_t>(handle)), timeout);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_wait(xlang_threadpool_wait wait) noexcept
+{
+    if (wait)
+    {
+        auto const object = reinterpret_cast<threadpool_wait*>(wait);
+        object->closed.store(true, std::memory_order_release);
+        reactor::instance().cancel(object);
+        object->release();
+    }
+}
@@ -1,10 +1,152 @@
 #include "pal_internal.h"
 #include "pal_error.h"
 #include "atomic_ref_count.h"
+#include "platform_execution_trace.h"
+#include "string_allocate.h"
 #include <xlang/base.h>
 
 namespace xlang::impl
 {
+    // A stack_trace holds the raw return addresses captured when an error was originated, packed
+    // into the same allocation as the object. Frames are symbolized on request.
+    struct stack_trace : xlang_execution_trace
+    {
+        static stack_trace* capture(uint32_t skip_frames) noexcept;
+
+        int32_t XLANG_CALL QueryInterface(xlang_guid const& id, void** object) noexcept final
+        {
+            if (id == xlang_unknown_guid)
+            {
+                *object = static_cast<xlang_unknown*>(this);
+            }
+            else if (id == xlang_execution_trace_guid)
+            {
+                *object = static_cast<xlang_execution_trace*>(this);
+            }
+            else
+            {
+                *object = nullptr;
+                return xlang_hresult_no_interface;
+            }
+            AddRef();
+            return 0;
+        }
+
+        uint32_t XLANG_CALL AddRef() noexcept final
+        {
+            return ++m_count;
+        }
+
+        uint32_t XLANG_CALL Release() noexcept final
+        {
+            auto result = --m_count;
+            if (result == 0)
+            {
+                this->~stack_trace();
+                xlang_mem_free(this);
+            }
+            return result;
+        }
+
+        uint32_t GetFrameCount() noexcept override
+        {
+            return m_frame_count;
+        }
+
+        void const* GetFrameAddress(uint32_t index) noexcept override
+        {
+            return index < m_frame_count ? frames()[index] : nullptr;
+        }
+
+        xlang_error_info* GetFrameDescription(uint32_t index, xlang_string* description) noexcept override
+        try
+        {
+            *description = nullptr;
+            if (index >= m_frame_count)
+            {
+                throw_result(xlang_result::bounds);
+            }
+
+            std::string const text = describe_stack_frame(frames()[index]);
+            return xlang_create_string_utf8(reinterpret_cast<xlang_char8 const*>(text.data()), static_cast<uint32_t>(text.size()), description);
+        }
+        catch (...)
+        {
+            return to_result();
+        }
+
+    private:
+        explicit stack_trace(uint32_t frame_count) noexcept :
+            m_frame_count{ frame_count }
+        {
+        }
+
+        void** frames() noexcept
+        {
+            return get_packed_buffer_ptr<stack_trace, void*>(this);
+        }
+
+        atomic_ref_count m_count;
+        uint32_t m_frame_count{};
+    };
+
+    stack_trace* stack_trace::capture(uint32_t skip_frames) noexcept
+    {
+        void* frames[max_execution_trace_frames];
+        uint32_t const frame_count = capture_stack_trace(frames, max_execution_trace_frames, skip_frames + 1);
+
+        void* storage = xlang_mem_alloc(sizeof(stack_trace) + frame_count * sizeof(void*));
+        if (!storage)
+        {
+            return nullptr;
+        }
+
+        auto trace = new (storage) stack_trace{ frame_count };
+        std::copy(frames, frames + frame_count, trace->frames());
+        return trace;
+    }
+
+    // Execution traces are captured for one in every trace_sample_interval errors originated on a
+    // thread. When sampling is disabled, the cost to origination is a single relaxed load.
+    std::atomic<uint32_t> trace_sample_interval{ 0 };
+    thread_local uint32_t t_trace_sample_countdown{ 0 };
+
+    bool should_capture_execution_trace() noexcept
+    {
+        uint32_t const interval = trace_sample_interval.load(std::memory_order_relaxed);
+        if (interval == 0)
+        {
+            return false;
+        }
+
+        if (t_trace_sample_countdown == 0 || t_trace_sample_countdown > interval)
+        {
+            t_trace_sample_countdown = interval;
+        }
+        return --t_trace_sample_countdown == 0;
+    }
+
+    // Origination is often on paths where failures are ordinary control flow, so released error_info
+    // objects are kept on a small per-thread free list rather than going back to the heap.
+    struct error_info_pool
+    {
+        static void* allocate() noexcept;
+        static void free(void* storage) noexcept;
+
+        ~error_info_pool() noexcept;
+
+    private:
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        static constexpr uint32_t max_free_count = 16;
+
+        free_block* m_free_list{ nullptr };
+        uint32_t m_free_count{};
+    };
+
     struct error_info : xlang_error_info
     {
         // Used to construct constant errors used in out of memory scenarios.
@@ -17,6 +159,7 @@ namespace xlang::impl
         explicit error_info(
             xlang_result result,
             xlang_string message,
+            xlang_char8 const* static_message,
             xlang_string projection_identifier,
             xlang_string language_error,
             xlang_unknown* execution_trace,
@@ -24,6 +167,7 @@ namespace xlang::impl
         ) noexcept :
             m_result{ result },
             m_message{ message },
+            m_static_message{ static_message },
             m_projection_identifier{ projection_identifier },
             m_language_error{ language_error }
         {
@@ -31,6 +175,15 @@ namespace xlang::impl
             m_language_information.copy_from(language_information);
         }
 
+        static xlang_error_info* originate(
+            xlang_result result,
+            xlang_string message,
+            xlang_char8 const* static_message,
+            xlang_string projection_identifier,
+            xlang_string language_error,
+            xlang_unknown* execution_trace,
+            xlang_unknown* language_information) noexcept;
+
         int32_t XLANG_CALL QueryInterface(xlang_guid const& id, void** object) noexcept final
         {
             if (id == xlang_unknown_guid)
@@ -61,7 +214,8 @@ namespace xlang::impl
             auto result = --m_count;
             if (result == 0)
             {
-                delete this;
+                this->~error_info();
+                error_info_pool::free(this);
             }
             return result;
         }
@@ -73,7 +227,22 @@ namespace xlang::impl
 
         void GetMessage(xlang_string* message) noexcept override
         {
-            *message = m_message;
+            if (m_message || !m_static_message)
+            {
+                *message = m_message;
+                return;
+            }
+
+            // Static messages are only turned into strings when someone asks for them. Interning
+            // makes this allocation-free after the first request for a given message, and the
+            // resulting string never needs to be released.
+            *message = nullptr;
+            auto const length = std::char_traits<xlang_char8>::length(m_static_message);
+            xlang_error_info* error = xlang_intern_string_utf8(m_static_message, static_cast<uint32_t>(length), message);
+            if (error)
+            {
+                error->Release();
+            }
         }
 
         void GetLanguageError(xlang_string* language_error) noexcept override
@@ -117,9 +286,10 @@ namespace xlang::impl
 
             com_ptr<xlang_error_info> propagated_error;
             propagated_error.attach(
-                xlang_originate_error(
+                originate(
                     m_result,
                     m_message,
+                    m_static_message,
                     projection_identifier,
                     language_error,
                     execution_trace,
@@ -136,6 +306,7 @@ namespace xlang::impl
     private:
         xlang_result m_result{};
         xlang_string m_message{ nullptr };
+        xlang_char8 const* m_static_message{ nullptr };
         xlang_string m_language_error{ nullptr };
         com_ptr<xlang_unknown> m_execution_trace;
         xlang_string m_projection_identifier{ nullptr };
@@ -145,6 +316,54 @@ namespace xlang::impl
         atomic_ref_count m_count;
     };
 
+    thread_local error_info_pool t_error_info_pool;
+
+    // Set once the pool for this thread has been destroyed. This is trivially destructible, so it remains
+    // valid if errors are released by other thread_local destructors during thread exit.
+    thread_local bool t_error_info_pool_destroyed{ false };
+
+    void* error_info_pool::allocate() noexcept
+    {
+        if (!t_error_info_pool_destroyed)
+        {
+            error_info_pool& pool = t_error_info_pool;
+            if (pool.m_free_list)
+            {
+                free_block* block = pool.m_free_list;
+                pool.m_free_list = block->next;
+                --pool.m_free_count;
+                return block;
+            }
+        }
+        return ::operator new(sizeof(error_info), std::nothrow);
+    }
+
+    void error_info_pool::free(void* storage) noexcept
+    {
+        if (!t_error_info_pool_destroyed)
+        {
+            error_info_pool& pool = t_error_info_pool;
+            if (pool.m_free_count < max_free_count)
+            {
+                pool.m_free_list = new (storage) free_block{ pool.m_free_list };
+                ++pool.m_free_count;
+                return;
+            }
+        }
+        ::operator delete(storage);
+    }
+
+    error_info_pool::~error_info_pool() noexcept
+    {
+        t_error_info_pool_destroyed = true;
+        while (m_free_list)
+        {
+            free_block* next = m_free_list->next;
+            ::operator delete(m_free_list);
+            m_free_list = next;
+        }
+    }
+
     error_info error_code_errors [] = {
         error_info {xlang_result::access_denied},
         error_info {xlang_result::bounds},
@@ -158,6 +377,45 @@ namespace xlang::impl
         error_info {xlang_result::pointer},
         error_info {xlang_result::type_load}
     };
+
+    xlang_error_info* error_info::originate(
+        xlang_result result,
+        xlang_string message,
+        xlang_char8 const* static_message,
+        xlang_string projection_identifier,
+        xlang_string language_error,
+        xlang_unknown* execution_trace,
+        xlang_unknown* language_information) noexcept
+    {
+        void* storage = error_info_pool::allocate();
+
+        // If failed to allocate, use the statically allocated ones.
+        if (storage == nullptr)
+        {
+            xlang_error_info* error = &error_code_errors[static_cast<int>(result) - 1];
+            error->AddRef();
+            return error;
+        }
+
+        com_ptr<xlang_unknown> captured_trace;
+        if (!execution_trace && should_capture_execution_trace())
+        {
+            // Skip this function and the exported function that called it.
+            captured_trace.attach(stack_trace::capture(2));
+            execution_trace = captured_trace.get();
+        }
+
+        return new (storage) error_info
+        {
+            result,
+            message,
+            static_message,
+            projection_identifier,
+            language_error,
+            execution_trace,
+            language_information
+        };
+    }
 }
 
 [[nodiscard]] XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_originate_error(
@@ -169,23 +427,25 @@ namespace xlang::impl
     xlang_unknown* language_information
 ) XLANG_NOEXCEPT
 {
-    xlang_error_info* error_info =
-        new (std::nothrow) xlang::impl::error_info
-    {
+    return xlang::impl::error_info::originate(
         error,
         message,
+        nullptr,
         projection_identifier,
         language_error,
         execution_trace,
-        language_information
-    };
+        language_information);
+}
 
-    // If failed to construct, use the statically allocated ones.
-    if (error_info == nullptr)
-    {
-        error_info = &xlang::impl::error_code_errors[static_cast<int>(error)];
-        error_info->AddRef();
-    }
+[[nodiscard]] XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_originate_static_error(
+    xlang_result error,
+    xlang_char8 const* message
+) XLANG_NOEXCEPT
+{
+    return xlang::impl::error_info::originate(error, nullptr, message, nullptr, nullptr, nullptr, nullptr);
+}
 
-    return error_info;
-}
\ No newline at end of file
+XLANG_PAL_EXPORT void XLANG_CALL xlang_set_execution_trace_sampling(uint32_t sample_interval) XLANG_NOEXCEPT
+{
+    xlang::impl::trace_sample_interval.store(sample_interval, std::memory_order_relaxed);
+}
@@ -4,6 +4,7 @@
 #include "atomic_ref_count.h"
 #include "heap_string.h"
 #include "cache_string.h"
+#include "string_statistics.h"
 
 namespace xlang::impl
 {
@@ -56,6 +57,8 @@ namespace xlang::impl
         heap_string(heap_string const&) = delete;
         heap_string& operator=(heap_string const&) = delete;
 
+        static int64_t allocated_size(uint32_t length, bool utf8) noexcept;
+
         template <typename char_type>
         static heap_string* create_impl(
             char_type const* source_string,
@@ -183,6 +186,7 @@ namespace xlang::impl
             {
                 mutable_buffer<char16_t>()[length] = 0;
             }
+            record_bytes_released(allocated_size(get_length(), utf8) - allocated_size(length, utf8));
             update_preallocated_length(length);
             promote_string_buffer_flags();
             XLANG_ASSERT(is_utf8() == utf8);
@@ -222,22 +226,31 @@ namespace xlang::impl
                 alternate->release();
             }
 
+            record_strings_destroyed(is_utf8(), 1, allocated_size(get_length(), is_utf8()));
             xlang_mem_free(this);
         }
         return result;
     }
 
+    inline int64_t heap_string::allocated_size(uint32_t length, bool utf8) noexcept
+    {
+        int64_t const char_size = utf8 ? sizeof(xlang_char8) : sizeof(char16_t);
+        return sizeof(heap_string) + (static_cast<int64_t>(length) + 1) * char_size;
+    }
+
     template <typename char_type>
     inline heap_string* heap_string::create_impl(
         char_type const* source_string,
         uint32_t length,
         cache_string* alternate)
     {
-        heap_string* new_string = reinterpret_cast<heap_string*>(xlang_mem_alloc(packed_buffer_size<heap_string, char_type>(length)));
+        auto const packed_size = packed_buffer_size<heap_string, char_type>(length);
+        heap_string* new_string = reinterpret_cast<heap_string*>(xlang_mem_alloc(packed_size));
         if (!new_string)
         {
             throw std::bad_alloc{};
         }
+        record_strings_created(string_statistic::heap_strings_created, std::is_same_v<char_type, xlang_char8>, 1, packed_size);
 
         char_type* buffer = get_packed_buffer_ptr<heap_string, char_type>(new_string);
         new (new_string) heap_string(source_string, length, buffer);
@@ -8,8 +8,12 @@ namespace xlang::impl
 {
     struct atomic_ref_count
     {
+        atomic_ref_count() noexcept = default;
+        explicit atomic_ref_count(int32_t initial) noexcept;
+
         int32_t operator++() noexcept;
         int32_t operator--() noexcept;
+        int32_t operator-=(int32_t value) noexcept;
 
         int32_t get_count() const noexcept;
 
@@ -17,6 +21,12 @@ namespace xlang::impl
         std::atomic<int32_t> count{ 1 };
     };
 
+    inline atomic_ref_count::atomic_ref_count(int32_t initial) noexcept
+        : count{ initial }
+    {
+        XLANG_ASSERT(initial > 0);
+    }
+
     inline int32_t atomic_ref_count::operator++() noexcept
     {
         // Safe to increment relaxed. New references can only be formed from an existing reference.
@@ -27,13 +37,18 @@ namespace xlang::impl
     }
 
     inline int32_t atomic_ref_count::operator--() noexcept
+    {
+        return *this -= 1;
+    }
+
+    inline int32_t atomic_ref_count::operator-=(int32_t value) noexcept
     {
         // This could be std::memory_order_acq_rel, but would result in an unneeded "aquire"
         // operations when the counter has not yet reached zero. This case is protected via the
         // fence later.
         // memory_order_release on decrement forces all other writes on the current thread to
         // be visible before the decremented refcount is stored
-        auto result = count.fetch_sub(1, std::memory_order_release) - 1;
+        auto result = count.fetch_sub(value, std::memory_order_release) - value;
         XLANG_ASSERT(result >= 0);
         if (result == 0)
         {
@@ -5,15 +5,10 @@
 
 namespace xlang
 {
+    // message must be a string literal; it is only converted to a string if the error's message is requested.
     [[noreturn]] inline void throw_result(xlang_result result, xlang_char8 const* const message = nullptr)
     {
-        xlang_string abi_message{ nullptr };
-        if (message != nullptr)
-        {
-            abi_message = detach_abi(message);
-        }
-
-        throw xlang_originate_error(result, abi_message);
+        throw xlang_originate_static_error(result, message);
     }
 
     [[noreturn]] inline void throw_result(xlang_error_info* result)
@@ -0,0 +1,86 @@
+#include "interned_string.h"
+#include "string_allocate.h"
+#include "string_statistics.h"
+
+namespace xlang::impl
+{
+    namespace
+    {
+        // The intern table is an insert-only, chained hash table with a fixed number of buckets.
+        // Since entries are never removed, lookups are lock-free: a reader only ever observes fully
+        // constructed strings that were published with a release compare-exchange on the bucket head.
+        constexpr size_t intern_bucket_count = 1 << 14;
+        std::atomic<interned_string*> intern_buckets[intern_bucket_count];
+    }
+
+    interned_string* interned_string::intern_utf8(std::basic_string_view<xlang_char8> value)
+    {
+        uint64_t const hash = intern_hash(value);
+        std::atomic<interned_string*>& bucket = intern_buckets[hash & (intern_bucket_count - 1)];
+
+        interned_string* head = bucket.load(std::memory_order_acquire);
+        for (interned_string* current = head; current; current = current->next)
+        {
+            if (current->equals(value, hash))
+            {
+                return current;
+            }
+        }
+
+        interned_string* new_string = create(value, hash);
+        auto const new_string_size = packed_buffer_size<interned_string, xlang_char8>(new_string->get_length());
+        while (true)
+        {
+            new_string->next = head;
+            interned_string* const previous_head = head;
+            if (bucket.compare_exchange_weak(head, new_string, std::memory_order_release, std::memory_order_acquire))
+            {
+                record_strings_created(string_statistic::interned_strings_created, true, 1, new_string_size);
+                return new_string;
+            }
+
+            // Another thread published to this bucket first. Only the entries in front of the
+            // previously observed head are new, so those are the only ones that need checking.
+            for (interned_string* current = head; current != previous_head; current = current->next)
+            {
+                if (current->equals(value, hash))
+                {
+                    destroy_unpublished(new_string);
+                    return current;
+                }
+            }
+        }
+    }
+
+    interned_string* interned_string::create(std::basic_string_view<xlang_char8> value, uint64_t hash)
+    {
+        // Transcode first, so that invalid UTF-8 is rejected before anything else is allocated.
+        auto alternate = cache_string::create(value.data(), static_cast<uint32_t>(value.size()));
+
+        auto const length = static_cast<uint32_t>(value.size());
+        interned_string* new_string = reinterpret_cast<interned_string*>(xlang_mem_alloc(packed_buffer_size<interned_string, xlang_char8>(length)));
+        if (!new_string)
+        {
+            throw std::bad_alloc{};
+        }
+
+        xlang_char8* buffer = get_packed_buffer_ptr<interned_string, xlang_char8>(new_string);
+        new (new_string) interned_string(buffer, value, hash);
+
+        auto new_alternate = new_string->set_alternate_ptr<cache_string>(alternate.get());
+        XLANG_ASSERT(new_alternate == alternate.get());
+        (void)new_alternate;
+        alternate.release();
+        return new_string;
+    }
+
+    void interned_string::destroy_unpublished(interned_string* str) noexcept
+    {
+        auto alternate = str->get_alternate_ptr<cache_string>();
+        if (alternate)
+        {
+            alternate->release();
+        }
+        xlang_mem_free(str);
+    }
+}
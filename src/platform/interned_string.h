@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string_view>
+#include "string_base.h"
+#include "cache_string.h"
+
+namespace xlang::impl
+{
+    // interned_string is a canonical, immortal string instance. There is at most one interned_string
+    // for any given sequence of characters, regardless of the encoding used to intern it, so two interned
+    // handles are equal if and only if their contents are equal.
+    //
+    // The UTF-8 representation is packed into the same allocation as the string header, and the UTF-16
+    // representation is eagerly created as the cache_string alternate before the string is published.
+    // Requesting a raw buffer in either encoding therefore never allocates. Interned strings are never
+    // freed, so duplicating or deleting one is a no-op.
+    struct interned_string : string_base
+    {
+        template <typename char_type>
+        static interned_string* intern(
+            char_type const* source_string,
+            uint32_t length);
+
+    private:
+        interned_string(
+            xlang_char8* char_storage,
+            std::basic_string_view<xlang_char8> value,
+            uint64_t hash
+        ) noexcept;
+
+        interned_string() = delete;
+        ~interned_string() = delete;
+        interned_string(interned_string const&) = delete;
+        interned_string& operator=(interned_string const&) = delete;
+
+        static interned_string* intern_utf8(std::basic_string_view<xlang_char8> value);
+        static interned_string* create(std::basic_string_view<xlang_char8> value, uint64_t hash);
+        static void destroy_unpublished(interned_string* str) noexcept;
+
+        bool equals(std::basic_string_view<xlang_char8> value, uint64_t hash) const noexcept;
+
+        interned_string* next{ nullptr };
+        uint64_t hash_{};
+    };
+
+    inline uint64_t intern_hash(std::basic_string_view<xlang_char8> value) noexcept
+    {
+        // 64-bit FNV-1a over the UTF-8 representation, which is the canonical key for the intern table.
+        uint64_t result = 0xcbf29ce484222325ull;
+        for (auto ch : value)
+        {
+            result ^= static_cast<uint8_t>(ch);
+            result *= 0x100000001b3ull;
+        }
+        return result;
+    }
+
+    inline interned_string::interned_string(
+        xlang_char8* char_storage,
+        std::basic_string_view<xlang_char8> value,
+        uint64_t hash
+    ) noexcept
+        : string_base(char_storage, static_cast<uint32_t>(value.size()), string_flags::is_interned)
+        , hash_{ hash }
+    {
+        std::copy(value.begin(), value.end(), char_storage);
+        char_storage[value.size()] = 0;
+    }
+
+    inline bool interned_string::equals(std::basic_string_view<xlang_char8> value, uint64_t hash) const noexcept
+    {
+        return hash_ == hash &&
+            get_length() == value.size() &&
+            std::equal(value.begin(), value.end(), get_buffer<xlang_char8>());
+    }
+
+    template <typename char_type>
+    interned_string* interned_string::intern(
+        char_type const* source_string,
+        uint32_t length)
+    {
+        static_assert(std::disjunction_v<std::is_same<char_type, xlang_char8>, std::is_same<char_type, char16_t>>, "char_t must be either xlang_char8 or char16_t");
+        if (length == 0)
+        {
+            return nullptr;
+        }
+
+        if constexpr (std::is_same_v<char_type, xlang_char8>)
+        {
+            return intern_utf8({ source_string, length });
+        }
+        else
+        {
+            // The table is keyed on UTF-8, so UTF-16 input is transcoded first. Most interned
+            // strings are identifiers, which comfortably fit in the stack buffer.
+            uint32_t const utf8_length = get_converted_length({ source_string, length });
+            std::array<xlang_char8, 256> stack_buffer;
+            std::unique_ptr<xlang_char8[]> heap_buffer;
+            xlang_char8* utf8_buffer = stack_buffer.data();
+            if (utf8_length > stack_buffer.size())
+            {
+                heap_buffer.reset(new xlang_char8[utf8_length]);
+                utf8_buffer = heap_buffer.get();
+            }
+            convert_string({ source_string, length }, utf8_buffer, utf8_length);
+            return intern_utf8({ utf8_buffer, utf8_length });
+        }
+    }
+}
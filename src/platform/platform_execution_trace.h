@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pal.h"
+#include <string>
+
+namespace xlang::impl
+{
+    inline constexpr uint32_t max_execution_trace_frames = 64;
+
+    // Captures up to max_frames return addresses from the calling thread's stack, skipping the
+    // innermost skip_frames frames (in addition to this function's own frame).
+    uint32_t capture_stack_trace(void** frames, uint32_t max_frames, uint32_t skip_frames) noexcept;
+
+    // Produces a human readable description of a captured frame, such as "module!symbol+0x1c".
+    std::string describe_stack_frame(void const* address);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "pal.h"
+
+namespace xlang::impl
+{
+    // Tells the thread pool that the calling thread is about to block, and that it no longer is. A pool
+    // thread that blocks while callbacks are queued is replaced straight away, rather than once the pool
+    // notices that nothing is being dequeued. Calls from other threads are ignored. Only the pool used
+    // outside of Windows implements these; the system thread pool does its own accounting.
+    void enter_blocking_region() noexcept;
+    void leave_blocking_region() noexcept;
+
+    struct blocking_region
+    {
+        blocking_region() noexcept
+        {
+            enter_blocking_region();
+        }
+
+        ~blocking_region()
+        {
+            leave_blocking_region();
+        }
+
+        blocking_region(blocking_region const&) = delete;
+        blocking_region& operator=(blocking_region const&) = delete;
+    };
+}
@@ -176,6 +176,21 @@ extern "C"
     };
     typedef xlang_string_buffer__* xlang_string_buffer;
 
+    struct xlang_threadpool_timer__
+    {
+        int unused;
+    };
+    typedef xlang_threadpool_timer__* xlang_threadpool_timer;
+
+    struct xlang_threadpool_wait__
+    {
+        int unused;
+    };
+    typedef xlang_threadpool_wait__* xlang_threadpool_wait;
+
+    typedef void(XLANG_CALL * xlang_threadpool_callback)(void* context);
+    typedef void(XLANG_CALL * xlang_threadpool_wait_callback)(void* context, bool signaled);
+
     struct xlang_string_header
     {
         void* reserved1;
@@ -233,6 +248,22 @@ extern "C"
     };
 #endif
 
+    // Process-wide string diagnostics, maintained in all build flavors. Counts of created strings
+    // are cumulative; live strings and bytes are a snapshot and may be momentarily inconsistent
+    // with each other while other threads are creating or releasing strings.
+    struct xlang_string_statistics
+    {
+        uint64_t live_utf8_strings;
+        uint64_t live_utf16_strings;
+        uint64_t bytes_held;
+        uint64_t utf8_caches_created;
+        uint64_t utf16_caches_created;
+        uint64_t heap_strings_created;
+        uint64_t reference_strings_created;
+        uint64_t batch_strings_created;
+        uint64_t interned_strings_created;
+    };
+
     struct XLANG_NOVTABLE xlang_error_info : xlang_unknown
     {
         virtual void GetError(xlang_result* error) XLANG_NOEXCEPT = 0;
@@ -251,6 +282,16 @@ extern "C"
     };
     inline constexpr xlang_guid xlang_error_info_guid{ 0xadf906fb, 0x11ac, 0x49ec, { 0x8d, 0xfd, 0x64, 0xc2, 0x6d, 0x8, 0x87, 0xb0 } };
 
+    // Execution traces captured by the PAL store raw return addresses. Frames are only symbolized
+    // when a description is requested.
+    struct XLANG_NOVTABLE xlang_execution_trace : xlang_unknown
+    {
+        virtual uint32_t GetFrameCount() XLANG_NOEXCEPT = 0;
+        virtual void const* GetFrameAddress(uint32_t index) XLANG_NOEXCEPT = 0;
+        virtual xlang_error_info* GetFrameDescription(uint32_t index, xlang_string* description) XLANG_NOEXCEPT = 0;
+    };
+    inline constexpr xlang_guid xlang_execution_trace_guid{ 0x5b3e5c6a, 0x1f0d, 0x4c52, { 0x9a, 0x4e, 0x6b, 0x21, 0xd3, 0x7f, 0x80, 0x19 } };
+
     // Function declarations
     XLANG_PAL_EXPORT void* XLANG_CALL xlang_mem_alloc(size_t count) XLANG_NOEXCEPT;
 
@@ -280,8 +321,42 @@ extern "C"
         xlang_string* string
     ) XLANG_NOEXCEPT;
 
+    // Interned strings are canonical and immortal: interning the same contents in either encoding
+    // always yields the same handle, and duplicating or deleting an interned string is a no-op.
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_intern_string_utf8(
+        xlang_char8 const* source_string,
+        uint32_t length,
+        xlang_string* string
+    ) XLANG_NOEXCEPT;
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_intern_string_utf16(
+        char16_t const* source_string,
+        uint32_t length,
+        xlang_string* string
+    ) XLANG_NOEXCEPT;
+
     XLANG_PAL_EXPORT void XLANG_CALL xlang_delete_string(xlang_string string) XLANG_NOEXCEPT;
 
+    // Batch creation packs all of the strings into a single allocation. source_strings holds the
+    // characters of every string back to back, with lengths[i] characters for strings[i] and no
+    // separators. Strings created this way are released individually or with xlang_delete_strings.
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_strings_utf8(
+        uint32_t count,
+        uint32_t const* lengths,
+        xlang_char8 const* source_strings,
+        xlang_string* strings
+    ) XLANG_NOEXCEPT;
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_strings_utf16(
+        uint32_t count,
+        uint32_t const* lengths,
+        char16_t const* source_strings,
+        xlang_string* strings
+    ) XLANG_NOEXCEPT;
+
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_delete_strings(
+        uint32_t count,
+        xlang_string const* strings
+    ) XLANG_NOEXCEPT;
+
     XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_delete_string_buffer(xlang_string_buffer buffer_handle) XLANG_NOEXCEPT;
 
     XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_duplicate_string(
@@ -321,6 +396,10 @@ extern "C"
         uint32_t length
     ) XLANG_NOEXCEPT;
 
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_get_string_statistics(
+        xlang_string_statistics* statistics
+    ) XLANG_NOEXCEPT;
+
     XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_get_activation_factory(
         xlang_string class_name,
         xlang_guid const& iid,
@@ -347,6 +426,85 @@ extern "C"
         xlang_unknown* language_information) XLANG_NOEXCEPT;
 #endif
 
+    // Controls execution trace capture for originated errors that are not given an execution trace.
+    // A sample_interval of zero disables capture (the default), one captures a trace for every error,
+    // and N captures a trace for one in every N errors originated on each thread.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_set_execution_trace_sampling(uint32_t sample_interval) XLANG_NOEXCEPT;
+
+    // Originates an error whose message is a null-terminated UTF-8 string with static storage duration.
+    // No string is created unless GetMessage is called, and error_info objects are recycled per thread,
+    // so paths that only inspect the result code do not allocate.
+#ifdef __cplusplus
+    [[nodiscard]] XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_originate_static_error(
+        xlang_result error,
+        xlang_char8 const* message = nullptr) XLANG_NOEXCEPT;
+#else
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_originate_static_error(
+        xlang_result error,
+        xlang_char8 const* message) XLANG_NOEXCEPT;
+#endif
+
+    // Queues a callback to run on the process-wide thread pool. On Windows this is the system thread
+    // pool; elsewhere it is a work-stealing pool with one worker per hardware thread. A callback may
+    // block waiting for another callback queued to the pool. A worker that blocks in
+    // xlang_wait_on_address is replaced at once; other blocking is only noticed once queued callbacks
+    // have made no progress for a quarter of a second, after which the pool adds temporary workers at
+    // growing intervals, at most one per hardware thread, so such waits delay everything behind them.
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_submit_threadpool_callback(
+        xlang_threadpool_callback callback,
+        void* context
+    ) XLANG_NOEXCEPT;
+
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_timer(
+        xlang_threadpool_callback callback,
+        void* context,
+        xlang_threadpool_timer* timer
+    ) XLANG_NOEXCEPT;
+
+    // Arms the timer to run its callback on the thread pool once due_time, a relative time in
+    // 100-nanosecond intervals, has elapsed. A due time of zero or less expires the timer immediately.
+    // Setting an armed timer replaces its due time.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_timer(
+        xlang_threadpool_timer timer,
+        int64_t due_time
+    ) XLANG_NOEXCEPT;
+
+    // Cancels the timer if it is armed and frees it once any callback already running has returned.
+    // It is safe to close a timer from within its own callback.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_timer(xlang_threadpool_timer timer) XLANG_NOEXCEPT;
+
+    XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_wait(
+        xlang_threadpool_wait_callback callback,
+        void* context,
+        xlang_threadpool_wait* wait
+    ) XLANG_NOEXCEPT;
+
+    // Waits for handle to be signaled and then runs the callback on the thread pool, with signaled set
+    // to false if timeout, a relative time in 100-nanosecond intervals, elapsed first. A timeout of zero
+    // or less waits indefinitely. On Windows handle is a waitable object handle; elsewhere it is a file
+    // descriptor, cast through intptr_t, that is signaled when it becomes readable (such as an eventfd).
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_wait(
+        xlang_threadpool_wait wait,
+        void* handle,
+        int64_t timeout
+    ) XLANG_NOEXCEPT;
+
+    // Cancels the wait if it is pending and frees it once any callback already running has returned.
+    // It is safe to close a wait from within its own callback.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_wait(xlang_threadpool_wait wait) XLANG_NOEXCEPT;
+
+    // Blocks the calling thread while the 32-bit value at address equals compare_value. The wait ends
+    // when another thread changes the value and calls xlang_wake_by_address_all, but may also end
+    // spuriously, so callers re-check the value in a loop.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_wait_on_address(
+        void const* address,
+        uint32_t compare_value
+    ) XLANG_NOEXCEPT;
+
+    // Wakes every thread waiting on address. The address is only used as a key, so it is safe to wake
+    // after the value at address has been freed by a thread that observed the change.
+    XLANG_PAL_EXPORT void XLANG_CALL xlang_wake_by_address_all(void const* address) XLANG_NOEXCEPT;
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,8 @@
 #include "opaque_string_wrapper.h"
 #include "string_reference.h"
+#include "interned_string.h"
+#include "block_string.h"
+#include "string_statistics.h"
 #include "pal_error.h"
 
 // Define the ABI-level implementations of string methods
@@ -37,6 +40,79 @@ namespace xlang::impl
         return nullptr;
     }
 
+    template <typename char_type>
+    void create_strings(
+        uint32_t count,
+        uint32_t const* lengths,
+        char_type const* source_strings,
+        xlang_string* strings)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (!lengths || !strings)
+        {
+            xlang::throw_result(xlang_result::pointer);
+        }
+
+        string_block::create(count, lengths, source_strings, strings);
+    }
+
+    void delete_strings(uint32_t count, xlang_string const* strings) noexcept
+    {
+        // Consecutive strings from the same batch are released with a single update
+        // to their block's reference count.
+        string_block* pending_block{};
+        int32_t pending_count{};
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            string_base* str = from_handle(strings[i]);
+            if (!str)
+            {
+                continue;
+            }
+
+            if (str->is_block())
+            {
+                string_block* block = static_cast<block_string*>(str)->get_block();
+                if (block == pending_block)
+                {
+                    ++pending_count;
+                    continue;
+                }
+
+                if (pending_block)
+                {
+                    pending_block->release(pending_count);
+                }
+                pending_block = block;
+                pending_count = 1;
+            }
+            else
+            {
+                str->release_base();
+            }
+        }
+
+        if (pending_block)
+        {
+            pending_block->release(pending_count);
+        }
+    }
+
+    template <typename char_type>
+    xlang_string intern_string(char_type const* source_string, uint32_t length)
+    {
+        if (!source_string && length != 0)
+        {
+            xlang::throw_result(xlang_result::pointer);
+        }
+
+        return to_handle(interned_string::intern(source_string, length));
+    }
+
     template <typename char_type>
     xlang_string create_string_reference(
         char_type const* source_string,
@@ -163,6 +239,38 @@ catch (...)
     return xlang::to_result();
 }
 
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_intern_string_utf8(
+    xlang_char8 const* source_string,
+    uint32_t length,
+    xlang_string* string
+) XLANG_NOEXCEPT
+try
+{
+    *string = xlang::impl::intern_string(source_string, length);
+    return nullptr;
+}
+catch (...)
+{
+    *string = nullptr;
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_intern_string_utf16(
+    char16_t const* source_string,
+    uint32_t length,
+    xlang_string* string
+) XLANG_NOEXCEPT
+try
+{
+    *string = xlang::impl::intern_string(source_string, length);
+    return nullptr;
+}
+catch (...)
+{
+    *string = nullptr;
+    return xlang::to_result();
+}
+
 XLANG_PAL_EXPORT void XLANG_CALL xlang_delete_string(xlang_string string) XLANG_NOEXCEPT
 {
     string_base* str = from_handle(string);
@@ -172,6 +280,57 @@ XLANG_PAL_EXPORT void XLANG_CALL xlang_delete_string(xlang_string string) XLANG_
     }
 }
 
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_strings_utf8(
+    uint32_t count,
+    uint32_t const* lengths,
+    xlang_char8 const* source_strings,
+    xlang_string* strings
+) XLANG_NOEXCEPT
+try
+{
+    xlang::impl::create_strings(count, lengths, source_strings, strings);
+    return nullptr;
+}
+catch (...)
+{
+    if (strings)
+    {
+        std::fill(strings, strings + count, nullptr);
+    }
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_strings_utf16(
+    uint32_t count,
+    uint32_t const* lengths,
+    char16_t const* source_strings,
+    xlang_string* strings
+) XLANG_NOEXCEPT
+try
+{
+    xlang::impl::create_strings(count, lengths, source_strings, strings);
+    return nullptr;
+}
+catch (...)
+{
+    if (strings)
+    {
+        std::fill(strings, strings + count, nullptr);
+    }
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_delete_strings(
+    uint32_t count,
+    xlang_string const* strings
+) XLANG_NOEXCEPT
+{
+    if (strings)
+    {
+        xlang::impl::delete_strings(count, strings);
+    }
+}
+
 XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_delete_string_buffer(xlang_string_buffer buffer_handle) XLANG_NOEXCEPT
 try
 {
@@ -326,3 +485,30 @@ catch (...)
 {
     return xlang::to_result();
 }
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_get_string_statistics(
+    xlang_string_statistics* statistics
+) XLANG_NOEXCEPT
+{
+    if (!statistics)
+    {
+        return;
+    }
+
+    // Shards are read independently, so a sum may briefly dip below zero while a string
+    // created on one shard is released on another.
+    auto get = [](string_statistic statistic) noexcept
+    {
+        return static_cast<uint64_t>(std::max<int64_t>(get_string_statistic(statistic), 0));
+    };
+
+    statistics->live_utf8_strings = get(string_statistic::live_utf8_strings);
+    statistics->live_utf16_strings = get(string_statistic::live_utf16_strings);
+    statistics->bytes_held = get(string_statistic::bytes_held);
+    statistics->utf8_caches_created = get(string_statistic::utf8_caches_created);
+    statistics->utf16_caches_created = get(string_statistic::utf16_caches_created);
+    statistics->heap_strings_created = get(string_statistic::heap_strings_created);
+    statistics->reference_strings_created = get(string_statistic::reference_strings_created);
+    statistics->batch_strings_created = get(string_statistic::batch_strings_created);
+    statistics->interned_strings_created = get(string_statistic::interned_strings_created);
+}
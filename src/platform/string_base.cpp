@@ -1,15 +1,26 @@
 #include "string_base.h"
 #include "string_reference.h"
 #include "heap_string.h"
+#include "block_string.h"
 
 namespace xlang::impl
 {
     void string_base::release_base() noexcept
     {
+        if (this->is_interned())
+        {
+            // Interned strings are immortal
+            return;
+        }
+
         if (this->is_reference())
         {
             static_cast<string_reference*>(this)->release();
         }
+        else if (this->is_block())
+        {
+            static_cast<block_string*>(this)->release();
+        }
         else
         {
             static_cast<heap_string*>(this)->release();
@@ -18,6 +29,11 @@ namespace xlang::impl
 
     string_base* string_base::duplicate_base()
     {
+        if (this->is_interned())
+        {
+            return this;
+        }
+
         if (this->is_reference())
         {
             auto str = static_cast<string_reference*>(this);
@@ -31,6 +47,11 @@ namespace xlang::impl
                 return heap_string::create(str->get_buffer<char16_t>(), str->get_length(), str->get_alternate());
             }
         }
+        else if (this->is_block())
+        {
+            static_cast<block_string*>(this)->addref();
+            return this;
+        }
         else
         {
             static_cast<heap_string*>(this)->addref();
@@ -14,6 +14,8 @@ namespace xlang::impl
     {
         none = 0x0000,         // None
         is_reference = 0x0001, // Whether this is a "fast" string
+        is_interned = 0x0002,  // Canonical, immortal string owned by the intern table
+        is_block = 0x0004,     // Shares a single allocation with other strings created in the same batch
         is_utf8 = 0x0020,      // Character pointer is UTF-8 data
 
         is_preallocated_string_buffer = 0xF8B10000,
@@ -55,6 +57,8 @@ namespace xlang::impl
 
     inline constexpr string_flags all_valid_flags =
         string_flags::is_reference |
+        string_flags::is_interned |
+        string_flags::is_block |
         string_flags::is_utf8 |
         string_flags::reserved_for_preallocated_string_buffer;
 
@@ -97,6 +101,12 @@ namespace xlang::impl
     //      heap_string is a shared, immutable, heap-allocated string instance that packes the
     //          string header data and character data into a single allocation.
     //
+    //      interned_string is a canonical, immortal string instance owned by the intern table.
+    //          Both encodings are computed up front, and it is never freed.
+    //
+    //      block_string is a shared, immutable string created by a batch call. All strings from
+    //          one batch live in a single string_block allocation with a shared reference count.
+    //
     // cache_string holds is *NOT* a sub-class of string_base.
     //     It holds string buffer data when a raw buffer is requested in a different
     //     encoding than that of the original string_rerefence/heap_string
@@ -115,6 +125,8 @@ namespace xlang::impl
         char_type const* get_buffer() const noexcept;
 
         bool is_reference() const noexcept;
+        bool is_interned() const noexcept;
+        bool is_block() const noexcept;
         bool is_preallocated_buffer() const noexcept;
         bool is_utf8() const noexcept;
         bool has_alternate() const noexcept;
@@ -167,6 +179,16 @@ namespace xlang::impl
         return (flags & string_flags::is_reference) != string_flags::none;
     }
 
+    inline bool string_base::is_interned() const noexcept
+    {
+        return (flags & string_flags::is_interned) != string_flags::none;
+    }
+
+    inline bool string_base::is_block() const noexcept
+    {
+        return (flags & string_flags::is_block) != string_flags::none;
+    }
+
     inline bool string_base::is_preallocated_buffer() const noexcept
     {
         return (flags & string_flags::reserved_for_preallocated_string_buffer) == string_flags::is_preallocated_string_buffer;
@@ -2,6 +2,7 @@
 
 #include "string_base.h"
 #include "cache_string.h"
+#include "string_statistics.h"
 
 namespace xlang::impl
 {
@@ -47,6 +48,7 @@ namespace xlang::impl
         string_reference* header
     ) noexcept
     {
+        record_string_reference_created();
         return (new (header) string_reference{ source_string, length });
     }
 
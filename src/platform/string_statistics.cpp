@@ -0,0 +1,26 @@
+#include "string_statistics.h"
+
+namespace xlang::impl
+{
+    string_statistics_shard string_statistics_shards[string_statistics_shard_count];
+
+    namespace
+    {
+        std::atomic<uint32_t> next_string_statistics_shard{ 0 };
+    }
+
+    uint32_t assign_string_statistics_shard() noexcept
+    {
+        return next_string_statistics_shard.fetch_add(1, std::memory_order_relaxed) % string_statistics_shard_count;
+    }
+
+    int64_t get_string_statistic(string_statistic statistic) noexcept
+    {
+        int64_t result{};
+        for (auto const& shard : string_statistics_shards)
+        {
+            result += shard.values[static_cast<size_t>(statistic)].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+}
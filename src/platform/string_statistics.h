@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include "pal_internal.h"
+
+namespace xlang::impl
+{
+    enum class string_statistic : uint32_t
+    {
+        live_utf8_strings,
+        live_utf16_strings,
+        bytes_held,
+        utf8_caches_created,
+        utf16_caches_created,
+        heap_strings_created,
+        reference_strings_created,
+        batch_strings_created,
+        interned_strings_created,
+        count
+    };
+
+    // String statistics are kept in a fixed set of cache line sized shards. Each thread is assigned a
+    // shard the first time it updates a statistic, so updates are uncontended relaxed increments in the
+    // common case. Values are signed, since a string may be created on one shard and released on
+    // another; only the sum across all shards is meaningful.
+    struct alignas(64) string_statistics_shard
+    {
+        std::atomic<int64_t> values[static_cast<size_t>(string_statistic::count)];
+
+        void add(string_statistic statistic, int64_t value) noexcept
+        {
+            values[static_cast<size_t>(statistic)].fetch_add(value, std::memory_order_relaxed);
+        }
+    };
+
+    inline constexpr uint32_t string_statistics_shard_count = 32;
+    inline constexpr uint32_t unassigned_string_statistics_shard = ~0u;
+
+    extern string_statistics_shard string_statistics_shards[string_statistics_shard_count];
+    inline thread_local uint32_t current_string_statistics_shard_index{ unassigned_string_statistics_shard };
+
+    uint32_t assign_string_statistics_shard() noexcept;
+    int64_t get_string_statistic(string_statistic statistic) noexcept;
+
+    inline string_statistics_shard& current_string_statistics_shard() noexcept
+    {
+        uint32_t index = current_string_statistics_shard_index;
+        if (index == unassigned_string_statistics_shard)
+        {
+            index = assign_string_statistics_shard();
+            current_string_statistics_shard_index = index;
+        }
+        return string_statistics_shards[index];
+    }
+
+    inline string_statistic live_string_statistic(bool utf8) noexcept
+    {
+        return utf8 ? string_statistic::live_utf8_strings : string_statistic::live_utf16_strings;
+    }
+
+    inline void record_strings_created(string_statistic kind, bool utf8, int64_t count, int64_t bytes) noexcept
+    {
+        auto& shard = current_string_statistics_shard();
+        shard.add(kind, count);
+        shard.add(live_string_statistic(utf8), count);
+        shard.add(string_statistic::bytes_held, bytes);
+    }
+
+    inline void record_strings_destroyed(bool utf8, int64_t count, int64_t bytes) noexcept
+    {
+        auto& shard = current_string_statistics_shard();
+        shard.add(live_string_statistic(utf8), -count);
+        shard.add(string_statistic::bytes_held, -bytes);
+    }
+
+    inline void record_string_reference_created() noexcept
+    {
+        current_string_statistics_shard().add(string_statistic::reference_strings_created, 1);
+    }
+
+    // cache_utf8 is the encoding of the cache itself, i.e. a UTF-8 cache holds the transcoded form of a UTF-16 string.
+    inline void record_cache_created(bool cache_utf8, int64_t bytes) noexcept
+    {
+        auto& shard = current_string_statistics_shard();
+        shard.add(cache_utf8 ? string_statistic::utf8_caches_created : string_statistic::utf16_caches_created, 1);
+        shard.add(string_statistic::bytes_held, bytes);
+    }
+
+    inline void record_bytes_released(int64_t bytes) noexcept
+    {
+        current_string_statistics_shard().add(string_statistic::bytes_held, -bytes);
+    }
+}
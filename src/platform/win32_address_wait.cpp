@@ -0,0 +1,14 @@
+#include "win32_pal_internal.h"
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wait_on_address(
+    void const* address,
+    uint32_t compare_value
+) noexcept
+{
+    ::WaitOnAddress(const_cast<void volatile*>(address), &compare_value, sizeof(compare_value), INFINITE);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_wake_by_address_all(void const* address) noexcept
+{
+    ::WakeByAddressAll(const_cast<void*>(address));
+}
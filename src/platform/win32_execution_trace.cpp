@@ -0,0 +1,38 @@
+#include "win32_pal_internal.h"
+#include "platform_execution_trace.h"
+#include <cstdio>
+#include <iterator>
+
+namespace xlang::impl
+{
+    uint32_t capture_stack_trace(void** frames, uint32_t max_frames, uint32_t skip_frames) noexcept
+    {
+        return ::RtlCaptureStackBackTrace(skip_frames + 1, max_frames, frames, nullptr);
+    }
+
+    std::string describe_stack_frame(void const* address)
+    {
+        // Symbol names require dbghelp, which is not safe to load on arbitrary threads. Module
+        // relative addresses are enough to symbolize offline.
+        char text[32];
+        HMODULE module{};
+        char module_path[MAX_PATH];
+        if (!::GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(address), &module) ||
+            !::GetModuleFileNameA(module, module_path, static_cast<DWORD>(std::size(module_path))))
+        {
+            std::snprintf(text, std::size(text), "%p", address);
+            return text;
+        }
+
+        std::string result{ module_path };
+        auto const slash = result.find_last_of("\\/");
+        if (slash != result.npos)
+        {
+            result.erase(0, slash + 1);
+        }
+
+        std::snprintf(text, std::size(text), "+0x%zx", static_cast<size_t>(static_cast<char const*>(address) - reinterpret_cast<char const*>(module)));
+        result += text;
+        return result;
+    }
+}
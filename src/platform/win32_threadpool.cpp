@@ -0,0 +1,207 @@
+#include "win32_pal_internal.h"
+#include <memory>
+
+namespace xlang::impl
+{
+    namespace
+    {
+        struct work_item
+        {
+            xlang_threadpool_callback callback;
+            void* context;
+        };
+
+        struct threadpool_timer
+        {
+            xlang_threadpool_callback callback;
+            void* context;
+            PTP_TIMER timer{};
+        };
+
+        struct threadpool_wait
+        {
+            xlang_threadpool_wait_callback callback;
+            void* context;
+            PTP_WAIT wait{};
+        };
+
+        // The timer or wait whose callback is running on this thread. Closing an object from within its
+        // own callback clears this, and the callback trampoline frees the object once the callback returns,
+        // since waiting for the callback to finish from within it would deadlock.
+        thread_local void* running_callback_object{};
+
+        template <typename Run>
+        bool run_callback_object(void* object, Run const& run) noexcept
+        {
+            void* const previous = std::exchange(running_callback_object, object);
+            run();
+            bool const closed = running_callback_object != object;
+            running_callback_object = previous;
+            return closed;
+        }
+
+        FILETIME to_relative_file_time(int64_t relative_time) noexcept
+        {
+            // Negative file times are relative to the current time.
+            uint64_t const value = static_cast<uint64_t>(-relative_time);
+            return { static_cast<DWORD>(value), static_cast<DWORD>(value >> 32) };
+        }
+
+        void CALLBACK run_work_item(PTP_CALLBACK_INSTANCE, void* context) noexcept
+        {
+            std::unique_ptr<work_item> const item{ static_cast<work_item*>(context) };
+            item->callback(item->context);
+        }
+
+        void CALLBACK run_timer_callback(PTP_CALLBACK_INSTANCE, void* context, PTP_TIMER) noexcept
+        {
+            auto const timer = static_cast<threadpool_timer*>(context);
+            if (run_callback_object(timer, [timer] { timer->callback(timer->context); }))
+            {
+                delete timer;
+            }
+        }
+
+        void CALLBACK run_wait_callback(PTP_CALLBACK_INSTANCE, void* context, PTP_WAIT, TP_WAIT_RESULT result) noexcept
+        {
+            auto const wait = static_cast<threadpool_wait*>(context);
+            bool const signaled = result == WAIT_OBJECT_0;
+            if (run_callback_object(wait, [wait, signaled] { wait->callback(wait->context, signaled); }))
+            {
+                delete wait;
+            }
+        }
+    }
+}
+
+using namespace xlang::impl;
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_submit_threadpool_callback(
+    xlang_threadpool_callback callback,
+    void* context
+) noexcept
+try
+{
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    auto item = std::make_unique<work_item>(work_item{ callback, context });
+    check_bool(::TrySubmitThreadpoolCallback(run_work_item, item.get(), nullptr));
+    item.release();
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_timer(
+    xlang_threadpool_callback callback,
+    void* context,
+    xlang_threadpool_timer* timer
+) noexcept
+try
+{
+    *timer = nullptr;
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    auto object = std::make_unique<threadpool_timer>(threadpool_timer{ callback, context });
+    object->timer = ::CreateThreadpoolTimer(run_timer_callback, object.get(), nullptr);
+    check_bool(object->timer);
+    *timer = reinterpret_cast<xlang_threadpool_timer>(object.release());
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_timer(
+    xlang_threadpool_timer timer,
+    int64_t due_time
+) noexcept
+{
+    FILETIME due = to_relative_file_time(std::max<int64_t>(due_time, 0));
+    ::SetThreadpoolTimer(reinterpret_cast<threadpool_timer*>(timer)->timer, &due, 0, 0);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_timer(xlang_threadpool_timer timer) noexcept
+{
+    auto const object = reinterpret_cast<threadpool_timer*>(timer);
+    if (!object)
+    {
+        return;
+    }
+
+    ::SetThreadpoolTimer(object->timer, nullptr, 0, 0);
+    if (running_callback_object == object)
+    {
+        running_callback_object = nullptr;
+        ::CloseThreadpoolTimer(object->timer);
+        return;
+    }
+
+    ::WaitForThreadpoolTimerCallbacks(object->timer, TRUE);
+    ::CloseThreadpoolTimer(object->timer);
+    delete object;
+}
+
+XLANG_PAL_EXPORT xlang_error_info* XLANG_CALL xlang_create_threadpool_wait(
+    xlang_threadpool_wait_callback callback,
+    void* context,
+    xlang_threadpool_wait* wait
+) noexcept
+try
+{
+    *wait = nullptr;
+    if (!callback)
+    {
+        xlang::throw_result(xlang_result::pointer);
+    }
+
+    auto object = std::make_unique<threadpool_wait>(threadpool_wait{ callback, context });
+    object->wait = ::CreateThreadpoolWait(run_wait_callback, object.get(), nullptr);
+    check_bool(object->wait);
+    *wait = reinterpret_cast<xlang_threadpool_wait>(object.release());
+    return nullptr;
+}
+catch (...)
+{
+    return xlang::to_result();
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_set_threadpool_wait(
+    xlang_threadpool_wait wait,
+    void* handle,
+    int64_t timeout
+) noexcept
+{
+    FILETIME due = to_relative_file_time(timeout);
+    ::SetThreadpoolWait(reinterpret_cast<threadpool_wait*>(wait)->wait, handle, timeout > 0 ? &due : nullptr);
+}
+
+XLANG_PAL_EXPORT void XLANG_CALL xlang_close_threadpool_wait(xlang_threadpool_wait wait) noexcept
+{
+    auto const object = reinterpret_cast<threadpool_wait*>(wait);
+    if (!object)
+    {
+        return;
+    }
+
+    ::SetThreadpoolWait(object->wait, nullptr, nullptr);
+    if (running_callback_object == object)
+    {
+        running_callback_object = nullptr;
+        ::CloseThreadpoolWait(object->wait);
+        return;
+    }
+
+    ::WaitForThreadpoolWaitCallbacks(object->wait, TRUE);
+    ::CloseThreadpoolWait(object->wait);
+    delete object;
+}
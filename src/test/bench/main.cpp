@@ -0,0 +1,371 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+
+#include "metadata_generator.h"
+
+using namespace std::chrono;
+using namespace std::experimental::filesystem;
+using namespace std::literals;
+using namespace xlang;
+using namespace xlang::bench;
+using namespace xlang::meta::reader;
+using namespace xlang::text;
+
+namespace
+{
+    struct writer : writer_base<writer>
+    {
+    };
+
+    struct usage_exception {};
+
+    static constexpr cmd::option options[]
+    {
+        { "input", 0, cmd::option::no_max, "<spec>", "Metadata to measure instead of a generated corpus" },
+        { "output", 0, 1, "<path>", "Location of the generated corpus and tool output (defaults to bench)" },
+        { "results", 0, 1, "<path>", "Location of the JSON results file (defaults to <output>/results.json)" },
+        { "namespaces", 0, 1, "<count>", "Number of generated namespaces (defaults to 100)" },
+        { "types", 0, 1, "<count>", "Number of generated types per namespace (defaults to 20)" },
+        { "methods", 0, 1, "<count>", "Number of methods, fields or enum values per type (defaults to 8)" },
+        { "generics", 0, 1, "<count>", "Number of methods per interface returning a generic instantiation (defaults to 2)" },
+        { "attributes", 0, 1, "<count>", "Number of custom attributes per type (defaults to 2)" },
+        { "seed", 0, 1, "<value>", "Seed for the generated corpus (defaults to 1)" },
+        { "iterations", 0, 1, "<count>", "Number of timed runs of each benchmark (defaults to 5)" },
+        { "generate", 0, 0, {}, "Only generate the corpus" },
+        { "abi", 0, 1, "<path>", "Path to the abi tool to measure end to end" },
+        { "cppxlang", 0, 1, "<path>", "Path to the cppxlang tool to measure end to end" },
+        { "cs", 0, 1, "<path>", "Path to the cswinrt tool to measure end to end" },
+        { "help", 0, 0, {}, "Show detailed help" },
+    };
+
+    void print_usage(writer& w)
+    {
+        static auto printOption = [](writer& w, cmd::option const& opt)
+        {
+            w.write_printf("  %-24s%s\n", w.write_temp("-% %", opt.name, opt.arg).c_str(), std::string{ opt.desc }.c_str());
+        };
+
+        auto format = R"(
+bench_meta_reader [options...]
+
+Measures the metadata reader and, optionally, the code generators against a generated or an existing corpus.
+
+Options:
+
+%)";
+        w.write(format, bind_each(printOption, options));
+    }
+
+    struct benchmark
+    {
+        std::string name;
+        std::size_t items{};
+        std::vector<int64_t> samples; // Nanoseconds
+    };
+
+    // Runs 'f' once to warm up, and then 'iterations' timed times. 'f' returns the number of items that it processed,
+    // which is reported alongside the timings and keeps the work from being optimized away
+    template <typename F>
+    benchmark measure(std::string_view const& name, uint32_t const iterations, F&& f)
+    {
+        benchmark result{ std::string{ name } };
+        result.items = f();
+
+        for (uint32_t i{}; i < iterations; ++i)
+        {
+            auto const start = steady_clock::now();
+            auto const items = f();
+            result.samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+
+            if (items != result.items)
+            {
+                throw_invalid("Benchmark '", name, "' is not deterministic");
+            }
+        }
+
+        std::sort(result.samples.begin(), result.samples.end());
+        return result;
+    }
+
+    std::size_t run_tool(std::string const& command)
+    {
+        if (std::system(command.c_str()) != 0)
+        {
+            throw_invalid("Command '", command, "' failed");
+        }
+
+        return 1;
+    }
+
+    std::string quote(std::string_view const& value)
+    {
+        std::string result{ '"' };
+
+        for (auto c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+
+            result += c;
+        }
+
+        result += '"';
+        return result;
+    }
+
+    uint32_t parse(cmd::reader const& args, std::string_view const& name, uint32_t const default_value)
+    {
+        return args.exists(name) ? static_cast<uint32_t>(std::stoul(args.value(name))) : default_value;
+    }
+
+    void write_results(std::string const& filename, corpus_options const& corpus, std::vector<std::string> const& inputs, uint32_t const iterations, std::vector<benchmark> const& results)
+    {
+        writer w;
+        w.write("{\n");
+
+        if (inputs.empty())
+        {
+            w.write(R"(    "corpus": { "namespaces": %, "types": %, "methods": %, "generics": %, "attributes": %, "seed": % },
+)",
+                corpus.namespaces, corpus.types, corpus.methods, corpus.generics, corpus.attributes, corpus.seed);
+        }
+        else
+        {
+            std::vector<std::string> quoted;
+
+            for (auto&& input : inputs)
+            {
+                quoted.push_back(quote(input));
+            }
+
+            w.write("    \"inputs\": [ % ],\n", bind_list(", ", quoted));
+        }
+
+        w.write("    \"iterations\": %,\n    \"benchmarks\": [\n", iterations);
+
+        for (std::size_t i{}; i < results.size(); ++i)
+        {
+            auto const& result = results[i];
+            auto const total = std::accumulate(result.samples.begin(), result.samples.end(), int64_t{});
+            auto const count = static_cast<int64_t>((std::max)(std::size_t{ 1 }, result.samples.size()));
+
+            w.write(R"(        { "name": "%", "items": %, "min_ns": %, "median_ns": %, "mean_ns": % }%
+)",
+                result.name,
+                static_cast<uint64_t>(result.items),
+                result.samples.empty() ? 0 : result.samples.front(),
+                result.samples.empty() ? 0 : result.samples[result.samples.size() / 2],
+                total / count,
+                i + 1 < results.size() ? "," : "");
+        }
+
+        w.write("    ]\n}\n");
+        w.flush_to_file(filename);
+    }
+
+    int run(int const argc, char** argv)
+    {
+        writer w;
+        cmd::reader args{ argc, argv, options };
+
+        if (args.exists("help"))
+        {
+            throw usage_exception{};
+        }
+
+        corpus_options corpus;
+        corpus.namespaces = parse(args, "namespaces", corpus.namespaces);
+        corpus.types = parse(args, "types", corpus.types);
+        corpus.methods = parse(args, "methods", corpus.methods);
+        corpus.generics = parse(args, "generics", corpus.generics);
+        corpus.attributes = parse(args, "attributes", corpus.attributes);
+        corpus.seed = args.exists("seed") ? std::stoull(args.value("seed")) : corpus.seed;
+        auto const iterations = parse(args, "iterations", 5);
+
+        auto const output = absolute(args.value("output", "bench"));
+        create_directories(output);
+
+        std::vector<benchmark> results;
+        std::vector<std::string> inputs;
+
+        for (auto&& file : args.files("input", database::is_database))
+        {
+            inputs.push_back(file);
+        }
+
+        std::vector<std::string> files{ inputs };
+
+        if (files.empty())
+        {
+            results.push_back(measure("generate", iterations, [&]
+            {
+                return metadata_generator{ corpus }.generate().size();
+            }));
+
+            auto const winmd = (output / "Synthetic.winmd").string();
+            auto const bytes = metadata_generator{ corpus }.generate();
+            std::ofstream file{ winmd, std::ios::out | std::ios::binary };
+            file.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            file.close();
+            files.push_back(winmd);
+            w.write("corpus: % (% bytes)\n", winmd, static_cast<uint64_t>(bytes.size()));
+            w.flush_to_console();
+
+            if (args.exists("generate"))
+            {
+                return 0;
+            }
+        }
+
+        results.push_back(measure("database_open", iterations, [&]
+        {
+            std::size_t types{};
+
+            for (auto&& file : files)
+            {
+                database db{ file };
+                types += db.TypeDef.size();
+            }
+
+            return types;
+        }));
+
+        results.push_back(measure("cache_construction", iterations, [&]
+        {
+            cache c{ files };
+            return c.namespaces().size();
+        }));
+
+        // The remaining reader benchmarks share a single cache, which is needed to resolve enum attribute arguments
+        cache c{ files };
+
+        results.push_back(measure("attribute_lookup", iterations, [&]
+        {
+            std::size_t found{};
+
+            for (auto&& db : c.databases())
+            {
+                for (auto&& type : db.TypeDef)
+                {
+                    found += static_cast<bool>(get_attribute(type, "Windows.Foundation.Metadata"sv, "GuidAttribute"sv));
+                    found += static_cast<bool>(get_attribute(type, "Windows.Foundation.Metadata"sv, "ContractVersionAttribute"sv));
+                }
+
+                for (auto&& impl : db.InterfaceImpl)
+                {
+                    found += static_cast<bool>(get_attribute(impl, "Windows.Foundation.Metadata"sv, "DefaultAttribute"sv));
+                }
+            }
+
+            return found;
+        }));
+
+        results.push_back(measure("signature_decode", iterations, [&]
+        {
+            std::size_t decoded{};
+
+            for (auto&& db : c.databases())
+            {
+                for (auto&& method : db.MethodDef)
+                {
+                    auto const sig = method.Signature();
+                    decoded += 1 + std::distance(sig.Params().first, sig.Params().second);
+                }
+
+                for (auto&& field : db.Field)
+                {
+                    decoded += 1 + field.Signature().Type().is_szarray();
+                }
+
+                for (auto&& spec : db.TypeSpec)
+                {
+                    decoded += spec.Signature().GenericTypeInst().GenericArgCount();
+                }
+            }
+
+            return decoded;
+        }));
+
+        results.push_back(measure("attribute_decode", iterations, [&]
+        {
+            std::size_t decoded{};
+
+            for (auto&& db : c.databases())
+            {
+                for (auto&& attr : db.CustomAttribute)
+                {
+                    decoded += attr.Value().FixedArgs().size();
+                }
+            }
+
+            return decoded;
+        }));
+
+        std::string input_args;
+
+        for (auto&& file : files)
+        {
+            input_args += " -input " + quote(file);
+        }
+
+        auto tool = [&](std::string_view const& name, std::string const& extra_args = {})
+        {
+            if (!args.exists(name))
+            {
+                return;
+            }
+
+            auto const tool_output = output / std::string{ name };
+            create_directories(tool_output);
+            auto const command = quote(args.value(name)) + input_args + " -output " + quote(tool_output.string()) + extra_args;
+            results.push_back(measure(name, iterations, [&] { return run_tool(command); }));
+        };
+
+        tool("abi");
+        tool("cppxlang");
+        tool("cs");
+
+        for (auto&& result : results)
+        {
+            w.write_printf("%-20s %12.3f ms (min %.3f ms, %llu items)\n",
+                result.name.c_str(),
+                result.samples.empty() ? 0.0 : result.samples[result.samples.size() / 2] / 1e6,
+                result.samples.empty() ? 0.0 : result.samples.front() / 1e6,
+                static_cast<unsigned long long>(result.items));
+        }
+
+        auto const results_file = args.value("results", (output / "results.json").string());
+        write_results(results_file, corpus, inputs, iterations, results);
+        w.write("results: %\n", results_file);
+        w.flush_to_console();
+        return 0;
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    writer w;
+
+    try
+    {
+        return run(argc, argv);
+    }
+    catch (usage_exception const&)
+    {
+        print_usage(w);
+    }
+    catch (std::exception const& e)
+    {
+        w.write("%\n", e.what());
+    }
+
+    w.flush_to_console();
+    return 1;
+}
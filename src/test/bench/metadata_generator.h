@@ -0,0 +1,752 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "meta_reader.h"
+#include "meta_writer.h"
+
+namespace xlang::bench
+{
+    using namespace xlang::meta::reader;
+    using xlang::meta::writer::encode_index;
+
+    struct corpus_options
+    {
+        uint32_t namespaces{ 100 };
+        uint32_t types{ 20 }; // Per namespace
+        uint32_t methods{ 8 }; // Members per type: interface methods, enum values and struct fields
+        uint32_t generics{ 2 }; // Interface methods that return a generic instantiation
+        uint32_t attributes{ 2 }; // Custom attributes per type, beyond the GUID and default interface markers
+        uint64_t seed{ 1 };
+    };
+
+    // splitmix64, so that the same seed produces the same corpus everywhere
+    struct random
+    {
+        explicit random(uint64_t const seed) noexcept : m_state{ seed }
+        {
+        }
+
+        uint64_t next() noexcept
+        {
+            uint64_t value = (m_state += 0x9e3779b97f4a7c15);
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+            return value ^ (value >> 31);
+        }
+
+        uint32_t next(uint32_t const bound) noexcept
+        {
+            XLANG_ASSERT(bound);
+            return static_cast<uint32_t>(next() % bound);
+        }
+
+    private:
+        uint64_t m_state;
+    };
+}
+
+namespace xlang::bench::impl
+{
+    struct blob_builder
+    {
+        std::vector<uint8_t> data;
+
+        void u8(uint8_t const value)
+        {
+            data.push_back(value);
+        }
+
+        void u16(uint16_t const value)
+        {
+            u8(static_cast<uint8_t>(value));
+            u8(static_cast<uint8_t>(value >> 8));
+        }
+
+        void u32(uint32_t const value)
+        {
+            u16(static_cast<uint16_t>(value));
+            u16(static_cast<uint16_t>(value >> 16));
+        }
+
+        void element(ElementType const type)
+        {
+            u8(static_cast<uint8_t>(type));
+        }
+
+        void compressed(uint32_t const value)
+        {
+            if (value < 0x80)
+            {
+                u8(static_cast<uint8_t>(value));
+            }
+            else if (value < 0x4000)
+            {
+                u8(static_cast<uint8_t>(0x80 | (value >> 8)));
+                u8(static_cast<uint8_t>(value));
+            }
+            else
+            {
+                XLANG_ASSERT(value < 0x20000000);
+                u8(static_cast<uint8_t>(0xc0 | (value >> 24)));
+                u8(static_cast<uint8_t>(value >> 16));
+                u8(static_cast<uint8_t>(value >> 8));
+                u8(static_cast<uint8_t>(value));
+            }
+        }
+
+        // SerString, as used by custom attribute values
+        void string(std::string_view const& value)
+        {
+            compressed(static_cast<uint32_t>(value.size()));
+            data.insert(data.end(), value.begin(), value.end());
+        }
+    };
+
+    // A signature type: a primitive element type, a (possibly value) type reference, a generic type parameter or an
+    // instantiation of a generic interface
+    struct type_sig
+    {
+        ElementType element;
+        uint32_t type{}; // TypeDefOrRef, or the generic parameter number for 'Var'
+        std::vector<type_sig> arguments;
+
+        void write(blob_builder& b) const
+        {
+            switch (element)
+            {
+            case ElementType::Class:
+            case ElementType::ValueType:
+                b.element(element);
+                b.compressed(type);
+                break;
+
+            case ElementType::Var:
+                b.element(element);
+                b.compressed(type);
+                break;
+
+            case ElementType::GenericInst:
+                b.element(element);
+                b.element(ElementType::Class);
+                b.compressed(type);
+                b.compressed(static_cast<uint32_t>(arguments.size()));
+
+                for (auto&& arg : arguments)
+                {
+                    arg.write(b);
+                }
+                break;
+
+            default:
+                b.element(element);
+                break;
+            }
+        }
+    };
+}
+
+namespace xlang::bench
+{
+    // Generates a winmd that looks like a large Windows SDK: a handful of API contracts, the generic collection
+    // interfaces from 'Windows.Foundation.Collections' and a set of namespaces with enums, structs, interfaces, delegates
+    // and runtime classes that refer to types in earlier namespaces. The output only depends on the options
+    struct metadata_generator
+    {
+        explicit metadata_generator(corpus_options const& options) : m_options{ options }, m_random{ options.seed }
+        {
+        }
+
+        std::vector<uint8_t> generate()
+        {
+            write_prologue();
+            write_generic_interfaces();
+            write_contracts();
+
+            for (uint32_t ns{}; ns < m_options.namespaces; ++ns)
+            {
+                write_namespace(ns);
+            }
+
+            meta::writer::pe_writer writer;
+            writer.time_date_stamp(static_cast<uint32_t>(m_options.seed));
+            m_builder.save(writer);
+            return writer.save_to_memory();
+        }
+
+    private:
+        using type_sig = impl::type_sig;
+
+        struct generic_interface
+        {
+            uint32_t type{}; // TypeDef row
+            uint32_t arity{};
+        };
+
+        struct method
+        {
+            std::string name;
+            std::optional<type_sig> result;
+            std::vector<type_sig> params;
+        };
+
+        static constexpr uint32_t type_public{ 0x1 };
+        static constexpr uint32_t type_sequential_layout{ 0x8 };
+        static constexpr uint32_t type_interface{ 0x20 };
+        static constexpr uint32_t type_abstract{ 0x80 };
+        static constexpr uint32_t type_sealed{ 0x100 };
+        static constexpr uint32_t type_windows_runtime{ 0x4000 };
+
+        static constexpr uint32_t field_public{ 0x6 };
+        static constexpr uint32_t field_constant{ 0x10 | 0x40 | 0x8000 }; // Static | Literal | HasDefault
+        static constexpr uint32_t field_special_name{ 0x200 | 0x400 }; // SpecialName | RTSpecialName
+
+        static constexpr uint32_t method_abstract{ 0x6 | 0x40 | 0x80 | 0x100 | 0x400 }; // Public | Virtual | HideBySig | NewSlot | Abstract
+        static constexpr uint32_t method_invoke{ 0x6 | 0x40 | 0x80 | 0x100 }; // Public | Virtual | HideBySig | NewSlot
+        static constexpr uint32_t method_constructor{ 0x1 | 0x80 | 0x800 | 0x1000 }; // Private | HideBySig | SpecialName | RTSpecialName
+        static constexpr uint32_t method_runtime{ 0x3 };
+
+        static constexpr uint32_t param_in{ 0x1 };
+        static constexpr uint32_t param_out{ 0x2 };
+
+        static type_sig primitive(ElementType const type)
+        {
+            return { type };
+        }
+
+        static type_sig type_def(uint32_t const row, bool const value_type)
+        {
+            return { value_type ? ElementType::ValueType : ElementType::Class, encode_index(TypeDefOrRef::TypeDef, row) };
+        }
+
+        static type_sig generic_param(uint32_t const number)
+        {
+            return { ElementType::Var, number };
+        }
+
+        static type_sig instantiate(generic_interface const& generic, std::vector<type_sig> arguments)
+        {
+            XLANG_ASSERT(generic.arity == arguments.size());
+            return { ElementType::GenericInst, encode_index(TypeDefOrRef::TypeDef, generic.type), std::move(arguments) };
+        }
+
+        static uint32_t next_row(meta::writer::table_builder const& table) noexcept
+        {
+            return table.size() + 1;
+        }
+
+        uint32_t type_ref(uint32_t const scope, std::string_view const& type_namespace, std::string_view const& name)
+        {
+            return m_builder.TypeRef.add({ encode_index(ResolutionScope::AssemblyRef, scope), m_builder.string(name), m_builder.string(type_namespace) });
+        }
+
+        uint32_t attribute_constructor(std::string_view const& name, std::vector<type_sig> const& params, std::string_view const& type_namespace = "Windows.Foundation.Metadata")
+        {
+            auto const type = type_ref(m_mscorlib, type_namespace, name);
+            impl::blob_builder sig;
+            sig.u8(0x20); // HASTHIS
+            sig.compressed(static_cast<uint32_t>(params.size()));
+            sig.element(ElementType::Void);
+
+            for (auto&& param : params)
+            {
+                param.write(sig);
+            }
+
+            return m_builder.MemberRef.add({ encode_index(MemberRefParent::TypeRef, type), m_builder.string(".ctor"), m_builder.blob(sig.data) });
+        }
+
+        template <typename F>
+        void add_attribute(uint32_t const parent, uint32_t const constructor, F&& write_arguments)
+        {
+            impl::blob_builder value;
+            value.u16(1); // Prolog
+            write_arguments(value);
+            value.u16(0); // NumNamed
+            m_builder.CustomAttribute.add({ parent, encode_index(CustomAttributeType::MemberRef, constructor), m_builder.blob(value.data) });
+        }
+
+        // The Windows SDK tools (abi, cs) and the xlang projection (cppxlang) look for the GUID in different namespaces
+        void add_guid(uint32_t const parent)
+        {
+            auto const first = m_random.next();
+            auto const second = m_random.next();
+
+            auto write = [&](impl::blob_builder& b)
+            {
+                b.u32(static_cast<uint32_t>(first));
+                b.u16(static_cast<uint16_t>(first >> 32));
+                b.u16(static_cast<uint16_t>(first >> 48));
+
+                for (uint32_t i{}; i < 8; ++i)
+                {
+                    b.u8(static_cast<uint8_t>(second >> (i * 8)));
+                }
+            };
+
+            add_attribute(parent, m_guid_constructor, write);
+            add_attribute(parent, m_xlang_guid_constructor, write);
+        }
+
+        void add_contract_version(uint32_t const parent, uint32_t const contract, uint32_t const version)
+        {
+            add_attribute(parent, m_contract_version_constructor, [&](impl::blob_builder& b)
+            {
+                b.string(m_contracts[contract]);
+                b.u32(version << 16);
+            });
+        }
+
+        void add_deprecated(uint32_t const parent, uint32_t const contract, uint32_t const version)
+        {
+            add_attribute(parent, m_deprecated_constructor, [&](impl::blob_builder& b)
+            {
+                b.string("This API has been deprecated.");
+                b.u32(0); // DeprecationType.Deprecate
+                b.u32(version << 16);
+                b.string(m_contracts[contract]);
+            });
+        }
+
+        // The first attribute is always the contract version, the rest are a mix of the attributes that the SDK uses
+        void add_type_attributes(uint32_t const type, uint32_t const contract)
+        {
+            auto const parent = encode_index(HasCustomAttribute::TypeDef, type);
+            auto const version = 1 + m_random.next(10);
+
+            for (uint32_t i{}; i < m_options.attributes; ++i)
+            {
+                if (i == 0)
+                {
+                    add_contract_version(parent, contract, version);
+                }
+                else if (i == 1 && m_random.next(4) == 0)
+                {
+                    add_deprecated(parent, contract, version + 1);
+                }
+                else if (i == 1)
+                {
+                    add_attribute(parent, m_web_host_hidden_constructor, [](auto&&) {});
+                }
+                else
+                {
+                    add_attribute(parent, m_version_constructor, [&](impl::blob_builder& b) { b.u32(i); });
+                }
+            }
+        }
+
+        void add_member_attributes(uint32_t const parent, uint32_t const contract)
+        {
+            if (m_options.attributes > 0)
+            {
+                add_contract_version(parent, contract, 1 + m_random.next(10));
+            }
+
+            if (m_options.attributes > 1 && m_random.next(8) == 0)
+            {
+                add_deprecated(parent, contract, 1 + m_random.next(10));
+            }
+        }
+
+        uint32_t add_type(uint32_t const flags, std::string_view const& type_namespace, std::string_view const& name, uint32_t const extends, uint32_t const fields, uint32_t const methods)
+        {
+            return m_builder.TypeDef.add({ flags, m_builder.string(name), m_builder.string(type_namespace), extends, fields, methods });
+        }
+
+        uint32_t add_method(uint32_t const flags, method const& m)
+        {
+            impl::blob_builder sig;
+            sig.u8(0x20); // HASTHIS
+            sig.compressed(static_cast<uint32_t>(m.params.size()));
+
+            if (m.result)
+            {
+                m.result->write(sig);
+            }
+            else
+            {
+                sig.element(ElementType::Void);
+            }
+
+            for (auto&& param : m.params)
+            {
+                param.write(sig);
+            }
+
+            auto const first_param = next_row(m_builder.Param);
+
+            if (m.result)
+            {
+                m_builder.Param.add({ param_out, 0, m_builder.string("result") });
+            }
+
+            for (uint32_t i{}; i < m.params.size(); ++i)
+            {
+                m_builder.Param.add({ param_in, i + 1, m_builder.string(i ? "value" + std::to_string(i) : "value") });
+            }
+
+            return m_builder.MethodDef.add({ 0, method_runtime, flags, m_builder.string(m.name), m_builder.blob(sig.data), first_param });
+        }
+
+        uint32_t add_interface(std::string_view const& type_namespace, std::string_view const& name, std::vector<method> const& methods, uint32_t const arity = 0)
+        {
+            auto const first_method = next_row(m_builder.MethodDef);
+
+            for (auto&& m : methods)
+            {
+                add_method(method_abstract, m);
+            }
+
+            auto const type = add_type(type_public | type_interface | type_abstract | type_windows_runtime, type_namespace, name, 0, next_row(m_builder.Field), first_method);
+            add_guid(encode_index(HasCustomAttribute::TypeDef, type));
+
+            for (uint32_t i{}; i < arity; ++i)
+            {
+                m_builder.GenericParam.add({ i, 0, encode_index(TypeOrMethodDef::TypeDef, type), m_builder.string(i ? "V" : "T") });
+            }
+
+            return type;
+        }
+
+        uint32_t add_interface_impl(uint32_t const type, type_sig const& iface)
+        {
+            uint32_t value{};
+
+            if (iface.element == ElementType::GenericInst)
+            {
+                impl::blob_builder sig;
+                iface.write(sig);
+                auto const blob = m_builder.blob(sig.data);
+                auto [pos, inserted] = m_type_specs.try_emplace(blob, 0);
+
+                if (inserted)
+                {
+                    pos->second = m_builder.TypeSpec.add({ blob });
+                }
+
+                value = encode_index(TypeDefOrRef::TypeSpec, pos->second);
+            }
+            else
+            {
+                value = iface.type;
+            }
+
+            return m_builder.InterfaceImpl.add({ type, value });
+        }
+
+        void write_prologue()
+        {
+            std::array<uint8_t, 16> mvid{};
+
+            for (auto&& byte : mvid)
+            {
+                byte = static_cast<uint8_t>(m_random.next());
+            }
+
+            m_builder.Module.add({ 0, m_builder.string("Synthetic.winmd"), m_builder.guid(mvid), 0, 0 });
+            m_builder.Assembly.add({ 0x8004, 0xff, 0xff, 0xff, 0xff, 0x200, 0, m_builder.string("Synthetic"), 0 });
+            m_mscorlib = m_builder.AssemblyRef.add({ 0xff, 0xff, 0xff, 0xff, 0, 0, m_builder.string("mscorlib"), 0, 0 });
+
+            m_object = type_ref(m_mscorlib, "System", "Object");
+            m_value_type = type_ref(m_mscorlib, "System", "ValueType");
+            m_enum = type_ref(m_mscorlib, "System", "Enum");
+            m_delegate = type_ref(m_mscorlib, "System", "MulticastDelegate");
+            auto const system_type = type_ref(m_mscorlib, "System", "Type");
+            add_type(0, {}, "<Module>", 0, 1, 1);
+
+            // The enum that the DeprecatedAttribute constructor takes must be resolvable to decode the attribute
+            auto const deprecation_type = next_row(m_builder.TypeDef);
+            auto const first_field = next_row(m_builder.Field);
+            add_enum_value_field();
+            add_enum_constant(deprecation_type, "Deprecate", 0);
+            add_enum_constant(deprecation_type, "Remove", 1);
+            add_type(type_public | type_sealed | type_windows_runtime, "Synthetic.Metadata", "DeprecationType", encode_index(TypeDefOrRef::TypeRef, m_enum), first_field, next_row(m_builder.MethodDef));
+
+            auto const u1 = primitive(ElementType::U1);
+            auto const u4 = primitive(ElementType::U4);
+            auto const str = primitive(ElementType::String);
+            type_sig const type{ ElementType::Class, encode_index(TypeDefOrRef::TypeRef, system_type) };
+
+            std::vector<type_sig> const guid{ u4, primitive(ElementType::U2), primitive(ElementType::U2), u1, u1, u1, u1, u1, u1, u1, u1 };
+            m_guid_constructor = attribute_constructor("GuidAttribute", guid);
+            m_xlang_guid_constructor = attribute_constructor("GuidAttribute", guid, "Foundation.Metadata");
+            m_contract_version_constructor = attribute_constructor("ContractVersionAttribute", { type, u4 });
+            m_contract_constructor = attribute_constructor("ContractVersionAttribute", { u4 });
+            m_deprecated_constructor = attribute_constructor("DeprecatedAttribute", { str, type_def(deprecation_type, true), u4, str });
+            m_api_contract_constructor = attribute_constructor("ApiContractAttribute", {});
+            m_default_constructor = attribute_constructor("DefaultAttribute", {});
+            m_web_host_hidden_constructor = attribute_constructor("WebHostHiddenAttribute", {});
+            m_version_constructor = attribute_constructor("VersionAttribute", { u4 });
+        }
+
+        void add_enum_value_field()
+        {
+            impl::blob_builder sig;
+            sig.u8(0x6); // FIELD
+            sig.element(ElementType::I4);
+            m_builder.Field.add({ field_public | field_special_name, m_builder.string("value__"), m_builder.blob(sig.data) });
+        }
+
+        uint32_t add_enum_constant(uint32_t const type, std::string_view const& name, int32_t const value)
+        {
+            impl::blob_builder sig;
+            sig.u8(0x6); // FIELD
+            type_def(type, true).write(sig);
+            auto const field = m_builder.Field.add({ field_public | field_constant, m_builder.string(name), m_builder.blob(sig.data) });
+
+            impl::blob_builder constant;
+            constant.u32(static_cast<uint32_t>(value));
+            m_builder.Constant.add({ static_cast<uint32_t>(ConstantType::Int32), encode_index(HasConstant::Field, field), m_builder.blob(constant.data) });
+            return field;
+        }
+
+        void write_generic_interfaces()
+        {
+            std::string_view const foundation{ "Windows.Foundation" };
+            std::string_view const collections{ "Windows.Foundation.Collections" };
+            auto const t = generic_param(0);
+            auto const u = generic_param(1);
+            auto const u4 = primitive(ElementType::U4);
+            auto const boolean = primitive(ElementType::Boolean);
+
+            // Generic interfaces refer to themselves by TypeDef row, which is only known once their methods are written
+            auto self = [&](uint32_t const arity)
+            {
+                return generic_interface{ next_row(m_builder.TypeDef), arity };
+            };
+
+            m_iterator = self(1);
+            add_interface(collections, "IIterator`1", { { "get_Current", t, {} }, { "MoveNext", boolean, {} } }, 1);
+            m_iterable = self(1);
+            add_interface(collections, "IIterable`1", { { "First", instantiate(m_iterator, { t }), {} } }, 1);
+
+            m_vector_view = self(1);
+            add_interface(collections, "IVectorView`1", { { "GetAt", t, { u4 } }, { "get_Size", u4, {} }, { "IndexOf", boolean, { t, u4 } } }, 1);
+            add_interface_impl(m_vector_view.type, instantiate(m_iterable, { t }));
+
+            m_vector = self(1);
+            add_interface(collections, "IVector`1", { { "GetAt", t, { u4 } }, { "get_Size", u4, {} }, { "GetView", instantiate(m_vector_view, { t }), {} }, { "Append", std::nullopt, { t } } }, 1);
+            add_interface_impl(m_vector.type, instantiate(m_iterable, { t }));
+
+            m_key_value_pair = self(2);
+            add_interface(collections, "IKeyValuePair`2", { { "get_Key", t, {} }, { "get_Value", u, {} } }, 2);
+
+            m_map_view = self(2);
+            add_interface(collections, "IMapView`2", { { "Lookup", u, { t } }, { "get_Size", u4, {} }, { "HasKey", boolean, { t } } }, 2);
+            add_interface_impl(m_map_view.type, instantiate(m_iterable, { instantiate(m_key_value_pair, { t, u }) }));
+
+            m_map = self(2);
+            add_interface(collections, "IMap`2", { { "Lookup", u, { t } }, { "get_Size", u4, {} }, { "GetView", instantiate(m_map_view, { t, u }), {} }, { "Insert", boolean, { t, u } } }, 2);
+            add_interface_impl(m_map.type, instantiate(m_iterable, { instantiate(m_key_value_pair, { t, u }) }));
+
+            m_reference = self(1);
+            add_interface(foundation, "IReference`1", { { "get_Value", t, {} } }, 1);
+        }
+
+        void write_contracts()
+        {
+            auto const count = (std::max)(1u, m_options.namespaces / 20);
+
+            for (uint32_t i{}; i < count; ++i)
+            {
+                auto const name = "Contract" + std::to_string(i);
+                m_contracts.push_back("Synthetic.Contracts." + name);
+                auto const type = add_type(type_public | type_sealed | type_windows_runtime, "Synthetic.Contracts", name, encode_index(TypeDefOrRef::TypeRef, m_value_type), next_row(m_builder.Field), next_row(m_builder.MethodDef));
+                auto const parent = encode_index(HasCustomAttribute::TypeDef, type);
+                add_attribute(parent, m_api_contract_constructor, [](auto&&) {});
+                add_attribute(parent, m_contract_constructor, [](impl::blob_builder& b) { b.u32(0x000a0000); });
+            }
+        }
+
+        // Picks a type for a parameter, a field or a generic argument. Most are primitives, the rest refer to types in
+        // the current or an earlier namespace
+        type_sig pick_type(bool const value_only)
+        {
+            static constexpr ElementType primitives[]{ ElementType::Boolean, ElementType::I4, ElementType::U4, ElementType::I8, ElementType::R8, ElementType::String };
+            auto const choice = m_random.next(value_only ? 4 : 6);
+
+            if (choice == 1 && !m_enums.empty())
+            {
+                return type_def(m_enums[m_random.next(static_cast<uint32_t>(m_enums.size()))], true);
+            }
+
+            if (choice == 2 && !m_structs.empty())
+            {
+                return type_def(m_structs[m_random.next(static_cast<uint32_t>(m_structs.size()))], true);
+            }
+
+            if (choice == 4 && !m_interfaces.empty())
+            {
+                return type_def(m_interfaces[m_random.next(static_cast<uint32_t>(m_interfaces.size()))], false);
+            }
+
+            if (choice == 5)
+            {
+                return primitive(ElementType::Object);
+            }
+
+            return primitive(primitives[m_random.next(value_only ? 5 : 6)]);
+        }
+
+        type_sig pick_generic()
+        {
+            auto const str = primitive(ElementType::String);
+
+            switch (m_random.next(6))
+            {
+            case 0: return instantiate(m_vector, { pick_type(false) });
+            case 1: return instantiate(m_vector_view, { pick_type(false) });
+            case 2: return instantiate(m_iterable, { pick_type(false) });
+            case 3: return instantiate(m_map, { str, pick_type(false) });
+            case 4: return instantiate(m_map_view, { str, pick_type(false) });
+            default: return instantiate(m_reference, { pick_type(true) });
+            }
+        }
+
+        void write_namespace(uint32_t const index)
+        {
+            auto const type_namespace = "Synthetic.N" + std::to_string(index);
+            auto const contract = index % static_cast<uint32_t>(m_contracts.size());
+            auto const members = (std::max)(1u, m_options.methods);
+            std::vector<uint32_t> interfaces;
+
+            for (uint32_t i{}; i < m_options.types; ++i)
+            {
+                auto const suffix = std::to_string(i);
+
+                switch (i % 5)
+                {
+                case 0:
+                {
+                    auto const type = next_row(m_builder.TypeDef);
+                    auto const first_field = next_row(m_builder.Field);
+                    add_enum_value_field();
+
+                    for (uint32_t value{}; value < members; ++value)
+                    {
+                        auto const field = add_enum_constant(type, "Value" + std::to_string(value), static_cast<int32_t>(value));
+                        add_member_attributes(encode_index(HasCustomAttribute::Field, field), contract);
+                    }
+
+                    add_type(type_public | type_sealed | type_windows_runtime, type_namespace, "E" + suffix, encode_index(TypeDefOrRef::TypeRef, m_enum), first_field, next_row(m_builder.MethodDef));
+                    add_type_attributes(type, contract);
+                    m_enums.push_back(type);
+                    break;
+                }
+                case 1:
+                {
+                    auto const first_field = next_row(m_builder.Field);
+
+                    for (uint32_t field{}; field < (std::max)(1u, members / 2); ++field)
+                    {
+                        impl::blob_builder sig;
+                        sig.u8(0x6); // FIELD
+                        pick_type(true).write(sig);
+                        m_builder.Field.add({ field_public, m_builder.string("F" + std::to_string(field)), m_builder.blob(sig.data) });
+                    }
+
+                    auto const type = add_type(type_public | type_sealed | type_sequential_layout | type_windows_runtime, type_namespace, "S" + suffix, encode_index(TypeDefOrRef::TypeRef, m_value_type), first_field, next_row(m_builder.MethodDef));
+                    add_type_attributes(type, contract);
+                    m_structs.push_back(type);
+                    break;
+                }
+                case 2:
+                {
+                    std::vector<method> methods;
+
+                    for (uint32_t m{}; m < members; ++m)
+                    {
+                        auto result = m < m_options.generics ? pick_generic() : pick_type(false);
+                        methods.push_back({ "Method" + std::to_string(m), std::move(result), { pick_type(false) } });
+                    }
+
+                    auto const first_method = next_row(m_builder.MethodDef);
+                    auto const type = add_interface(type_namespace, "IThing" + suffix, methods);
+                    add_type_attributes(type, contract);
+
+                    for (uint32_t m{}; m < members; ++m)
+                    {
+                        add_member_attributes(encode_index(HasCustomAttribute::MethodDef, first_method + m), contract);
+                    }
+
+                    interfaces.push_back(type);
+                    m_interfaces.push_back(type);
+                    break;
+                }
+                case 3:
+                {
+                    auto const first_method = next_row(m_builder.MethodDef);
+                    add_method(method_constructor, { ".ctor", std::nullopt, { primitive(ElementType::Object), primitive(ElementType::I) } });
+                    add_method(method_invoke, { "Invoke", std::nullopt, { pick_type(false), pick_type(false) } });
+                    auto const type = add_type(type_public | type_sealed | type_windows_runtime, type_namespace, "Handler" + suffix, encode_index(TypeDefOrRef::TypeRef, m_delegate), next_row(m_builder.Field), first_method);
+                    add_guid(encode_index(HasCustomAttribute::TypeDef, type));
+                    add_type_attributes(type, contract);
+                    break;
+                }
+                case 4:
+                {
+                    auto const type = add_type(type_public | type_sealed | type_windows_runtime, type_namespace, "C" + suffix, encode_index(TypeDefOrRef::TypeRef, m_object), next_row(m_builder.Field), next_row(m_builder.MethodDef));
+                    add_type_attributes(type, contract);
+
+                    // The most recent interface is the default one, an earlier one and an iterable of it may follow
+                    auto const default_interface = interfaces.back();
+                    auto const default_impl = add_interface_impl(type, type_def(default_interface, false));
+                    add_attribute(encode_index(HasCustomAttribute::InterfaceImpl, default_impl), m_default_constructor, [](auto&&) {});
+                    add_member_attributes(encode_index(HasCustomAttribute::InterfaceImpl, default_impl), contract);
+
+                    if (interfaces.size() > 1)
+                    {
+                        auto const other = interfaces[m_random.next(static_cast<uint32_t>(interfaces.size() - 1))];
+                        add_member_attributes(encode_index(HasCustomAttribute::InterfaceImpl, add_interface_impl(type, type_def(other, false))), contract);
+                    }
+
+                    if (m_options.generics > 0)
+                    {
+                        add_interface_impl(type, instantiate(m_iterable, { type_def(default_interface, false) }));
+                    }
+                    break;
+                }
+                }
+            }
+        }
+
+        corpus_options m_options;
+        random m_random;
+        meta::writer::metadata_builder m_builder;
+        std::unordered_map<uint32_t, uint32_t> m_type_specs;
+        std::vector<std::string> m_contracts;
+        std::vector<uint32_t> m_enums;
+        std::vector<uint32_t> m_structs;
+        std::vector<uint32_t> m_interfaces;
+
+        uint32_t m_mscorlib{};
+        uint32_t m_object{};
+        uint32_t m_value_type{};
+        uint32_t m_enum{};
+        uint32_t m_delegate{};
+
+        uint32_t m_guid_constructor{};
+        uint32_t m_xlang_guid_constructor{};
+        uint32_t m_contract_version_constructor{};
+        uint32_t m_contract_constructor{};
+        uint32_t m_deprecated_constructor{};
+        uint32_t m_api_contract_constructor{};
+        uint32_t m_default_constructor{};
+        uint32_t m_web_host_hidden_constructor{};
+        uint32_t m_version_constructor{};
+
+        generic_interface m_iterator;
+        generic_interface m_iterable;
+        generic_interface m_vector_view;
+        generic_interface m_vector;
+        generic_interface m_key_value_pair;
+        generic_interface m_map_view;
+        generic_interface m_map;
+        generic_interface m_reference;
+    };
+}
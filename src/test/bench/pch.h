@@ -0,0 +1,8 @@
+#pragma once
+
+#include <experimental/filesystem>
+
+#include "cmd_reader.h"
+#include "meta_reader.h"
+#include "meta_writer.h"
+#include "text_writer.h"
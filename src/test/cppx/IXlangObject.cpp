@@ -1,4 +1,5 @@
 #include "pch.h"
+#include <unordered_set>
 
 using namespace xlang;
 
@@ -19,3 +20,92 @@ TEST_CASE("IXlangObject")
         REQUIRE(get_HashCode(obj) == get_HashCode(obj2));
     }
 }
+
+TEST_CASE("IXlangObject,cached type name")
+{
+    struct Object : implements<Object, Windows::Foundation::IXlangObject>
+    {
+    };
+
+    auto first = make<Object>();
+    auto second = make<Object>();
+    hstring const name = get_TypeName(first);
+
+    // Every object of a type shares one interned name, so further queries create no strings.
+    xlang_string_statistics before{};
+    xlang_get_string_statistics(&before);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        REQUIRE(get_abi(get_TypeName(first)) == get_abi(name));
+        REQUIRE(get_abi(get_TypeName(second)) == get_abi(name));
+        REQUIRE(get_abi(get_StringRepresentation(first)) == get_abi(name));
+    }
+
+    xlang_string_statistics after{};
+    xlang_get_string_statistics(&after);
+    REQUIRE(after.heap_strings_created == before.heap_strings_created);
+    REQUIRE(after.interned_strings_created == before.interned_strings_created);
+}
+
+TEST_CASE("IXlangObject,hash")
+{
+    struct Object : implements<Object, Windows::Foundation::IXlangObject>
+    {
+    };
+
+    std::hash<Windows::Foundation::IXlangObject> const hash;
+    Windows::Foundation::IXlangObject first = make<Object>();
+    Windows::Foundation::IXlangObject copy = first;
+    Windows::Foundation::IXlangObject second = make<Object>();
+
+    static_assert(noexcept(hash(first)));
+    REQUIRE(hash(first) == hash(copy));
+    REQUIRE(hash(nullptr) == 0);
+
+    // The 32-bit hash code is mixed rather than just widened.
+    REQUIRE(hash(first) != get_HashCode(first));
+
+    std::unordered_set<Windows::Foundation::IXlangObject> set{ first, copy, second };
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.count(first) == 1);
+    REQUIRE(set.count(second) == 1);
+}
+
+TEST_CASE("IXlangObject,benchmark", "[.benchmark]")
+{
+    struct Object : implements<Object, Windows::Foundation::IXlangObject>
+    {
+    };
+
+    std::vector<Windows::Foundation::IXlangObject> objects;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        objects.push_back(make<Object>());
+    }
+
+    BENCHMARK("Insert 10k objects into an unordered set and look each up 100 times")
+    {
+        std::unordered_set<Windows::Foundation::IXlangObject> set(objects.begin(), objects.end());
+        size_t found{};
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            for (auto&& object : objects)
+            {
+                found += set.count(object);
+            }
+        }
+        REQUIRE(found == 1000000);
+    }
+
+    BENCHMARK("Query the type name of 1M objects")
+    {
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            for (auto&& object : objects)
+            {
+                get_TypeName(object);
+            }
+        }
+    }
+}
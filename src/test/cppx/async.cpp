@@ -0,0 +1,207 @@
+#include "pch.h"
+#include <xlang/coroutine.h>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace xlang;
+using namespace Foundation;
+using namespace std::chrono_literals;
+
+namespace
+{
+    IAsyncAction completed_action()
+    {
+        co_return;
+    }
+
+    IAsyncOperation<int32_t> completed_operation(int32_t value)
+    {
+        co_return value;
+    }
+
+    IAsyncAction background_action()
+    {
+        co_await resume_background();
+    }
+
+    IAsyncOperation<int32_t> background_operation(int32_t value)
+    {
+        co_await resume_background();
+        co_return value;
+    }
+
+    IAsyncAction failing_action()
+    {
+        co_await resume_background();
+        throw hresult_invalid_argument();
+    }
+
+    IAsyncAction cancellable_action(std::atomic<bool>& callback_called)
+    {
+        auto cancel = co_await get_cancellation_token();
+        cancel.callback([&] { callback_called = true; });
+        co_await resume_after(10ms);
+        co_await resume_background();
+    }
+
+    IAsyncAction await_actions(uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            co_await background_action();
+        }
+    }
+}
+
+TEST_CASE("async,completed")
+{
+    IAsyncAction action = completed_action();
+    REQUIRE(action.Status() == AsyncStatus::Completed);
+    REQUIRE(action.ErrorCode() == impl::error_ok);
+    action.get();
+
+    REQUIRE(completed_operation(42).get() == 42);
+}
+
+TEST_CASE("async,background")
+{
+    background_action().get();
+    REQUIRE(background_operation(42).get() == 42);
+    await_actions(100).get();
+}
+
+TEST_CASE("async,completed handler")
+{
+    IAsyncAction action = completed_action();
+    AsyncStatus status{ AsyncStatus::Started };
+    REQUIRE(!action.Completed());
+    action.Completed([&](IAsyncAction const&, AsyncStatus result) { status = result; });
+    REQUIRE(status == AsyncStatus::Completed);
+    REQUIRE_THROWS_AS(action.Completed({}), hresult_illegal_delegate_assignment);
+}
+
+TEST_CASE("async,error")
+{
+    IAsyncAction action = failing_action();
+    REQUIRE_THROWS_AS(action.get(), hresult_invalid_argument);
+    REQUIRE(action.Status() == AsyncStatus::Error);
+    REQUIRE(action.ErrorCode() == impl::error_invalid_argument);
+}
+
+TEST_CASE("async,cancel")
+{
+    std::atomic<bool> callback_called{ false };
+    IAsyncAction action = cancellable_action(callback_called);
+    action.Cancel();
+    REQUIRE(callback_called);
+    REQUIRE(action.Status() == AsyncStatus::Canceled);
+    REQUIRE_THROWS_AS(action.get(), hresult_canceled);
+    REQUIRE(action.ErrorCode() == impl::error_canceled);
+
+    // Cancelling a completed action has no effect.
+    IAsyncAction completed = completed_action();
+    completed.Cancel();
+    REQUIRE(completed.Status() == AsyncStatus::Completed);
+}
+
+TEST_CASE("async,frame pool")
+{
+    // Warm up this thread's pool, so that the frames below are reused rather than allocated.
+    completed_action().get();
+    auto const before = get_coroutine_frame_statistics();
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        completed_action().get();
+    }
+
+    auto const after = get_coroutine_frame_statistics();
+    REQUIRE(after.heap_allocations == before.heap_allocations);
+    REQUIRE(after.pooled_allocations > before.pooled_allocations);
+
+    // Frames that finish on the thread pool are returned to that thread's pool, where the next frame
+    // allocated on that thread reuses them. Each thread needs at most two frames of its own before it
+    // only reuses frames, and each thread's pooled count is published up to a batch late or early.
+    uint32_t const count = 1000;
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+    auto const chain = [&]() -> IAsyncAction
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            {
+                std::lock_guard const guard(lock);
+                threads.insert(std::this_thread::get_id());
+            }
+            co_await background_action();
+        }
+    };
+
+    chain().get();
+    threads.clear();
+    auto const chain_before = get_coroutine_frame_statistics();
+    chain().get();
+    auto const chain_after = get_coroutine_frame_statistics();
+
+    uint64_t const heap = chain_after.heap_allocations - chain_before.heap_allocations;
+    uint64_t const pooled = chain_after.pooled_allocations - chain_before.pooled_allocations;
+    uint64_t const lag = (impl::coroutine_frame_pool::statistics_batch - 1) * threads.size();
+    REQUIRE(heap <= 2 * threads.size() + 1);
+    REQUIRE(heap + pooled <= count + 1 + lag);
+    REQUIRE(heap + pooled + lag >= count + 1);
+}
+
+TEST_CASE("async,benchmark", "[.benchmark]")
+{
+    BENCHMARK("Create and complete 1M actions")
+    {
+        for (uint32_t i = 0; i < 1000000; ++i)
+        {
+            completed_action().get();
+        }
+    }
+
+    BENCHMARK("Create and complete 1M actions on 8 threads")
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([]
+            {
+                for (uint32_t i = 0; i < 125000; ++i)
+                {
+                    completed_action().get();
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    BENCHMARK("Poll the status of an action 10M times")
+    {
+        IAsyncAction action = completed_action();
+        uint32_t completed{};
+        for (uint32_t i = 0; i < 10000000; ++i)
+        {
+            completed += action.Status() == AsyncStatus::Completed;
+        }
+        REQUIRE(completed == 10000000);
+    }
+
+    BENCHMARK("Await 1M background actions from 8 threads")
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([] { await_actions(125000).get(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
@@ -182,3 +182,79 @@ TEST_CASE("simple_containers")
     test_associative(make<simple_map>(), associative);
 }
 
+
+TEST_CASE("simple_containers,direct access")
+{
+    auto vector = make_self<simple_vector>();
+    array_view<int const> view = vector->get_array_view();
+    REQUIRE(view.size() == 3);
+    REQUIRE(view[2] == 3);
+
+    vector->ReplaceAll(std::vector<int>{ 4, 5 });
+    test_sequence(vector.as<IVector<int>>(), { 4, 5 });
+
+    int values[2]{};
+    REQUIRE(vector->GetMany(0, values) == 2);
+    REQUIRE(values[1] == 5);
+}
+
+TEST_CASE("simple_containers,benchmark", "[.benchmark]")
+{
+    constexpr uint32_t count = 1000000;
+
+    std::vector<int32_t> integers(count);
+    std::vector<hstring> strings(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        integers[i] = i;
+        strings[i] = hstring{ u8"element" };
+    }
+
+    IVector<int32_t> integer_vector = single_threaded_vector(std::vector<int32_t>(integers));
+    IVector<hstring> string_vector = single_threaded_vector(std::vector<hstring>(strings));
+
+    BENCHMARK("GetMany 1M int32_t")
+    {
+        REQUIRE(integer_vector.GetMany(0, integers) == count);
+    }
+
+    BENCHMARK("GetMany 1M hstring")
+    {
+        REQUIRE(string_vector.GetMany(0, strings) == count);
+    }
+
+    BENCHMARK("ReplaceAll 1M int32_t")
+    {
+        integer_vector.ReplaceAll(integers);
+    }
+
+    BENCHMARK("ReplaceAll 1M hstring")
+    {
+        string_vector.ReplaceAll(strings);
+    }
+}
+
+TEST_CASE("simple_containers,flat maps")
+{
+    std::initializer_list<std::pair<int, hstring>> associative{ { 1,u8"one" },{ 2, u8"two" },{ 3, u8"three" } };
+
+    IMap<int, hstring> sorted = single_threaded_map(flat_map<int, hstring>{ { 3, u8"three" }, { 1, u8"one" }, { 2, u8"two" } });
+    test_associative(sorted, associative);
+    REQUIRE(sorted.Lookup(2) == u8"two");
+    REQUIRE(!sorted.Insert(4, u8"four"));
+    REQUIRE(sorted.Insert(4, u8"FOUR"));
+    sorted.Remove(4);
+    REQUIRE(!sorted.HasKey(4));
+    REQUIRE(sorted.Size() == 3);
+
+    IMap<int, hstring> hashed = single_threaded_map(flat_hash_map<int, hstring>{ { 1, u8"one" }, { 2, u8"two" } });
+    hashed.Insert(3, u8"three");
+    REQUIRE(hashed.Size() == 3);
+    REQUIRE(hashed.Lookup(3) == u8"three");
+    REQUIRE_THROWS_AS(hashed.Lookup(4), hresult_out_of_bounds);
+
+    IMapView<int, hstring> view = immutable_map_view<int, hstring>(associative.begin(), associative.end());
+    REQUIRE(view.Size() == 3);
+    REQUIRE(view.Lookup(1) == u8"one");
+    REQUIRE(!view.HasKey(4));
+}
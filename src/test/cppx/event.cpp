@@ -0,0 +1,282 @@
+#include "pch.h"
+#include <thread>
+
+using namespace xlang;
+
+namespace
+{
+    using handler = delegate<int32_t>;
+}
+
+TEST_CASE("event,add and remove")
+{
+    event<handler> source;
+    REQUIRE(!source);
+    source(1);
+
+    int32_t first{};
+    int32_t second{};
+    event_token const first_token = source.add([&](int32_t value) { first += value; });
+    event_token const second_token = source.add([&](int32_t value) { second += value; });
+    REQUIRE(source);
+    REQUIRE(first_token);
+    REQUIRE(!(first_token == second_token));
+
+    source(1);
+    REQUIRE(first == 1);
+    REQUIRE(second == 1);
+
+    source.remove(first_token);
+    source(2);
+    REQUIRE(first == 1);
+    REQUIRE(second == 3);
+
+    // Removing an unknown or already removed token has no effect.
+    source.remove(first_token);
+    source.remove(event_token{});
+    source(3);
+    REQUIRE(second == 6);
+
+    source.remove(second_token);
+    REQUIRE(!source);
+    source(4);
+    REQUIRE(second == 6);
+}
+
+TEST_CASE("event,change while raising")
+{
+    event<handler> source;
+    event_token self{};
+    int32_t calls{};
+    int32_t added_calls{};
+
+    self = source.add([&](int32_t)
+    {
+        ++calls;
+        source.remove(self);
+        source.add([&](int32_t) { ++added_calls; });
+    });
+
+    // Handlers added or removed while raising take effect from the next raise.
+    source(0);
+    REQUIRE(calls == 1);
+    REQUIRE(added_calls == 0);
+
+    source(0);
+    REQUIRE(calls == 1);
+    REQUIRE(added_calls == 1);
+}
+
+TEST_CASE("event,many handlers")
+{
+    event<handler> source;
+    std::vector<event_token> tokens;
+    int32_t calls{};
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        tokens.push_back(source.add([&](int32_t value) { calls += value; }));
+    }
+
+    source(1);
+    REQUIRE(calls == 1000);
+
+    for (uint32_t i = 0; i < tokens.size(); i += 2)
+    {
+        source.remove(tokens[i]);
+    }
+
+    source(1);
+    REQUIRE(calls == 1500);
+
+    for (uint32_t i = 1; i < tokens.size(); i += 2)
+    {
+        source.remove(tokens[i]);
+    }
+
+    REQUIRE(!source);
+}
+
+TEST_CASE("event,delegate pool")
+{
+    // Warm up this thread's pool, so that the delegates below are reused rather than allocated.
+    std::vector<handler> handlers(100);
+    for (auto& current : handlers)
+    {
+        current = [](int32_t) {};
+    }
+    handlers.clear();
+
+    auto const before = get_delegate_statistics();
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        handlers.emplace_back([i](int32_t value) { REQUIRE(value == static_cast<int32_t>(i)); });
+    }
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        handlers[i](i);
+    }
+    handlers.clear();
+
+    auto const after = get_delegate_statistics();
+    REQUIRE(after.heap_allocations == before.heap_allocations);
+}
+
+TEST_CASE("event,over-aligned delegate")
+{
+    // Pooled blocks only have the default alignment, so these delegates must come from the heap instead.
+    struct alignas(64) aligned
+    {
+        int32_t value;
+    };
+
+    auto const before = get_delegate_statistics();
+    std::vector<handler> handlers;
+
+    for (int32_t i = 0; i < 16; ++i)
+    {
+        aligned const captured{ i };
+        handlers.emplace_back([captured](int32_t value)
+        {
+            REQUIRE(reinterpret_cast<uintptr_t>(&captured) % alignof(aligned) == 0);
+            REQUIRE(captured.value == value);
+        });
+    }
+
+    for (int32_t i = 0; i < 16; ++i)
+    {
+        handlers[i](i);
+    }
+
+    handlers.clear();
+    auto const after = get_delegate_statistics();
+    REQUIRE(after.heap_allocations - before.heap_allocations == 16);
+    REQUIRE(after.heap_deallocations - before.heap_deallocations == 16);
+}
+
+TEST_CASE("event,concurrent raise and change")
+{
+    event<handler> source;
+    std::atomic<int64_t> total{};
+    source.add([&](int32_t value) { total += value; });
+
+    constexpr uint32_t raisers = 4;
+    constexpr uint32_t raises = 20000;
+    std::atomic<bool> done{};
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < raisers; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            for (uint32_t n = 0; n < raises; ++n)
+            {
+                source(1);
+            }
+        });
+    }
+
+    // Handlers that are added and removed again contribute nothing, so the total only counts the permanent one.
+    std::thread changer([&]
+    {
+        while (!done)
+        {
+            event_token const token = source.add([](int32_t) {});
+            source.remove(token);
+        }
+    });
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    done = true;
+    changer.join();
+    REQUIRE(total == raisers * raises);
+}
+
+TEST_CASE("event,benchmark", "[.benchmark]")
+{
+    BENCHMARK("Subscribe 10k handlers")
+    {
+        event<handler> source;
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            source.add([i](int32_t) {});
+        }
+    }
+
+    BENCHMARK("Subscribe and unsubscribe 10k handlers")
+    {
+        event<handler> source;
+        std::vector<event_token> tokens;
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            tokens.push_back(source.add([i](int32_t) {}));
+        }
+        for (auto token = tokens.rbegin(); token != tokens.rend(); ++token)
+        {
+            source.remove(*token);
+        }
+    }
+
+    BENCHMARK("Create and release 1M delegates")
+    {
+        for (uint32_t i = 0; i < 1000000; ++i)
+        {
+            handler current{ [i](int32_t) {} };
+        }
+    }
+
+    auto const raise = [](uint32_t thread_count, uint32_t handler_count)
+    {
+        event<handler> source;
+        for (uint32_t i = 0; i < handler_count; ++i)
+        {
+            source.add([](int32_t) {});
+        }
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&, thread_count]
+            {
+                for (uint32_t n = 0; n < 1000000 / thread_count; ++n)
+                {
+                    source(0);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    };
+
+    BENCHMARK("Raise 1M times with 1 handler from 1 thread")
+    {
+        raise(1, 1);
+    }
+
+    BENCHMARK("Raise 1M times with 1 handler from 8 threads")
+    {
+        raise(8, 1);
+    }
+
+    BENCHMARK("Raise 1M times with 1 handler from 64 threads")
+    {
+        raise(64, 1);
+    }
+
+    BENCHMARK("Raise 1M times with 16 handlers from 8 threads")
+    {
+        raise(8, 16);
+    }
+
+    BENCHMARK("Raise 1M times with 16 handlers from 64 threads")
+    {
+        raise(64, 16);
+    }
+}
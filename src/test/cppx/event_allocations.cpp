@@ -0,0 +1,86 @@
+#include "pch.h"
+#include <cstdlib>
+
+// This file builds into its own executable, test_cppx_allocations, since it replaces the global
+// operator new to count heap allocations and that would otherwise apply to every test in test_cppx.
+
+using namespace xlang;
+
+namespace
+{
+    using handler = delegate<int32_t>;
+
+    std::atomic<uint64_t> global_allocations{};
+}
+
+void* operator new(size_t size)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* result = std::malloc(size ? size : 1))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+TEST_CASE("event,allocations")
+{
+    // Subscribes and then unsubscribes the given number of handlers twice, reporting the heap
+    // allocations each round takes. The delegates come from the pool, so the second round reuses
+    // the blocks the first one released, up to the pool's limit per thread.
+    auto const count_allocations = [](uint32_t const handler_count)
+    {
+        for (uint32_t round = 1; round <= 2; ++round)
+        {
+            object_pool_statistics const before = get_delegate_statistics();
+            uint64_t const allocations = global_allocations.load(std::memory_order_relaxed);
+            uint64_t subscribe_allocations{};
+
+            {
+                event<handler> source;
+                std::vector<event_token> tokens;
+                tokens.reserve(handler_count);
+                uint64_t const start = global_allocations.load(std::memory_order_relaxed);
+
+                for (uint32_t i = 0; i < handler_count; ++i)
+                {
+                    tokens.push_back(source.add([i](int32_t) {}));
+                }
+
+                subscribe_allocations = global_allocations.load(std::memory_order_relaxed) - start;
+
+                for (auto token = tokens.rbegin(); token != tokens.rend(); ++token)
+                {
+                    source.remove(*token);
+                }
+            }
+
+            object_pool_statistics const after = get_delegate_statistics();
+            uint64_t const delegate_heap = after.heap_allocations - before.heap_allocations;
+
+            WARN(handler_count << " handlers, round " << round << ": " << subscribe_allocations << " allocations to subscribe ("
+                << delegate_heap << " delegates from the heap, "
+                << after.pooled_allocations - before.pooled_allocations << " reused from the pool), "
+                << global_allocations.load(std::memory_order_relaxed) - allocations << " in total with unsubscribing");
+
+            // Subscribing allocates no more than one block per delegate that the pool could not supply,
+            // plus the logarithmically many arrays that growing the event takes.
+            REQUIRE(subscribe_allocations <= delegate_heap + 64);
+        }
+    };
+
+    count_allocations(1000);
+    count_allocations(10000);
+}
@@ -0,0 +1,173 @@
+#include "pch.h"
+#include <map>
+#include <random>
+
+using namespace xlang;
+
+namespace
+{
+    // Applies the same random inserts and erases to a std::map and to a flat map, checking that they agree.
+    template <typename Map>
+    void check_against_map(uint32_t key_range)
+    {
+        std::map<uint32_t, uint32_t> expected;
+        Map actual;
+        std::mt19937 random{ 42 };
+
+        for (uint32_t i = 0; i < 20000; ++i)
+        {
+            uint32_t const key = random() % key_range;
+
+            if (random() % 3 == 0)
+            {
+                REQUIRE(actual.erase(key) == expected.erase(key));
+            }
+            else
+            {
+                bool const inserted = expected.insert_or_assign(key, i).second;
+                auto result = actual.insert_or_assign(key, i);
+                REQUIRE(result.second == inserted);
+                REQUIRE(result.first->first == key);
+                REQUIRE(result.first->second == i);
+            }
+
+            REQUIRE(actual.size() == expected.size());
+        }
+
+        for (uint32_t key = 0; key < key_range; ++key)
+        {
+            auto found = expected.find(key);
+            auto actual_found = actual.find(key);
+
+            if (found == expected.end())
+            {
+                REQUIRE(actual_found == actual.end());
+            }
+            else
+            {
+                REQUIRE(actual_found != actual.end());
+                REQUIRE(actual_found->second == found->second);
+            }
+        }
+
+        std::map<uint32_t, uint32_t> iterated(actual.begin(), actual.end());
+        REQUIRE(iterated == expected);
+
+        actual.clear();
+        REQUIRE(actual.empty());
+        REQUIRE(actual.find(0) == actual.end());
+    }
+}
+
+TEST_CASE("flat_map")
+{
+    flat_map<hstring, int32_t> map{ { u8"two", 2 }, { u8"one", 1 }, { u8"three", 3 }, { u8"one", 4 } };
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.begin()->first == u8"one");
+    REQUIRE(map.begin()->second == 1);
+    REQUIRE(map.find(u8"two")->second == 2);
+    REQUIRE(map.find(u8"four") == map.end());
+
+    check_against_map<flat_map<uint32_t, uint32_t>>(100);
+    check_against_map<flat_map<uint32_t, uint32_t>>(5000);
+}
+
+TEST_CASE("flat_hash_map")
+{
+    flat_hash_map<hstring, int32_t> map{ { u8"two", 2 }, { u8"one", 1 }, { u8"three", 3 }, { u8"one", 4 } };
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.find(u8"one")->second == 1);
+    REQUIRE(map.find(u8"four") == map.end());
+
+    REQUIRE(map.erase(u8"one") == 1);
+    REQUIRE(map.erase(u8"one") == 0);
+    REQUIRE(map.find(u8"two")->second == 2);
+    REQUIRE(map.find(u8"three")->second == 3);
+
+    check_against_map<flat_hash_map<uint32_t, uint32_t>>(100);
+    check_against_map<flat_hash_map<uint32_t, uint32_t>>(5000);
+
+    // Keys that share their low bits probe from nearby slots.
+    flat_hash_map<uint32_t, uint32_t> strided;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        strided.insert_or_assign(i << 16, i);
+    }
+    for (uint32_t i = 0; i < 1000; i += 2)
+    {
+        REQUIRE(strided.erase(i << 16) == 1);
+    }
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        REQUIRE((strided.find(i << 16) != strided.end()) == (i % 2 == 1));
+    }
+}
+
+TEST_CASE("flat_map,benchmark", "[.benchmark]")
+{
+    constexpr uint32_t count = 1000;
+    constexpr uint32_t lookups = 1000000;
+
+    std::vector<std::pair<hstring, int32_t>> values;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        values.emplace_back(hstring{ u8"Property" } + hstring{ std::to_string(i * 7919).c_str() }, i);
+    }
+
+    std::map<hstring, int32_t> tree(values.begin(), values.end());
+    flat_map<hstring, int32_t> sorted(values.begin(), values.end());
+    flat_hash_map<hstring, int32_t> hashed(values.begin(), values.end());
+
+    auto const lookup = [&](auto const& map)
+    {
+        int64_t total{};
+        for (uint32_t i = 0; i < lookups; ++i)
+        {
+            total += map.find(values[(i * 31) % count].first)->second;
+        }
+        REQUIRE(total > 0);
+    };
+
+    auto const iterate = [&](auto const& map)
+    {
+        int64_t total{};
+        for (uint32_t i = 0; i < lookups / count; ++i)
+        {
+            for (auto&& value : map)
+            {
+                total += value.second;
+            }
+        }
+        REQUIRE(total > 0);
+    };
+
+    BENCHMARK("Look up 1M keys in a std::map of 1000 strings")
+    {
+        lookup(tree);
+    }
+
+    BENCHMARK("Look up 1M keys in a flat_map of 1000 strings")
+    {
+        lookup(sorted);
+    }
+
+    BENCHMARK("Look up 1M keys in a flat_hash_map of 1000 strings")
+    {
+        lookup(hashed);
+    }
+
+    BENCHMARK("Iterate 1M elements of a std::map")
+    {
+        iterate(tree);
+    }
+
+    BENCHMARK("Iterate 1M elements of a flat_map")
+    {
+        iterate(sorted);
+    }
+
+    BENCHMARK("Iterate 1M elements of a flat_hash_map")
+    {
+        iterate(hashed);
+    }
+}
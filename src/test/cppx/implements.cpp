@@ -0,0 +1,181 @@
+#include "pch.h"
+#include <utility>
+
+using namespace xlang;
+
+namespace
+{
+    constexpr guid test_id(uint32_t n) noexcept
+    {
+        return { 0x5a1e0000 + n, 0x7c3b, 0x4d2e, { 0x9f, 0x10, 0x2b, 0x6a, 0x00, 0x00, 0x00, static_cast<uint8_t>(n) } };
+    }
+
+    template <uint32_t N>
+    struct ITest : Windows::Foundation::IXlangObject
+    {
+        ITest(std::nullptr_t = nullptr) noexcept {}
+    };
+}
+
+namespace xlang::impl
+{
+    template <uint32_t N> struct abi<ITest<N>>
+    {
+        using type = xlang_object_abi;
+    };
+
+    template <uint32_t N> struct guid_storage<ITest<N>>
+    {
+        static constexpr guid value{ test_id(N) };
+    };
+}
+
+namespace
+{
+    template <typename Sequence>
+    struct object_with;
+
+    template <uint32_t... N>
+    struct object_with<std::integer_sequence<uint32_t, N...>> : implements<object_with<std::integer_sequence<uint32_t, N...>>, ITest<N>...>
+    {
+    };
+
+    template <uint32_t Count>
+    using test_object = object_with<std::make_integer_sequence<uint32_t, Count>>;
+
+    // An id whose hash key equals that of test_id(0), so that no seed can separate the two.
+    constexpr guid colliding_id() noexcept
+    {
+        guid const original = test_id(0);
+        uint64_t second{};
+
+        for (uint8_t const value : original.Data4)
+        {
+            second = (second << 8) | value;
+        }
+
+        ++second;
+        uint64_t const first = impl::guid_hash_key(original) ^ (second * 0x9e3779b97f4a7c15);
+        guid result{ static_cast<uint32_t>(first >> 32), static_cast<uint16_t>(first >> 16), static_cast<uint16_t>(first), {} };
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            result.Data4[i] = static_cast<uint8_t>(second >> (56 - i * 8));
+        }
+
+        return result;
+    }
+
+    static_assert(impl::guid_hash_key(colliding_id()) == impl::guid_hash_key(test_id(0)));
+
+    template <uint32_t... N>
+    constexpr bool has_perfect_hash(std::integer_sequence<uint32_t, N...>, bool const collide = false) noexcept
+    {
+        // The colliding id goes last, so that every seed is rejected only after placing all of the others.
+        guid const ids[]{ test_id(N)..., collide ? colliding_id() : test_id(sizeof...(N)) };
+        return impl::make_interface_hash(ids).perfect;
+    }
+
+    // The hash is computed while compiling, so these also check that the search for a seed stays within the
+    // compiler's limits on constant evaluation at the largest supported number of interfaces, including when
+    // no seed is found and the search runs until its budget is spent.
+    static_assert(has_perfect_hash(std::make_integer_sequence<uint32_t, 0>()));
+    static_assert(has_perfect_hash(std::make_integer_sequence<uint32_t, 19>()));
+    static_assert(has_perfect_hash(std::make_integer_sequence<uint32_t, 63>()));
+    static_assert(!has_perfect_hash(std::make_integer_sequence<uint32_t, 63>(), true));
+    static_assert(!has_perfect_hash(std::make_integer_sequence<uint32_t, 64>()));
+
+    // Each interface of the object must be found at its own address, and no other id may be found.
+    template <uint32_t Count>
+    void check_interfaces()
+    {
+        auto object = make_self<test_object<Count>>();
+        std::vector<void*> found;
+
+        for (uint32_t i = 0; i < Count; ++i)
+        {
+            void* result{};
+            REQUIRE(object->QueryInterface(test_id(i), &result) == impl::error_ok);
+            REQUIRE(result != nullptr);
+            REQUIRE(std::find(found.begin(), found.end(), result) == found.end());
+            found.push_back(result);
+            static_cast<impl::unknown_abi*>(result)->Release();
+        }
+
+        void* result{};
+        REQUIRE(object->QueryInterface(test_id(Count), &result) == impl::error_no_interface);
+        REQUIRE(result == nullptr);
+
+        REQUIRE(object->QueryInterface(guid_of<Windows::Foundation::IXlangObject>(), &result) == impl::error_ok);
+        static_cast<impl::unknown_abi*>(result)->Release();
+    }
+}
+
+TEST_CASE("implements,query interface")
+{
+    check_interfaces<1>();
+    check_interfaces<5>();
+    check_interfaces<20>();
+    check_interfaces<50>();
+    check_interfaces<64>();
+
+    // More interfaces than the perfect hash supports are searched in turn.
+    check_interfaces<70>();
+}
+
+TEST_CASE("implements,benchmark", "[.benchmark]")
+{
+    // Queries cycle through five ids, starting from the given interface number. Numbers past the
+    // object's interfaces miss.
+    auto const query = [](auto const& object, uint32_t first)
+    {
+        guid ids[5]{};
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            ids[i] = test_id(first + i);
+        }
+
+        for (uint32_t i = 0; i < 1000000; ++i)
+        {
+            void* result{};
+            if (object->QueryInterface(ids[i % 5], &result) == impl::error_ok)
+            {
+                static_cast<impl::unknown_abi*>(result)->Release();
+            }
+        }
+    };
+
+    auto const object_5 = make_self<test_object<5>>();
+    auto const object_20 = make_self<test_object<20>>();
+    auto const object_50 = make_self<test_object<50>>();
+
+    BENCHMARK("Query 1M hits on 5 interfaces")
+    {
+        query(object_5, 0);
+    }
+
+    BENCHMARK("Query 1M misses on 5 interfaces")
+    {
+        query(object_5, 100);
+    }
+
+    BENCHMARK("Query 1M hits on 20 interfaces")
+    {
+        query(object_20, 15);
+    }
+
+    BENCHMARK("Query 1M misses on 20 interfaces")
+    {
+        query(object_20, 100);
+    }
+
+    BENCHMARK("Query 1M hits on 50 interfaces")
+    {
+        query(object_50, 45);
+    }
+
+    BENCHMARK("Query 1M misses on 50 interfaces")
+    {
+        query(object_50, 100);
+    }
+}
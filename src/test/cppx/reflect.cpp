@@ -0,0 +1,261 @@
+#include "pch.h"
+#include <functional>
+
+using namespace xlang;
+namespace reflect = xlang::experimental::reflect;
+
+namespace
+{
+    enum class Colors : int32_t
+    {
+        Red = 0,
+        Yellow = 2,
+        Green = 4,
+        Blue = 6,
+    };
+
+    struct Point
+    {
+        float X;
+        float Y;
+        hstring Label;
+        Colors Color;
+    };
+}
+
+// The reflection metadata that cppxlang generates for a projected enum and struct of the same shape.
+namespace xlang::experimental::reflect
+{
+    template <> struct get_enumerator_names<Colors>
+    {
+        static constexpr std::array<std::string_view, 4> value{ u8"Red", u8"Yellow", u8"Green", u8"Blue" };
+    };
+    template <> struct get_enumerator_values<Colors>
+    {
+        static constexpr std::array<Colors, 4> value{ Colors::Red, Colors::Yellow, Colors::Green, Colors::Blue };
+    };
+    template <> struct named_property<Point>
+    {
+        struct X
+        {
+            struct name { static constexpr std::string_view value{ u8"X" }; };
+            using property_type = float;
+            using target_type = Point;
+            using is_readable = std::true_type;
+            using is_writable = std::true_type;
+            using is_static = std::false_type;
+            struct getter { property_type const& operator()(target_type const& target) const noexcept { return target.X; } };
+            struct setter { void operator()(target_type& target, property_type const& value) const { target.X = value; } };
+        };
+        struct Y
+        {
+            struct name { static constexpr std::string_view value{ u8"Y" }; };
+            using property_type = float;
+            using target_type = Point;
+            using is_readable = std::true_type;
+            using is_writable = std::true_type;
+            using is_static = std::false_type;
+            struct getter { property_type const& operator()(target_type const& target) const noexcept { return target.Y; } };
+            struct setter { void operator()(target_type& target, property_type const& value) const { target.Y = value; } };
+        };
+        struct Label
+        {
+            struct name { static constexpr std::string_view value{ u8"Label" }; };
+            using property_type = hstring;
+            using target_type = Point;
+            using is_readable = std::true_type;
+            using is_writable = std::true_type;
+            using is_static = std::false_type;
+            struct getter { property_type const& operator()(target_type const& target) const noexcept { return target.Label; } };
+            struct setter { void operator()(target_type& target, property_type const& value) const { target.Label = value; } };
+        };
+        struct Color
+        {
+            struct name { static constexpr std::string_view value{ u8"Color" }; };
+            using property_type = Colors;
+            using target_type = Point;
+            using is_readable = std::true_type;
+            using is_writable = std::true_type;
+            using is_static = std::false_type;
+            struct getter { property_type const& operator()(target_type const& target) const noexcept { return target.Color; } };
+            struct setter { void operator()(target_type& target, property_type const& value) const { target.Color = value; } };
+        };
+    };
+    template <> struct properties<Point>
+    {
+        using type = impl::typelist<named_property<Point>::X, named_property<Point>::Y, named_property<Point>::Label, named_property<Point>::Color>;
+    };
+}
+
+namespace
+{
+    void write_value(std::string& out, float value)
+    {
+        char buffer[32];
+        out.append(buffer, snprintf(buffer, sizeof(buffer), "%g", value));
+    }
+
+    void write_value(std::string& out, hstring const& value)
+    {
+        out += '"';
+        out += std::string_view{ value };
+        out += '"';
+    }
+
+    template <typename T, std::enable_if_t<std::is_enum_v<T>, int> = 0>
+    void write_value(std::string& out, T value)
+    {
+        auto const& values = reflect::get_enumerator_values<T>::value;
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (values[i] == value)
+            {
+                out += '"';
+                out += reflect::get_enumerator_names<T>::value[i];
+                out += '"';
+                return;
+            }
+        }
+    }
+
+    // Serializes the readable properties of any type with reflection metadata, resolving names and
+    // accessors at compile time.
+    template <typename T>
+    void serialize(std::string& out, T const& target)
+    {
+        char separator = '{';
+
+        reflect::for_each_property<T>([&](auto property)
+        {
+            using meta = decltype(property);
+
+            if constexpr (reflect::is_property_readable_v<meta> && !reflect::is_property_static_v<meta>)
+            {
+                out += separator;
+                out += '"';
+                out += reflect::property_name_v<meta>;
+                out += "\":";
+                write_value(out, reflect::property_getter<meta>{}(target));
+                separator = ',';
+            }
+        });
+
+        out += '}';
+    }
+
+    // The same serializer driven by a table of type-erased accessors that is built at run time, as
+    // needed when properties can only be discovered dynamically.
+    struct runtime_property
+    {
+        std::string name;
+        std::function<void(std::string&, void const*)> write;
+    };
+
+    std::vector<runtime_property> const& get_runtime_properties()
+    {
+        static std::vector<runtime_property> const properties
+        {
+            { "X", [](std::string& out, void const* target) { write_value(out, static_cast<Point const*>(target)->X); } },
+            { "Y", [](std::string& out, void const* target) { write_value(out, static_cast<Point const*>(target)->Y); } },
+            { "Label", [](std::string& out, void const* target) { write_value(out, static_cast<Point const*>(target)->Label); } },
+            { "Color", [](std::string& out, void const* target) { write_value(out, static_cast<Point const*>(target)->Color); } },
+        };
+
+        return properties;
+    }
+
+    void serialize_runtime(std::string& out, Point const& target)
+    {
+        char separator = '{';
+
+        for (auto&& property : get_runtime_properties())
+        {
+            out += separator;
+            out += '"';
+            out += property.name;
+            out += "\":";
+            property.write(out, &target);
+            separator = ',';
+        }
+
+        out += '}';
+    }
+}
+
+TEST_CASE("reflect,enumerators")
+{
+    constexpr auto const& names = reflect::get_enumerator_names<Colors>::value;
+    static_assert(names.size() == 4);
+    REQUIRE(names[0] == u8"Red");
+    REQUIRE(names[3] == u8"Blue");
+
+    constexpr auto const& values = reflect::get_enumerator_values<Colors>::value;
+    static_assert(values.size() == 4);
+    static_assert(values[1] == Colors::Yellow);
+    static_assert(values[2] == Colors::Green);
+}
+
+TEST_CASE("reflect,properties")
+{
+    using X = reflect::named_property<Point>::X;
+    static_assert(std::is_same_v<reflect::property_value_t<X>, float>);
+    static_assert(std::is_same_v<reflect::property_target_t<X>, Point>);
+    static_assert(reflect::is_property_readable_v<X>);
+    static_assert(reflect::is_property_writable_v<X>);
+    static_assert(!reflect::is_property_static_v<X>);
+    static_assert(reflect::property_name_v<X> == u8"X");
+
+    Point point{ 1, 2, hstring{ u8"origin" }, Colors::Green };
+    reflect::property_setter<X>{}(point, 3.5f);
+    REQUIRE(reflect::property_getter<X>{}(point) == 3.5f);
+
+    std::vector<std::string_view> names;
+    reflect::for_each_property<Point>([&](auto property)
+    {
+        names.push_back(reflect::property_name_v<decltype(property)>);
+    });
+    REQUIRE(names == std::vector<std::string_view>{ u8"X", u8"Y", u8"Label", u8"Color" });
+
+    REQUIRE(reflect::find_property_if<Point>([](auto property)
+    {
+        return std::is_same_v<reflect::property_value_t<decltype(property)>, hstring>;
+    }));
+
+    std::string compile_time;
+    serialize(compile_time, point);
+    REQUIRE(compile_time == R"({"X":3.5,"Y":2,"Label":"origin","Color":"Green"})");
+
+    std::string run_time;
+    serialize_runtime(run_time, point);
+    REQUIRE(run_time == compile_time);
+}
+
+TEST_CASE("reflect,benchmark", "[.benchmark]")
+{
+    std::vector<Point> points;
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        points.push_back({ static_cast<float>(i), static_cast<float>(i) / 2, hstring{ u8"point" }, static_cast<Colors>(i % 4 * 2) });
+    }
+
+    BENCHMARK("Serialize 100k structs through compile-time reflection")
+    {
+        std::string out;
+        for (auto&& point : points)
+        {
+            serialize(out, point);
+        }
+        REQUIRE(!out.empty());
+    }
+
+    BENCHMARK("Serialize 100k structs through a runtime property table")
+    {
+        std::string out;
+        for (auto&& point : points)
+        {
+            serialize_runtime(out, point);
+        }
+        REQUIRE(!out.empty());
+    }
+}
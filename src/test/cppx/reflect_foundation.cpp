@@ -0,0 +1,70 @@
+#include "pch.h"
+#include <xlang/Foundation.h>
+
+using namespace xlang;
+namespace reflect = xlang::experimental::reflect;
+
+// These exercise the reflection metadata that cppxlang generates for the Foundation namespace, rather
+// than the hand-written specializations in reflect.cpp.
+
+TEST_CASE("reflect,generated enumerators")
+{
+    using Foundation::AsyncStatus;
+
+    constexpr auto const& names = reflect::get_enumerator_names<AsyncStatus>::value;
+    constexpr auto const& values = reflect::get_enumerator_values<AsyncStatus>::value;
+    static_assert(names.size() == 4);
+    static_assert(values.size() == 4);
+
+    // Enumerators are listed in metadata order, so look each one up by name.
+    auto const value_of = [&](std::string_view const& name)
+    {
+        auto const found = std::find(names.begin(), names.end(), name);
+        REQUIRE(found != names.end());
+        return values[found - names.begin()];
+    };
+
+    REQUIRE(value_of(u8"Started") == AsyncStatus::Started);
+    REQUIRE(value_of(u8"Completed") == AsyncStatus::Completed);
+    REQUIRE(value_of(u8"Canceled") == AsyncStatus::Canceled);
+    REQUIRE(value_of(u8"Error") == AsyncStatus::Error);
+}
+
+TEST_CASE("reflect,generated struct properties")
+{
+    using Foundation::Guid;
+
+    using TimeLow = reflect::named_property<Guid>::TimeLow;
+    static_assert(std::is_same_v<reflect::property_value_t<TimeLow>, uint32_t>);
+    static_assert(std::is_same_v<reflect::property_target_t<TimeLow>, Guid>);
+    static_assert(reflect::is_property_readable_v<TimeLow>);
+    static_assert(reflect::is_property_writable_v<TimeLow>);
+    static_assert(!reflect::is_property_static_v<TimeLow>);
+    static_assert(reflect::property_name_v<TimeLow> == u8"TimeLow");
+    static_assert(std::is_same_v<reflect::property_value_t<reflect::named_property<Guid>::TimeMid>, uint16_t>);
+    static_assert(std::is_same_v<reflect::property_value_t<reflect::named_property<Guid>::Node6>, uint8_t>);
+
+    Guid value{};
+    reflect::property_setter<TimeLow>{}(value, 0x12345678);
+    REQUIRE(value.TimeLow == 0x12345678);
+    REQUIRE(reflect::property_getter<TimeLow>{}(value) == 0x12345678);
+
+    // Fields are reflected in declaration order, and each accessor reaches its own field.
+    std::vector<std::string_view> names;
+    uint32_t next{};
+
+    reflect::for_each_property<Guid>([&](auto property)
+    {
+        using meta = decltype(property);
+        names.push_back(reflect::property_name_v<meta>);
+        reflect::property_setter<meta>{}(value, static_cast<reflect::property_value_t<meta>>(++next));
+    });
+
+    REQUIRE(names == std::vector<std::string_view>{ u8"TimeLow", u8"TimeMid", u8"TimeHiAndVersion", u8"ClockSeqHiAndReserved",
+        u8"ClockSeqLow", u8"Node1", u8"Node2", u8"Node3", u8"Node4", u8"Node5", u8"Node6" });
+
+    REQUIRE(value.TimeLow == 1);
+    REQUIRE(value.TimeMid == 2);
+    REQUIRE(value.ClockSeqLow == 5);
+    REQUIRE(value.Node6 == 11);
+}
@@ -0,0 +1,293 @@
+#include "pch.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include "meta_writer.h"
+
+using namespace xlang;
+using namespace xlang::meta;
+
+namespace
+{
+    std::unique_ptr<reader::database> save(writer::metadata_builder& builder)
+    {
+        writer::pe_writer pe;
+        builder.save(pe);
+        return std::make_unique<reader::database>(pe.save_to_memory());
+    }
+
+    // Each custom attribute carries its own number as its blob, so that it can be recognized once the rows are sorted
+    uint32_t add_attribute(writer::metadata_builder& builder, uint32_t const parent, uint32_t const id)
+    {
+        uint8_t value[4];
+        std::memcpy(value, &id, sizeof(id));
+        return builder.CustomAttribute.add({ parent, writer::encode_index(reader::CustomAttributeType::MemberRef, 1), builder.blob(value, sizeof(value)) });
+    }
+
+    uint32_t attribute_id(reader::CustomAttribute const& attribute)
+    {
+        auto const value = attribute.get_database().get_blob(attribute.get_value<uint32_t>(2));
+        uint32_t id{};
+        std::memcpy(&id, value.begin(), (std::min)(value.size(), static_cast<uint32_t>(sizeof(id))));
+        return id;
+    }
+
+    template <typename Row>
+    std::vector<uint32_t> attribute_ids(Row const& row)
+    {
+        std::vector<uint32_t> result;
+
+        for (auto&& attribute : row.CustomAttribute())
+        {
+            result.push_back(attribute_id(attribute));
+        }
+
+        return result;
+    }
+
+    void add_types(writer::metadata_builder& builder, uint32_t const count)
+    {
+        for (uint32_t i{}; i < count; ++i)
+        {
+            builder.TypeDef.add({ 0, builder.string("Type" + std::to_string(i)), builder.string("Test"), 0, 1, 1 });
+        }
+    }
+}
+
+TEST_CASE("metadata_builder,sort")
+{
+    writer::metadata_builder builder;
+    builder.Module.add({ 0, builder.string("Test.winmd"), 0, 0, 0 });
+    add_types(builder, 4);
+    builder.MemberRef.add({ writer::encode_index(reader::MemberRefParent::TypeDef, 1), builder.string(".ctor"), 0 });
+
+    for (uint32_t i{}; i < 8; ++i)
+    {
+        builder.TypeRef.add({ 0, builder.string("Interface" + std::to_string(i)), builder.string("Test") });
+    }
+
+    auto const type_ref = [](uint32_t const row) { return writer::encode_index(reader::TypeDefOrRef::TypeRef, row); };
+    auto const parent = [](reader::HasCustomAttribute const type, uint32_t const row) { return writer::encode_index(type, row); };
+
+    // The attributes of type 2 are added among the others and must keep their order
+    add_attribute(builder, parent(reader::HasCustomAttribute::TypeDef, 2), 100);
+
+    // Interfaces are added class by class, but not in class order. Interface N is implemented by class N % 3 + 1
+    for (uint32_t interface : { 2u, 0u, 4u, 1u, 3u, 5u })
+    {
+        auto const row = builder.InterfaceImpl.add({ interface % 3 + 1, type_ref(interface + 1) });
+        add_attribute(builder, parent(reader::HasCustomAttribute::InterfaceImpl, row), 200 + interface);
+    }
+
+    add_attribute(builder, parent(reader::HasCustomAttribute::TypeDef, 2), 101);
+
+    // Generic parameters of types 3 and 1, neither in owner nor in number order
+    std::vector<uint32_t> params;
+
+    for (auto [owner, number] : std::initializer_list<std::pair<uint32_t, uint32_t>>{ { 3, 1 }, { 1, 0 }, { 3, 0 }, { 1, 1 } })
+    {
+        auto const row = builder.GenericParam.add({ number, 0, writer::encode_index(reader::TypeOrMethodDef::TypeDef, owner), builder.string("T" + std::to_string(owner) + std::to_string(number)) });
+        add_attribute(builder, parent(reader::HasCustomAttribute::GenericParam, row), 300 + owner * 10 + number);
+        params.push_back(row);
+    }
+
+    add_attribute(builder, parent(reader::HasCustomAttribute::TypeDef, 2), 102);
+
+    // Constraints are added in reverse order of their parameters, and each parameter has two that must keep their order
+    for (uint32_t i = static_cast<uint32_t>(params.size()); i-- > 0;)
+    {
+        for (uint32_t n{}; n < 2; ++n)
+        {
+            auto const row = builder.GenericParamConstraint.add({ params[i], type_ref(i * 2 + n + 1) });
+            add_attribute(builder, parent(reader::HasCustomAttribute::GenericParamConstraint, row), 400 + i * 2 + n);
+        }
+    }
+
+    auto const db = save(builder);
+
+    REQUIRE(attribute_ids(db->TypeDef[1]) == std::vector<uint32_t>{ 100, 101, 102 });
+
+    // Implementations are sorted by class and, within a class, keep the order in which they were added
+    REQUIRE(db->InterfaceImpl.size() == 6);
+    std::vector<uint32_t> interfaces;
+
+    for (auto&& impl : db->InterfaceImpl)
+    {
+        auto const interface = impl.Interface().index();
+        REQUIRE(impl.get_value<uint32_t>(0) == interface % 3 + 1);
+        REQUIRE(attribute_ids(impl) == std::vector<uint32_t>{ 200 + interface });
+        interfaces.push_back(interface);
+    }
+
+    REQUIRE(interfaces == std::vector<uint32_t>{ 0, 3, 4, 1, 2, 5 });
+
+    // Parameters are sorted by owner and then by number
+    REQUIRE(db->GenericParam.size() == 4);
+    std::vector<std::string_view> names;
+
+    for (auto&& param : db->GenericParam)
+    {
+        auto const owner = param.Owner().index() + 1;
+        auto const number = param.Number();
+        REQUIRE(param.Name() == "T" + std::to_string(owner) + std::to_string(number));
+        REQUIRE(attribute_ids(param) == std::vector<uint32_t>{ 300 + owner * 10 + number });
+        names.push_back(param.Name());
+    }
+
+    REQUIRE(names == std::vector<std::string_view>{ "T10", "T11", "T30", "T31" });
+
+    // Constraints follow their parameters to their new rows, and so do the attributes of both
+    REQUIRE(db->GenericParamConstraint.size() == 8);
+    std::vector<uint32_t> constraints;
+
+    for (auto&& constraint : db->GenericParamConstraint)
+    {
+        auto const owner = db->GenericParam[constraint.get_value<uint32_t>(0) - 1];
+        auto const constraint_id = (constraint.get_value<uint32_t>(1) >> 2) - 1;
+        auto const param = constraint_id / 2;
+        REQUIRE(owner.Name() == std::array<std::string_view, 4>{ "T31", "T10", "T30", "T11" }[param]);
+        REQUIRE(attribute_ids(constraint) == std::vector<uint32_t>{ 400 + constraint_id });
+        constraints.push_back(constraint_id);
+    }
+
+    REQUIRE(constraints == std::vector<uint32_t>{ 2, 3, 6, 7, 4, 5, 0, 1 });
+
+    // DeclSecurity rows are sorted by parent too, but the reader has no way to find attributes on them, so they are refused
+    writer::metadata_builder security;
+    security.Module.add({ 0, security.string("Test.winmd"), 0, 0, 0 });
+    add_types(security, 2);
+    security.MemberRef.add({ writer::encode_index(reader::MemberRefParent::TypeDef, 1), security.string(".ctor"), 0 });
+    security.DeclSecurity.add({ 2, writer::encode_index(reader::HasDeclSecurity::TypeDef, 2), 0 });
+    security.DeclSecurity.add({ 1, writer::encode_index(reader::HasDeclSecurity::TypeDef, 1), 0 });
+
+    auto const sorted = save(security);
+    REQUIRE(sorted->DeclSecurity.size() == 2);
+    REQUIRE(sorted->DeclSecurity[0].get_value<uint16_t>(0) == 1);
+    REQUIRE(sorted->DeclSecurity[1].get_value<uint16_t>(0) == 2);
+
+    add_attribute(security, parent(reader::HasCustomAttribute::Permission, 1), 500);
+    REQUIRE_THROWS(save(security));
+}
+
+TEST_CASE("metadata_builder,heaps")
+{
+    writer::metadata_builder builder;
+    REQUIRE(builder.string("") == 0);
+    auto const name = builder.string("Name");
+    REQUIRE(builder.string("Other") != name);
+    REQUIRE(builder.string("Name") == name);
+
+    REQUIRE(builder.blob(std::vector<uint8_t>{}) == 0);
+    auto const blob = builder.blob(std::vector<uint8_t>{ 1, 2, 3 });
+    REQUIRE(builder.blob(std::vector<uint8_t>{ 1, 2 }) != blob);
+    REQUIRE(builder.blob(std::vector<uint8_t>{ 1, 2, 3 }) == blob);
+
+    std::array<uint8_t, 16> first{ 1 };
+    std::array<uint8_t, 16> second{ 2 };
+    REQUIRE(builder.guid(first) == 1);
+    REQUIRE(builder.guid(second) == 2);
+    REQUIRE(builder.guid(first) == 1);
+
+    builder.Module.add({ 0, name, builder.guid(second), 0, 0 });
+    builder.TypeDef.add({ 0, name, builder.string("Name"), 0, 1, 1 });
+    auto const db = save(builder);
+
+    REQUIRE(db->Module[0].get_value<uint32_t>(1) == db->TypeDef[0].get_value<uint32_t>(1));
+    REQUIRE(db->TypeDef[0].TypeName() == "Name");
+    REQUIRE(db->TypeDef[0].TypeNamespace() == "Name");
+    REQUIRE(db->Module[0].get_value<uint32_t>(2) == 2);
+}
+
+TEST_CASE("metadata_builder,column sizes")
+{
+    // Index columns need four bytes once the table they refer to has 2^16 rows, and coded index columns once one of
+    // their tables no longer fits in the bits that the tag leaves. Heap indexes need four bytes once the heap is 2^16 bytes
+    auto const sizes = [](uint32_t const types, uint32_t const type_refs, uint32_t const string_bytes)
+    {
+        writer::metadata_builder builder;
+        builder.TypeDef.reserve(types);
+
+        for (uint32_t i{}; i < types; ++i)
+        {
+            builder.TypeDef.add({ 0, 0, 0, 0, 1, 1 });
+        }
+
+        for (uint32_t i{}; i < type_refs; ++i)
+        {
+            builder.TypeRef.add({ 0, 0, 0 });
+        }
+
+        if (string_bytes > 1)
+        {
+            builder.string(std::string(string_bytes - 2, 'a'));
+        }
+
+        builder.InterfaceImpl.add({ 1, writer::encode_index(reader::TypeDefOrRef::TypeRef, 1) });
+        auto const db = save(builder);
+        REQUIRE(db->TypeDef.size() == types);
+        return std::array<uint32_t, 3>{ db->InterfaceImpl.column_size(0), db->InterfaceImpl.column_size(1), db->TypeRef.column_size(1) };
+    };
+
+    REQUIRE(sizes(0xffff, 1, 0) == std::array<uint32_t, 3>{ 2, 4, 2 });
+    REQUIRE(sizes(0x10000, 1, 0) == std::array<uint32_t, 3>{ 4, 4, 2 });
+    REQUIRE(sizes(1, 0x3fff, 0) == std::array<uint32_t, 3>{ 2, 2, 2 });
+    REQUIRE(sizes(1, 0x4000, 0) == std::array<uint32_t, 3>{ 2, 4, 2 });
+    REQUIRE(sizes(1, 1, 0xffff) == std::array<uint32_t, 3>{ 2, 2, 2 });
+    REQUIRE(sizes(1, 1, 0x10000) == std::array<uint32_t, 3>{ 2, 2, 4 });
+}
+
+TEST_CASE("metadata_builder,parallel sort")
+{
+    // Enough rows that the table is sorted in several runs on separate threads and then merged
+    uint32_t const types = 1000;
+    uint32_t const count = 250000;
+
+    // The number of runs depends on the number of threads, so try several, including odd ones that leave a run to
+    // carry over to the next round of merging
+    std::vector<uint64_t> keys(count);
+
+    for (uint32_t i{}; i < count; ++i)
+    {
+        keys[i] = (i * 7919) % types;
+    }
+
+    for (std::size_t threads : { 1, 2, 3, 4, 7 })
+    {
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        impl::parallel_stable_sort(order, keys, threads);
+
+        REQUIRE(std::is_sorted(order.begin(), order.end(), [&](uint32_t const lhs, uint32_t const rhs)
+        {
+            return std::pair{ keys[lhs], lhs } < std::pair{ keys[rhs], rhs };
+        }));
+    }
+
+    writer::metadata_builder builder;
+    add_types(builder, types);
+    builder.MemberRef.add({ writer::encode_index(reader::MemberRefParent::TypeDef, 1), builder.string(".ctor"), 0 });
+    builder.CustomAttribute.reserve(count);
+
+    for (uint32_t i{}; i < count; ++i)
+    {
+        add_attribute(builder, writer::encode_index(reader::HasCustomAttribute::TypeDef, (i * 7919) % types + 1), i);
+    }
+
+    auto const db = save(builder);
+    REQUIRE(db->CustomAttribute.size() == count);
+
+    // Attributes are sorted by parent and, within a parent, keep the order in which they were added
+    std::vector<std::pair<uint32_t, uint32_t>> rows;
+    rows.reserve(count);
+
+    for (auto&& attribute : db->CustomAttribute)
+    {
+        rows.emplace_back(attribute.get_value<uint32_t>(0), attribute_id(attribute));
+    }
+
+    REQUIRE(std::is_sorted(rows.begin(), rows.end()));
+    REQUIRE(std::all_of(rows.begin(), rows.end(), [&](auto const& row)
+    {
+        return row.first == writer::encode_index(reader::HasCustomAttribute::TypeDef, (row.second * 7919) % types + 1);
+    }));
+}
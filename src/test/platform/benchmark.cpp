@@ -0,0 +1,373 @@
+#include "pch.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Micro-benchmarks for the PAL. These are hidden by default; run them with
+//     test_platform [benchmark]
+
+using namespace std;
+using namespace std::string_view_literals;
+
+namespace
+{
+    constexpr basic_string_view<xlang_char8> benchmark_names[] = {
+        u8"Windows.Foundation.Uri"sv,
+        u8"Windows.Foundation.IAsyncAction"sv,
+        u8"Windows.Foundation.Collections.IVector`1"sv,
+        u8"Windows.Foundation.Collections.IMap`2"sv,
+        u8"Windows.Storage.StorageFile"sv,
+        u8"Windows.UI.Xaml.Controls.Button"sv,
+        u8"DisplayName"sv,
+        u8"Completed"sv,
+    };
+
+    bool contents_equal(xlang_string lhs, xlang_string rhs)
+    {
+        xlang_char8 const* lhs_buffer{};
+        uint32_t lhs_length{};
+        xlang_char8 const* rhs_buffer{};
+        uint32_t rhs_length{};
+        xlang_get_string_raw_buffer_utf8(lhs, &lhs_buffer, &lhs_length);
+        xlang_get_string_raw_buffer_utf8(rhs, &rhs_buffer, &rhs_length);
+        return basic_string_view<xlang_char8>{ lhs_buffer, lhs_length } == basic_string_view<xlang_char8>{ rhs_buffer, rhs_length };
+    }
+}
+
+TEST_CASE("Interned string benchmarks", "[.benchmark]")
+{
+    constexpr size_t iterations = 1000000;
+    constexpr size_t name_count = std::size(benchmark_names);
+
+    xlang_string heap[name_count]{};
+    xlang_string interned[name_count]{};
+    for (size_t i = 0; i < name_count; ++i)
+    {
+        auto const name = benchmark_names[i];
+        REQUIRE(xlang_create_string_utf8(name.data(), static_cast<uint32_t>(name.size()), &heap[i]) == nullptr);
+        REQUIRE(xlang_intern_string_utf8(name.data(), static_cast<uint32_t>(name.size()), &interned[i]) == nullptr);
+    }
+
+    BENCHMARK("Create and delete heap strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto const name = benchmark_names[i % name_count];
+            xlang_string str{};
+            xlang_create_string_utf8(name.data(), static_cast<uint32_t>(name.size()), &str);
+            xlang_delete_string(str);
+        }
+    }
+
+    BENCHMARK("Intern existing strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto const name = benchmark_names[i % name_count];
+            xlang_string str{};
+            xlang_intern_string_utf8(name.data(), static_cast<uint32_t>(name.size()), &str);
+            xlang_delete_string(str);
+        }
+    }
+
+    BENCHMARK("Duplicate heap strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            xlang_string str{};
+            xlang_duplicate_string(heap[i % name_count], &str);
+            xlang_delete_string(str);
+        }
+    }
+
+    BENCHMARK("Duplicate interned strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            xlang_string str{};
+            xlang_duplicate_string(interned[i % name_count], &str);
+            xlang_delete_string(str);
+        }
+    }
+
+    size_t matches{};
+    BENCHMARK("Compare heap strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            matches += contents_equal(heap[i % name_count], heap[(i / name_count) % name_count]);
+        }
+    }
+
+    BENCHMARK("Compare interned strings")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            matches += interned[i % name_count] == interned[(i / name_count) % name_count];
+        }
+    }
+    REQUIRE(matches > 0);
+
+    BENCHMARK("Convert heap strings to UTF-16")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto const name = benchmark_names[i % name_count];
+            xlang_string str{};
+            xlang_create_string_utf8(name.data(), static_cast<uint32_t>(name.size()), &str);
+            char16_t const* buffer{};
+            uint32_t length{};
+            xlang_get_string_raw_buffer_utf16(str, &buffer, &length);
+            xlang_delete_string(str);
+        }
+    }
+
+    BENCHMARK("Convert interned strings to UTF-16")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            char16_t const* buffer{};
+            uint32_t length{};
+            xlang_get_string_raw_buffer_utf16(interned[i % name_count], &buffer, &length);
+        }
+    }
+
+    for (auto str : heap)
+    {
+        xlang_delete_string(str);
+    }
+}
+
+TEST_CASE("Batch string benchmarks", "[.benchmark]")
+{
+    constexpr uint32_t element_count = 10000;
+    constexpr size_t iterations = 100;
+    constexpr size_t name_count = std::size(benchmark_names);
+
+    basic_string<xlang_char8> packed;
+    std::vector<uint32_t> lengths(element_count);
+    for (uint32_t i = 0; i < element_count; ++i)
+    {
+        auto const name = benchmark_names[i % name_count];
+        packed.append(name.data(), name.size());
+        lengths[i] = static_cast<uint32_t>(name.size());
+    }
+    std::vector<xlang_string> strings(element_count);
+
+    BENCHMARK("Create and delete 10k strings individually")
+    {
+        for (size_t n = 0; n < iterations; ++n)
+        {
+            xlang_char8 const* source = packed.data();
+            for (uint32_t i = 0; i < element_count; ++i)
+            {
+                xlang_create_string_utf8(source, lengths[i], &strings[i]);
+                source += lengths[i];
+            }
+            for (uint32_t i = 0; i < element_count; ++i)
+            {
+                xlang_delete_string(strings[i]);
+            }
+        }
+    }
+
+    BENCHMARK("Create and delete 10k strings in a batch")
+    {
+        for (size_t n = 0; n < iterations; ++n)
+        {
+            xlang_create_strings_utf8(element_count, lengths.data(), packed.data(), strings.data());
+            xlang_delete_strings(element_count, strings.data());
+        }
+    }
+}
+
+TEST_CASE("Error origination benchmarks", "[.benchmark]")
+{
+    constexpr size_t iterations = 1000000;
+
+    BENCHMARK("Originate and release result-only errors")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            xlang_error_info* error = xlang_originate_error(xlang_result::type_load);
+            xlang_result result{};
+            error->GetError(&result);
+            error->Release();
+        }
+    }
+
+    BENCHMARK("Originate and release static message errors")
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            xlang_error_info* error = xlang_originate_static_error(xlang_result::no_interface, u8"No such interface");
+            xlang_result result{};
+            error->GetError(&result);
+            error->Release();
+        }
+    }
+
+    BENCHMARK("Originate errors while sampling 1 in 100 execution traces")
+    {
+        xlang_set_execution_trace_sampling(100);
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            xlang_originate_error(xlang_result::type_load)->Release();
+        }
+        xlang_set_execution_trace_sampling(0);
+    }
+
+    auto const invalid = "\xed\xa0\x80"sv;
+    xlang_string str{};
+    REQUIRE(xlang_create_string_utf8(invalid.data(), static_cast<uint32_t>(invalid.size()), &str) == nullptr);
+
+    BENCHMARK("Fail to convert a string")
+    {
+        for (size_t i = 0; i < iterations / 10; ++i)
+        {
+            char16_t const* buffer{};
+            uint32_t length{};
+            xlang_error_info* error = xlang_get_string_raw_buffer_utf16(str, &buffer, &length);
+            error->Release();
+        }
+    }
+
+    xlang_delete_string(str);
+}
+
+TEST_CASE("Thread pool benchmarks", "[.benchmark]")
+{
+    // A chain stands in for a coroutine: each step resumes the next on the thread pool, the way
+    // co_await resume_background() does.
+    struct chain
+    {
+        static void XLANG_CALL step(void* context) noexcept
+        {
+            auto that = static_cast<chain*>(context);
+            if (++that->steps == that->length)
+            {
+                that->group->finish();
+            }
+            else
+            {
+                xlang_submit_threadpool_callback(step, that);
+            }
+        }
+
+        struct group_state
+        {
+            void finish()
+            {
+                if (++finished == total)
+                {
+                    std::lock_guard const guard(lock);
+                    condition.notify_all();
+                }
+            }
+
+            void wait()
+            {
+                std::unique_lock guard(lock);
+                condition.wait(guard, [&] { return finished == total; });
+            }
+
+            std::atomic<size_t> finished{};
+            size_t total{};
+            std::mutex lock;
+            std::condition_variable condition;
+        };
+
+        group_state* group{};
+        uint32_t length{};
+        uint32_t steps{};
+    };
+
+    auto const run_chains = [](size_t count, uint32_t length)
+    {
+        chain::group_state group;
+        group.total = count;
+        std::vector<chain> chains(count);
+        for (auto& current : chains)
+        {
+            current.group = &group;
+            current.length = length;
+            xlang_submit_threadpool_callback(chain::step, &current);
+        }
+        group.wait();
+    };
+
+    BENCHMARK("Submit 1M callbacks from one thread")
+    {
+        run_chains(1000000, 1);
+    }
+
+    BENCHMARK("Resume 10k concurrent chains 100 times each")
+    {
+        run_chains(10000, 100);
+    }
+
+    BENCHMARK("Resume 1M concurrent chains once each")
+    {
+        run_chains(1000000, 2);
+    }
+
+    BENCHMARK("Arm and close 100k timers")
+    {
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            xlang_threadpool_timer timer{};
+            xlang_create_threadpool_timer(chain::step, nullptr, &timer);
+            xlang_set_threadpool_timer(timer, 10000000);
+            xlang_close_threadpool_timer(timer);
+        }
+    }
+}
+
+TEST_CASE("Wait on address benchmarks", "[.benchmark]")
+{
+    constexpr uint32_t round_trips = 100000;
+
+    // Two threads take turns incrementing a counter, blocking until it is their turn.
+    BENCHMARK("Hand off 100k times with a condition variable")
+    {
+        std::mutex lock;
+        std::condition_variable condition;
+        uint32_t turn{};
+        auto const player = [&](uint32_t parity)
+        {
+            for (uint32_t i = 0; i < round_trips; ++i)
+            {
+                std::unique_lock guard(lock);
+                condition.wait(guard, [&] { return turn % 2 == parity; });
+                ++turn;
+                condition.notify_one();
+            }
+        };
+        std::thread other(player, 1);
+        player(0);
+        other.join();
+    }
+
+    BENCHMARK("Hand off 100k times with wait on address")
+    {
+        std::atomic<uint32_t> turn{};
+        auto const player = [&](uint32_t parity)
+        {
+            for (uint32_t i = 0; i < round_trips; ++i)
+            {
+                uint32_t current = turn.load();
+                while (current % 2 != parity)
+                {
+                    xlang_wait_on_address(&turn, current);
+                    current = turn.load();
+                }
+                turn.store(current + 1);
+                xlang_wake_by_address_all(&turn);
+            }
+        };
+        std::thread other(player, 1);
+        player(0);
+        other.join();
+    }
+}
@@ -211,4 +211,139 @@ TEST_CASE("Error origination with all parameters")
     propagated_error = nullptr;
     REQUIRE(result->Release() == 0);
     result = nullptr;
-}
\ No newline at end of file
+}
+TEST_CASE("Error origination with a static message")
+{
+    auto const message = u8"Static error message";
+
+    INFO("Originating error");
+    xlang_error_info* result = xlang_originate_static_error(xlang_result::type_load, message);
+    REQUIRE(result != nullptr);
+
+    xlang_result error{};
+    result->GetError(&error);
+    REQUIRE(error == xlang_result::type_load);
+
+    INFO("The message is materialized as an interned string on request");
+    xlang_string abi_message{};
+    result->GetMessage(&abi_message);
+    REQUIRE(abi_message != nullptr);
+
+    xlang_char8 const* buffer{};
+    uint32_t length{};
+    REQUIRE(xlang_get_string_raw_buffer_utf8(abi_message, &buffer, &length) == nullptr);
+    REQUIRE(basic_string_view<xlang_char8>{ buffer, length } == message);
+
+    xlang_string interned{};
+    REQUIRE(xlang_intern_string_utf8(message, length, &interned) == nullptr);
+    REQUIRE(abi_message == interned);
+
+    xlang_string abi_message2{};
+    result->GetMessage(&abi_message2);
+    REQUIRE(abi_message2 == abi_message);
+
+    INFO("Propagated errors carry the static message");
+    result->PropagateError(nullptr, nullptr, nullptr, nullptr);
+    xlang_error_info* propagated_error{};
+    result->GetPropagatedError(&propagated_error);
+    REQUIRE(propagated_error != nullptr);
+    xlang_string propagated_message{};
+    propagated_error->GetMessage(&propagated_message);
+    REQUIRE(propagated_message == abi_message);
+
+    REQUIRE(propagated_error->Release() == 1);
+    REQUIRE(result->Release() == 0);
+}
+
+TEST_CASE("Error origination without a message")
+{
+    xlang_error_info* result = xlang_originate_static_error(xlang_result::no_interface);
+    REQUIRE(result != nullptr);
+    verify_error_info(result, xlang_result::no_interface);
+
+    INFO("Released errors are recycled on the originating thread");
+    xlang_error_info* const first = result;
+    REQUIRE(result->Release() == 0);
+    result = xlang_originate_error(xlang_result::not_impl);
+    REQUIRE(result == first);
+    verify_error_info(result, xlang_result::not_impl);
+    REQUIRE(result->Release() == 0);
+}
+
+TEST_CASE("Execution traces are not captured by default")
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        xlang_error_info* result = xlang_originate_error(xlang_result::fail);
+        verify_error_info(result, xlang_result::fail);
+        REQUIRE(result->Release() == 0);
+    }
+}
+
+TEST_CASE("Execution trace capture")
+{
+    xlang_set_execution_trace_sampling(1);
+
+    xlang_error_info* result = xlang_originate_error(xlang_result::fail);
+    xlang_unknown* unknown{};
+    result->GetExecutionTrace(&unknown);
+    REQUIRE(unknown != nullptr);
+
+    xlang_execution_trace* trace{};
+    REQUIRE(unknown->QueryInterface(xlang_execution_trace_guid, reinterpret_cast<void**>(&trace)) == 0);
+    REQUIRE(trace != nullptr);
+    unknown->Release();
+
+    REQUIRE(trace->GetFrameCount() > 0);
+    REQUIRE(trace->GetFrameAddress(0) != nullptr);
+    REQUIRE(trace->GetFrameAddress(trace->GetFrameCount()) == nullptr);
+
+    {
+        INFO("Frames are described on request");
+        xlang_string description{};
+        REQUIRE(trace->GetFrameDescription(0, &description) == nullptr);
+        REQUIRE(description != nullptr);
+        xlang_delete_string(description);
+
+        xlang_error_info* error = trace->GetFrameDescription(trace->GetFrameCount(), &description);
+        REQUIRE(error != nullptr);
+        REQUIRE(description == nullptr);
+        error->Release();
+    }
+
+    trace->Release();
+    REQUIRE(result->Release() == 0);
+
+    {
+        INFO("A caller supplied trace takes precedence");
+        xlang_unknown* supplied = new information(false);
+        result = xlang_originate_error(xlang_result::fail, nullptr, nullptr, nullptr, supplied);
+        verify_error_info(result, xlang_result::fail, nullptr, nullptr, nullptr, supplied);
+        REQUIRE(result->Release() == 0);
+        supplied->Release();
+    }
+
+    {
+        INFO("Sampling captures one trace per interval");
+        xlang_set_execution_trace_sampling(2);
+        int captured{};
+        for (int i = 0; i < 8; ++i)
+        {
+            result = xlang_originate_error(xlang_result::fail);
+            result->GetExecutionTrace(&unknown);
+            if (unknown)
+            {
+                ++captured;
+                unknown->Release();
+            }
+            result->Release();
+        }
+        REQUIRE(captured == 4);
+    }
+
+    xlang_set_execution_trace_sampling(0);
+    result = xlang_originate_error(xlang_result::fail);
+    result->GetExecutionTrace(&unknown);
+    REQUIRE(unknown == nullptr);
+    result->Release();
+}
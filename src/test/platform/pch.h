@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <limits>
 #include <string_view>
+#include <vector>
 
 #if XLANG_PLATFORM_WINDOWS
 #include <winrt/base.h>
@@ -508,3 +508,286 @@ TEST_CASE("Convert UTF-16 string reference")
 {
     convert_string_reference<char16_t>();
 }
+
+template <typename char_type>
+void simple_interned()
+{
+    using other_type = typename alternate_type<char_type>::type;
+    for (size_t i = 0; i < std::size(valid_strings<char_type>::value); ++i)
+    {
+        auto const test_string = valid_strings<char_type>::value[i];
+        xlang_error_info* result{};
+        xlang_string str{};
+        {
+            INFO("Intern a valid string");
+            result = xlang_intern_string<char_type>(test_string.data(), static_cast<uint32_t>(test_string.size()), &str);
+            REQUIRE(result == nullptr);
+            REQUIRE(has_encoding<char_type>(str));
+            REQUIRE(has_encoding<other_type>(str));
+        }
+
+        {
+            INFO("Both encodings match the supplied string");
+            char_type const* buffer{};
+            uint32_t length{};
+            result = xlang_get_string_raw_buffer<char_type>(str, &buffer, &length);
+            REQUIRE(result == nullptr);
+            REQUIRE(test_string == basic_string_view<char_type>{buffer, length});
+
+            other_type const* other_buffer{};
+            uint32_t other_length{};
+            result = xlang_get_string_raw_buffer<other_type>(str, &other_buffer, &other_length);
+            REQUIRE(result == nullptr);
+            REQUIRE(valid_strings<other_type>::value[i] == basic_string_view<other_type>{other_buffer, other_length});
+        }
+
+        {
+            INFO("Interning the same contents in either encoding returns the same handle");
+            xlang_string same{};
+            result = xlang_intern_string<char_type>(test_string.data(), static_cast<uint32_t>(test_string.size()), &same);
+            REQUIRE(result == nullptr);
+            REQUIRE(same == str);
+
+            auto const other_string = valid_strings<other_type>::value[i];
+            result = xlang_intern_string<other_type>(other_string.data(), static_cast<uint32_t>(other_string.size()), &same);
+            REQUIRE(result == nullptr);
+            REQUIRE(same == str);
+        }
+
+        {
+            INFO("Duplicating and deleting interned strings are no-ops");
+            xlang_string str2{};
+            result = xlang_duplicate_string(str, &str2);
+            REQUIRE(result == nullptr);
+            REQUIRE(str2 == str);
+            xlang_delete_string(str2);
+            xlang_delete_string(str);
+
+            char_type const* buffer{};
+            uint32_t length{};
+            result = xlang_get_string_raw_buffer<char_type>(str, &buffer, &length);
+            REQUIRE(result == nullptr);
+            REQUIRE(test_string == basic_string_view<char_type>{buffer, length});
+        }
+    }
+
+    for (auto const& test_string : invalid_strings<char_type>::value)
+    {
+        xlang_error_info* result{};
+        xlang_result error_code{};
+        xlang_string str{};
+
+        INFO("Fail to intern an untranslatable string");
+        result = xlang_intern_string<char_type>(test_string.data(), static_cast<uint32_t>(test_string.size()), &str);
+        REQUIRE(result != nullptr);
+        result->GetError(&error_code);
+        REQUIRE(error_code == xlang_result::invalid_arg);
+        REQUIRE(str == nullptr);
+    }
+}
+
+TEST_CASE("Interned UTF-8 strings")
+{
+    simple_interned<xlang_char8>();
+}
+
+TEST_CASE("Interned UTF-16 strings")
+{
+    simple_interned<char16_t>();
+}
+
+TEST_CASE("Interned strings are distinct from heap strings")
+{
+    auto const test_string = u8"Windows.Foundation.Uri"sv;
+    xlang_string interned{};
+    REQUIRE(xlang_intern_string_utf8(test_string.data(), static_cast<uint32_t>(test_string.size()), &interned) == nullptr);
+
+    xlang_string heap{};
+    REQUIRE(xlang_create_string_utf8(test_string.data(), static_cast<uint32_t>(test_string.size()), &heap) == nullptr);
+    REQUIRE(heap != interned);
+
+    xlang_string other{};
+    auto const other_string = u8"Windows.Foundation.Url"sv;
+    REQUIRE(xlang_intern_string_utf8(other_string.data(), static_cast<uint32_t>(other_string.size()), &other) == nullptr);
+    REQUIRE(other != interned);
+
+    xlang_delete_string(heap);
+}
+
+template <typename char_type>
+void batch_strings()
+{
+    using other_type = typename alternate_type<char_type>::type;
+    constexpr size_t count = std::size(valid_strings<char_type>::value);
+
+    basic_string<char_type> packed;
+    uint32_t lengths[count]{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const test_string = valid_strings<char_type>::value[i];
+        packed.append(test_string.data(), test_string.size());
+        lengths[i] = static_cast<uint32_t>(test_string.size());
+    }
+
+    xlang_string strings[count]{};
+    xlang_error_info* result{};
+    {
+        INFO("Create a batch of strings");
+        result = xlang_create_strings<char_type>(static_cast<uint32_t>(count), lengths, packed.data(), strings);
+        REQUIRE(result == nullptr);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        INFO("Each string matches its source and converts independently");
+        auto const test_string = valid_strings<char_type>::value[i];
+        REQUIRE((strings[i] == nullptr) == test_string.empty());
+
+        char_type const* buffer{};
+        uint32_t length{};
+        result = xlang_get_string_raw_buffer<char_type>(strings[i], &buffer, &length);
+        REQUIRE(result == nullptr);
+        REQUIRE(test_string == basic_string_view<char_type>{buffer, length});
+        REQUIRE(buffer[length] == 0);
+
+        other_type const* other_buffer{};
+        uint32_t other_length{};
+        result = xlang_get_string_raw_buffer<other_type>(strings[i], &other_buffer, &other_length);
+        REQUIRE(result == nullptr);
+        REQUIRE(valid_strings<other_type>::value[i] == basic_string_view<other_type>{other_buffer, other_length});
+    }
+
+    xlang_string duplicate{};
+    size_t const last = count - 1;
+    {
+        INFO("Duplicating a batch string shares the buffer");
+        result = xlang_duplicate_string(strings[last], &duplicate);
+        REQUIRE(result == nullptr);
+        REQUIRE(duplicate == strings[last]);
+    }
+
+    {
+        INFO("Strings outlive the batch while any one of them is referenced");
+        xlang_delete_string(strings[0]);
+        xlang_delete_strings(static_cast<uint32_t>(count - 1), strings + 1);
+
+        char_type const* buffer{};
+        uint32_t length{};
+        result = xlang_get_string_raw_buffer<char_type>(duplicate, &buffer, &length);
+        REQUIRE(result == nullptr);
+        REQUIRE(valid_strings<char_type>::value[last] == basic_string_view<char_type>{buffer, length});
+        xlang_delete_string(duplicate);
+    }
+
+    {
+        INFO("A batch of only empty strings doesn't allocate");
+        uint32_t const empty_lengths[2]{};
+        xlang_string empty_strings[2]{};
+        result = xlang_create_strings<char_type>(2, empty_lengths, nullptr, empty_strings);
+        REQUIRE(result == nullptr);
+        REQUIRE(empty_strings[0] == nullptr);
+        REQUIRE(empty_strings[1] == nullptr);
+    }
+
+    {
+        INFO("Missing source characters are rejected");
+        xlang_result error_code{};
+        result = xlang_create_strings<char_type>(static_cast<uint32_t>(count), lengths, nullptr, strings);
+        REQUIRE(result != nullptr);
+        result->GetError(&error_code);
+        REQUIRE(error_code == xlang_result::pointer);
+        REQUIRE(std::all_of(std::begin(strings), std::end(strings), [](xlang_string str) { return str == nullptr; }));
+    }
+}
+
+TEST_CASE("Batch UTF-8 strings")
+{
+    batch_strings<xlang_char8>();
+}
+
+TEST_CASE("Batch UTF-16 strings")
+{
+    batch_strings<char16_t>();
+}
+
+TEST_CASE("Batch delete mixes string kinds")
+{
+    auto const test_string = u8"mixed"sv;
+    uint32_t const lengths[] = { 5, 5 };
+    xlang_string strings[5]{};
+    REQUIRE(xlang_create_strings_utf8(2, lengths, u8"firstsecnd", strings) == nullptr);
+    REQUIRE(xlang_create_string_utf8(test_string.data(), static_cast<uint32_t>(test_string.size()), &strings[2]) == nullptr);
+    REQUIRE(xlang_intern_string_utf8(test_string.data(), static_cast<uint32_t>(test_string.size()), &strings[3]) == nullptr);
+    strings[4] = nullptr;
+
+    xlang_delete_strings(static_cast<uint32_t>(std::size(strings)), strings);
+}
+
+TEST_CASE("String statistics")
+{
+    auto const test_string = u8"Windows.Foundation.Uri"sv;
+    auto const length = static_cast<uint32_t>(test_string.size());
+
+    xlang_string_statistics before{};
+    xlang_get_string_statistics(&before);
+
+    xlang_string str{};
+    REQUIRE(xlang_create_string_utf8(test_string.data(), length, &str) == nullptr);
+
+    xlang_string_statistics after{};
+    {
+        INFO("Creating a heap string is counted");
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.heap_strings_created == before.heap_strings_created + 1);
+        REQUIRE(after.live_utf8_strings == before.live_utf8_strings + 1);
+        REQUIRE(after.live_utf16_strings == before.live_utf16_strings);
+        REQUIRE(after.bytes_held > before.bytes_held);
+    }
+
+    {
+        INFO("Requesting the alternate encoding creates a cache");
+        char16_t const* buffer{};
+        uint32_t buffer_length{};
+        REQUIRE(xlang_get_string_raw_buffer_utf16(str, &buffer, &buffer_length) == nullptr);
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.utf16_caches_created == before.utf16_caches_created + 1);
+        REQUIRE(after.utf8_caches_created == before.utf8_caches_created);
+
+        REQUIRE(xlang_get_string_raw_buffer_utf16(str, &buffer, &buffer_length) == nullptr);
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.utf16_caches_created == before.utf16_caches_created + 1);
+    }
+
+    {
+        INFO("String references are counted separately from heap strings");
+        xlang_string_header header{};
+        xlang_string str_ref{};
+        REQUIRE(xlang_create_string_reference_utf8(test_string.data(), length, &header, &str_ref) == nullptr);
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.reference_strings_created == before.reference_strings_created + 1);
+        REQUIRE(after.heap_strings_created == before.heap_strings_created + 1);
+        xlang_delete_string(str_ref);
+    }
+
+    {
+        INFO("Batch strings are counted per string");
+        uint32_t const lengths[] = { length, length };
+        basic_string<xlang_char8> packed{ test_string };
+        packed += test_string;
+        xlang_string strings[2]{};
+        REQUIRE(xlang_create_strings_utf8(2, lengths, packed.data(), strings) == nullptr);
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.batch_strings_created == before.batch_strings_created + 2);
+        REQUIRE(after.live_utf8_strings == before.live_utf8_strings + 3);
+        xlang_delete_strings(2, strings);
+    }
+
+    {
+        INFO("Releasing strings returns live counts and bytes to where they started");
+        xlang_delete_string(str);
+        xlang_get_string_statistics(&after);
+        REQUIRE(after.live_utf8_strings == before.live_utf8_strings);
+        REQUIRE(after.live_utf16_strings == before.live_utf16_strings);
+        REQUIRE(after.bytes_held == before.bytes_held);
+    }
+}
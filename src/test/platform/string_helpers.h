@@ -30,6 +30,34 @@ auto xlang_create_string_reference(char_type const* source, uint32_t length, xla
     }
 }
 
+template <typename char_type>
+auto xlang_intern_string(char_type const* source, uint32_t length, xlang_string* str)
+{
+    static_assert(std::disjunction_v<std::is_same<char_type, xlang_char8>, std::is_same<char_type, char16_t>>);
+    if constexpr (std::is_same_v<char_type, xlang_char8>)
+    {
+        return xlang_intern_string_utf8(source, length, str);
+    }
+    else
+    {
+        return xlang_intern_string_utf16(source, length, str);
+    }
+}
+
+template <typename char_type>
+auto xlang_create_strings(uint32_t count, uint32_t const* lengths, char_type const* source_strings, xlang_string* strings)
+{
+    static_assert(std::disjunction_v<std::is_same<char_type, xlang_char8>, std::is_same<char_type, char16_t>>);
+    if constexpr (std::is_same_v<char_type, xlang_char8>)
+    {
+        return xlang_create_strings_utf8(count, lengths, source_strings, strings);
+    }
+    else
+    {
+        return xlang_create_strings_utf16(count, lengths, source_strings, strings);
+    }
+}
+
 template <typename char_type>
 auto xlang_get_string_raw_buffer(xlang_string str, char_type const* * buffer, uint32_t* length)
 {
@@ -0,0 +1,487 @@
+#include "pch.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if XLANG_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace
+{
+    constexpr auto test_timeout = 10s;
+
+    int64_t to_intervals(chrono::milliseconds value)
+    {
+        return chrono::duration_cast<chrono::duration<int64_t, ratio<1, 10000000>>>(value).count();
+    }
+
+    // Counts callbacks, so that a test can block until the expected number have run.
+    struct completion
+    {
+        void signal()
+        {
+            // Notify under the lock, since the waiter may destroy this as soon as it observes the count.
+            lock_guard const guard(lock);
+            ++count;
+            condition.notify_all();
+        }
+
+        bool wait(uint32_t expected)
+        {
+            unique_lock guard(lock);
+            return condition.wait_for(guard, test_timeout, [&] { return count >= expected; });
+        }
+
+        uint32_t get_count()
+        {
+            lock_guard const guard(lock);
+            return count;
+        }
+
+        static void XLANG_CALL callback(void* context) noexcept
+        {
+            static_cast<completion*>(context)->signal();
+        }
+
+        mutex lock;
+        condition_variable condition;
+        uint32_t count{};
+    };
+
+    struct wait_result : completion
+    {
+        static void XLANG_CALL wait_callback(void* context, bool signaled) noexcept
+        {
+            auto that = static_cast<wait_result*>(context);
+            that->signaled = signaled;
+            that->signal();
+        }
+
+        atomic<bool> signaled{};
+    };
+
+    // A handle that the thread pool can wait on: an event on Windows, and the read end of a pipe elsewhere.
+    struct test_signal
+    {
+#if XLANG_PLATFORM_WINDOWS
+        test_signal() : event{ ::CreateEventW(nullptr, true, false, nullptr) }
+        {
+            REQUIRE(event != nullptr);
+        }
+
+        ~test_signal()
+        {
+            ::CloseHandle(event);
+        }
+
+        void* handle() const noexcept
+        {
+            return event;
+        }
+
+        void set() const
+        {
+            REQUIRE(::SetEvent(event));
+        }
+
+        HANDLE event;
+#else
+        test_signal()
+        {
+            REQUIRE(::pipe(fds) == 0);
+        }
+
+        ~test_signal()
+        {
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+
+        void* handle() const noexcept
+        {
+            return reinterpret_cast<void*>(static_cast<intptr_t>(fds[0]));
+        }
+
+        void set() const
+        {
+            char const value{};
+            REQUIRE(::write(fds[1], &value, 1) == 1);
+        }
+
+        int fds[2]{ -1, -1 };
+#endif
+    };
+}
+
+TEST_CASE("Thread pool callbacks")
+{
+    xlang_error_info* error = xlang_submit_threadpool_callback(nullptr, nullptr);
+    REQUIRE(error != nullptr);
+    error->Release();
+
+    completion done;
+    constexpr uint32_t count = 1000;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        REQUIRE(xlang_submit_threadpool_callback(completion::callback, &done) == nullptr);
+    }
+    REQUIRE(done.wait(count));
+}
+
+TEST_CASE("Thread pool callbacks submitted from callbacks")
+{
+    struct chain
+    {
+        static void XLANG_CALL step(void* context) noexcept
+        {
+            auto that = static_cast<chain*>(context);
+            if (++that->steps == 100)
+            {
+                that->done.signal();
+            }
+            else
+            {
+                xlang_submit_threadpool_callback(step, that);
+            }
+        }
+
+        atomic<uint32_t> steps{};
+        completion done;
+    };
+
+    chain chains[16];
+    for (auto& current : chains)
+    {
+        REQUIRE(xlang_submit_threadpool_callback(chain::step, &current) == nullptr);
+    }
+    for (auto& current : chains)
+    {
+        REQUIRE(current.done.wait(1));
+        REQUIRE(current.steps == 100);
+    }
+}
+
+TEST_CASE("Thread pool callbacks run concurrently")
+{
+    // Each callback waits for the other to start, which can only succeed on separate threads.
+    struct rendezvous
+    {
+        static void XLANG_CALL callback(void* context) noexcept
+        {
+            auto that = static_cast<rendezvous*>(context);
+            unique_lock guard(that->lock);
+            ++that->arrived;
+            that->condition.notify_all();
+            if (that->condition.wait_for(guard, test_timeout, [&] { return that->arrived == 2; }))
+            {
+                ++that->met;
+            }
+            that->done.notify_all();
+        }
+
+        mutex lock;
+        condition_variable condition;
+        condition_variable done;
+        uint32_t arrived{};
+        uint32_t met{};
+    };
+
+    rendezvous state;
+    REQUIRE(xlang_submit_threadpool_callback(rendezvous::callback, &state) == nullptr);
+    REQUIRE(xlang_submit_threadpool_callback(rendezvous::callback, &state) == nullptr);
+
+    unique_lock guard(state.lock);
+    REQUIRE(state.done.wait_for(guard, test_timeout, [&] { return state.met == 2; }));
+}
+
+TEST_CASE("Thread pool callbacks waiting for nested callbacks")
+{
+    // Each callback blocks until a callback that it queues has run, waiting the way get() does on an
+    // async operation. With many more of them than there are workers, this only completes promptly
+    // because the pool replaces each worker as it blocks.
+    struct nested
+    {
+        static void XLANG_CALL outer(void* context) noexcept
+        {
+            auto that = static_cast<nested*>(context);
+            atomic<uint32_t> inner{};
+            if (xlang_submit_threadpool_callback(nested::inner, &inner) == nullptr)
+            {
+                while (inner.load() == 0)
+                {
+                    xlang_wait_on_address(&inner, 0);
+                }
+
+                that->done.signal();
+            }
+        }
+
+        static void XLANG_CALL inner(void* context) noexcept
+        {
+            auto value = static_cast<atomic<uint32_t>*>(context);
+            value->store(1);
+            xlang_wake_by_address_all(value);
+        }
+
+        completion done;
+    };
+
+    nested state;
+    uint32_t const count = max(2u, thread::hardware_concurrency()) * 8;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        REQUIRE(xlang_submit_threadpool_callback(nested::outer, &state) == nullptr);
+    }
+    REQUIRE(state.done.wait(count));
+    REQUIRE(state.done.get_count() == count);
+}
+
+TEST_CASE("Thread pool callbacks blocking without a hint")
+{
+    // The pool can't tell these callbacks from busy ones, so it only adds workers once they have made
+    // no progress for a while. One more of them than there are workers still completes.
+    struct nested
+    {
+        static void XLANG_CALL outer(void* context) noexcept
+        {
+            auto that = static_cast<nested*>(context);
+            completion inner;
+            if (xlang_submit_threadpool_callback(completion::callback, &inner) == nullptr && inner.wait(1))
+            {
+                that->done.signal();
+            }
+        }
+
+        completion done;
+    };
+
+    nested state;
+    uint32_t const count = max(2u, thread::hardware_concurrency()) + 1;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        REQUIRE(xlang_submit_threadpool_callback(nested::outer, &state) == nullptr);
+    }
+    REQUIRE(state.done.wait(count));
+    REQUIRE(state.done.get_count() == count);
+}
+
+TEST_CASE("Thread pool callbacks keeping workers busy")
+{
+    // Callbacks that spin without blocking stall the backlog for as long as the pool's starvation check
+    // waits. The pool may add a worker per queue for them, but must not keep adding threads.
+    struct busy
+    {
+        static void XLANG_CALL callback(void* context) noexcept
+        {
+            auto that = static_cast<busy*>(context);
+            uint32_t const running = ++that->running;
+            uint32_t peak = that->peak.load();
+            while (running > peak && !that->peak.compare_exchange_weak(peak, running))
+            {
+            }
+
+            while (!that->release.load())
+            {
+            }
+
+            --that->running;
+            that->done.signal();
+        }
+
+        atomic<uint32_t> running{};
+        atomic<uint32_t> peak{};
+        atomic<bool> release{};
+        completion done;
+    };
+
+    // Let compensating workers left over from earlier tests run out of work and exit.
+    this_thread::sleep_for(100ms);
+
+    busy state;
+    uint32_t const workers = max(2u, thread::hardware_concurrency());
+    uint32_t const count = workers * 8;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        REQUIRE(xlang_submit_threadpool_callback(busy::callback, &state) == nullptr);
+    }
+
+    this_thread::sleep_for(1s);
+    state.release.store(true);
+    REQUIRE(state.done.wait(count));
+    REQUIRE(state.peak.load() <= workers * 2);
+}
+
+TEST_CASE("Thread pool timers")
+{
+    xlang_threadpool_timer timer{};
+    xlang_error_info* error = xlang_create_threadpool_timer(nullptr, nullptr, &timer);
+    REQUIRE(error != nullptr);
+    error->Release();
+    REQUIRE(timer == nullptr);
+
+    SECTION("Expires after the due time")
+    {
+        completion done;
+        REQUIRE(xlang_create_threadpool_timer(completion::callback, &done, &timer) == nullptr);
+        auto const start = chrono::steady_clock::now();
+        xlang_set_threadpool_timer(timer, to_intervals(20ms));
+        REQUIRE(done.wait(1));
+        REQUIRE(chrono::steady_clock::now() - start >= 20ms);
+        xlang_close_threadpool_timer(timer);
+        REQUIRE(done.get_count() == 1);
+    }
+
+    SECTION("Expires immediately")
+    {
+        completion done;
+        REQUIRE(xlang_create_threadpool_timer(completion::callback, &done, &timer) == nullptr);
+        xlang_set_threadpool_timer(timer, 0);
+        REQUIRE(done.wait(1));
+        xlang_close_threadpool_timer(timer);
+    }
+
+    SECTION("Setting again replaces the due time")
+    {
+        completion done;
+        REQUIRE(xlang_create_threadpool_timer(completion::callback, &done, &timer) == nullptr);
+        xlang_set_threadpool_timer(timer, to_intervals(1h));
+        xlang_set_threadpool_timer(timer, to_intervals(10ms));
+        REQUIRE(done.wait(1));
+        this_thread::sleep_for(20ms);
+        REQUIRE(done.get_count() == 1);
+        xlang_close_threadpool_timer(timer);
+    }
+
+    SECTION("Closing cancels the timer")
+    {
+        completion done;
+        REQUIRE(xlang_create_threadpool_timer(completion::callback, &done, &timer) == nullptr);
+        xlang_set_threadpool_timer(timer, to_intervals(20ms));
+        xlang_close_threadpool_timer(timer);
+        this_thread::sleep_for(50ms);
+        REQUIRE(done.get_count() == 0);
+    }
+
+    SECTION("Closing from the callback")
+    {
+        struct self_closing
+        {
+            static void XLANG_CALL callback(void* context) noexcept
+            {
+                auto that = static_cast<self_closing*>(context);
+                xlang_close_threadpool_timer(that->timer);
+                that->done.signal();
+            }
+
+            xlang_threadpool_timer timer{};
+            completion done;
+        };
+
+        self_closing state;
+        REQUIRE(xlang_create_threadpool_timer(self_closing::callback, &state, &state.timer) == nullptr);
+        xlang_set_threadpool_timer(state.timer, to_intervals(1ms));
+        REQUIRE(state.done.wait(1));
+    }
+
+    SECTION("Many timers spanning more than one revolution of the wheel")
+    {
+        completion done;
+        constexpr uint32_t count = 1000;
+        vector<xlang_threadpool_timer> timers(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            REQUIRE(xlang_create_threadpool_timer(completion::callback, &done, &timers[i]) == nullptr);
+            xlang_set_threadpool_timer(timers[i], to_intervals(chrono::milliseconds{ (i * 7) % 700 }));
+        }
+        REQUIRE(done.wait(count));
+        for (auto current : timers)
+        {
+            xlang_close_threadpool_timer(current);
+        }
+        REQUIRE(done.get_count() == count);
+    }
+}
+
+TEST_CASE("Thread pool waits")
+{
+    xlang_threadpool_wait wait{};
+    xlang_error_info* error = xlang_create_threadpool_wait(nullptr, nullptr, &wait);
+    REQUIRE(error != nullptr);
+    error->Release();
+    REQUIRE(wait == nullptr);
+
+    test_signal signal;
+    wait_result result;
+    REQUIRE(xlang_create_threadpool_wait(wait_result::wait_callback, &result, &wait) == nullptr);
+
+    SECTION("Signaled")
+    {
+        xlang_set_threadpool_wait(wait, signal.handle(), 0);
+        this_thread::sleep_for(10ms);
+        REQUIRE(result.get_count() == 0);
+        signal.set();
+        REQUIRE(result.wait(1));
+        REQUIRE(result.signaled);
+    }
+
+    SECTION("Already signaled")
+    {
+        signal.set();
+        xlang_set_threadpool_wait(wait, signal.handle(), to_intervals(1h));
+        REQUIRE(result.wait(1));
+        REQUIRE(result.signaled);
+    }
+
+    SECTION("Timed out")
+    {
+        auto const start = chrono::steady_clock::now();
+        xlang_set_threadpool_wait(wait, signal.handle(), to_intervals(20ms));
+        REQUIRE(result.wait(1));
+        REQUIRE(!result.signaled);
+        REQUIRE(chrono::steady_clock::now() - start >= 20ms);
+    }
+
+    SECTION("Closing cancels the wait")
+    {
+        xlang_set_threadpool_wait(wait, signal.handle(), to_intervals(20ms));
+        xlang_close_threadpool_wait(wait);
+        wait = nullptr;
+        signal.set();
+        this_thread::sleep_for(50ms);
+        REQUIRE(result.get_count() == 0);
+    }
+
+    REQUIRE(result.get_count() <= 1);
+    xlang_close_threadpool_wait(wait);
+}
+
+TEST_CASE("Wait on address")
+{
+    atomic<uint32_t> value{ 0 };
+
+    // Returns immediately when the value does not match.
+    xlang_wait_on_address(&value, 1);
+
+    thread waker([&]
+    {
+        this_thread::sleep_for(10ms);
+        value.store(1);
+        xlang_wake_by_address_all(&value);
+    });
+
+    while (value.load() == 0)
+    {
+        xlang_wait_on_address(&value, 0);
+    }
+
+    waker.join();
+    REQUIRE(value == 1);
+}
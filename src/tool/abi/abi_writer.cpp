@@ -1,7 +1,10 @@
 #include "pch.h"
 
+#include <atomic>
 #include <cctype>
 #include <cstring>
+#include <set>
+#include <thread>
 
 #include "abi_writer.h"
 #include "code_writers.h"
@@ -165,6 +168,83 @@ void writer::pop_contract_guards(std::size_t count)
     }
 }
 
+// Calls a function for each index in [0, count) on up to one task per hardware thread, each of which keeps pulling the
+// next index until there are none left. Every task gets its own function from makeFunc, along with any state it holds
+template <typename MakeFunc>
+static void for_each_concurrently(std::size_t count, MakeFunc const& makeFunc)
+{
+    std::atomic<std::size_t> next{ 0 };
+    std::size_t const taskCount = (std::min)(count,
+        static_cast<std::size_t>((std::max)(1u, std::thread::hardware_concurrency())));
+    task_group group;
+    for (std::size_t task = 0; task < taskCount; ++task)
+    {
+        group.add([&]()
+        {
+            auto func = makeFunc();
+            for (auto i = next++; i < count; i = next++)
+            {
+                func(i);
+            }
+        });
+    }
+    group.get();
+}
+
+void writer::enable_deferred_blocks(bool enable) noexcept
+{
+    // Deferring blocks only pays off when there are other threads to write them on
+    m_deferBlocks = enable && (std::thread::hardware_concurrency() > 1);
+}
+
+void writer::write_deferred(std::function<void(writer&)> block)
+{
+    if (!m_deferBlocks)
+    {
+        block(*this);
+        return;
+    }
+
+    // Everything written since the previous block goes in front of this one
+    m_deferredBlocks.emplace_back(flush_to_string(), std::move(block));
+}
+
+void writer::write_deferred_blocks()
+{
+    if (m_deferredBlocks.empty())
+    {
+        return;
+    }
+
+    auto deferred = std::move(m_deferredBlocks);
+    auto tail = flush_to_string();
+
+    std::vector<std::string> blocks(deferred.size());
+    for_each_concurrently(deferred.size(), [&]()
+    {
+        return [&, w = writer{ m_config }](std::size_t i) mutable
+        {
+            deferred[i].second(w);
+            blocks[i] = w.flush_to_string();
+        };
+    });
+
+    auto size = tail.size();
+    for (std::size_t i = 0; i < deferred.size(); ++i)
+    {
+        size += deferred[i].first.size() + blocks[i].size();
+    }
+
+    reserve(size);
+    for (std::size_t i = 0; i < deferred.size(); ++i)
+    {
+        write(deferred[i].first);
+        write(blocks[i]);
+    }
+
+    write(tail);
+}
+
 static void write_include_guard(writer& w, std::string_view ns)
 {
     if (w.config().lowercase_include_guard)
@@ -290,6 +370,21 @@ static void write_cpp_interface_forward_declarations(writer& w, type_cache const
     }
 }
 
+static void write_shared_generics_includes(writer& w, type_cache const& types)
+{
+    std::set<std::string_view> headers;
+    for (auto const& inst : types.generic_instantiations)
+    {
+        headers.insert(inst.get().shared_header_name());
+    }
+
+    for (auto header : headers)
+    {
+        w.write(R"^-^(#include "%.h"
+)^-^", header);
+    }
+}
+
 static void write_cpp_generic_definitions(writer& w, type_cache const& types)
 {
     w.write(R"^-^(// Parameterized interface forward declarations (C++)
@@ -297,7 +392,13 @@ static void write_cpp_generic_definitions(writer& w, type_cache const& types)
 // Collection interface definitions
 )^-^");
 
-    for (auto const& [name, inst] : types.generic_instantiations)
+    if (w.config().shared_generics)
+    {
+        write_shared_generics_includes(w, types);
+        return;
+    }
+
+    for (auto const& inst : types.generic_instantiations)
     {
         inst.get().write_cpp_forward_declaration(w);
     }
@@ -316,34 +417,6 @@ static void write_cpp_dependency_forward_declarations(writer& w, type_cache cons
     }
 }
 
-static void write_cpp_type_definitions(writer& w, type_cache const& types)
-{
-    for (auto const& enumType : types.enums)
-    {
-        enumType.get().write_cpp_definition(w);
-    }
-
-    for (auto const& structType : types.structs)
-    {
-        structType.get().write_cpp_definition(w);
-    }
-
-    for (auto const& delegateType : types.delegates)
-    {
-        delegateType.get().write_cpp_definition(w);
-    }
-
-    for (auto const& interfaceType : types.interfaces)
-    {
-        interfaceType.get().write_cpp_definition(w);
-    }
-
-    for (auto const& classType : types.classes)
-    {
-        classType.get().write_cpp_definition(w);
-    }
-}
-
 static void write_c_interface_forward_declarations(writer& w, type_cache const& types)
 {
     w.write("/* Forward Declarations */\n");
@@ -373,7 +446,13 @@ static void write_c_generic_definitions(writer& w, type_cache const& types)
 
 )^-^");
 
-    for (auto const& [name, inst] : types.generic_instantiations)
+    if (w.config().shared_generics)
+    {
+        write_shared_generics_includes(w, types);
+        return;
+    }
+
+    for (auto const& inst : types.generic_instantiations)
     {
         inst.get().write_c_forward_declaration(w);
     }
@@ -392,37 +471,86 @@ static void write_c_dependency_forward_declarations(writer& w, type_cache const&
     }
 }
 
-static void write_c_type_definitions(writer& w, type_cache const& types)
+template <typename T>
+static void write_type_definition(writer& cppWriter, writer& cWriter, T const& type)
 {
-    for (auto const& enumType : types.enums)
+    if constexpr (std::is_same_v<T, delegate_type> || std::is_same_v<T, interface_type>)
     {
-        enumType.get().write_c_definition(w);
+        type.write_definitions(cppWriter, cWriter);
     }
-
-    for (auto const& structType : types.structs)
+    else
     {
-        structType.get().write_c_definition(w);
+        type.write_cpp_definition(cppWriter);
+        type.write_c_definition(cWriter);
     }
+}
 
-    for (auto const& delegateType : types.delegates)
+// The C++ and C definitions of the types get written in a single pass. The C++ ones go straight to the header, while the
+// C ones get returned, one per type, to be written once the C interface has been declared. Keeping them apart instead of
+// in one growing buffer avoids copying them over and over as it grows. Headers that defer blocks write the definitions
+// of their types concurrently instead, and then splice them back in order
+static std::vector<std::string> write_type_definitions(writer& w, type_cache const& types)
+{
+    std::vector<std::function<void(writer&, writer&)>> definitions;
+    auto add = [&](auto const& typeList)
     {
-        delegateType.get().write_c_definition(w);
-    }
+        for (auto const& type : typeList)
+        {
+            definitions.emplace_back([&type = type.get()](writer& cppWriter, writer& cWriter)
+            {
+                write_type_definition(cppWriter, cWriter, type);
+            });
+        }
+    };
 
-    for (auto const& interfaceType : types.interfaces)
+    definitions.reserve(types.enums.size() + types.structs.size() + types.delegates.size() + types.interfaces.size() +
+        types.classes.size());
+    add(types.enums);
+    add(types.structs);
+    add(types.delegates);
+    add(types.interfaces);
+    add(types.classes);
+
+    std::vector<std::string> cDefinitions(definitions.size());
+    if (!w.defers_blocks())
     {
-        interfaceType.get().write_c_definition(w);
+        writer cWriter{ w.config() };
+        for (std::size_t i = 0; i < definitions.size(); ++i)
+        {
+            definitions[i](w, cWriter);
+            cDefinitions[i] = cWriter.flush_to_string();
+        }
+
+        return cDefinitions;
     }
 
-    for (auto const& classType : types.classes)
+    std::vector<std::string> cppDefinitions(definitions.size());
+    for_each_concurrently(definitions.size(), [&]()
     {
-        classType.get().write_c_definition(w);
+        return [&, cppWriter = writer{ w.config() }, cWriter = writer{ w.config() }](std::size_t i) mutable
+        {
+            definitions[i](cppWriter, cWriter);
+            cppDefinitions[i] = cppWriter.flush_to_string();
+            cDefinitions[i] = cWriter.flush_to_string();
+        };
+    });
+
+    for (auto const& definition : cppDefinitions)
+    {
+        w.write(definition);
     }
+
+    return cDefinitions;
 }
 
+// Only large headers are worth writing concurrently, since each thread costs more than writing a few definitions
+static constexpr std::size_t min_concurrent_definitions = 64;
+
 void write_abi_header(std::string_view fileName, abi_configuration const& config, type_cache const& types)
 {
     writer w{ config };
+    w.enable_deferred_blocks(types.enums.size() + types.structs.size() + types.delegates.size() +
+        types.interfaces.size() + types.classes.size() + types.generic_instantiations.size() >= min_concurrent_definitions);
 
     // All headers begin with a bit of boilerplate
     w.write(strings::file_header);
@@ -457,7 +585,7 @@ void write_abi_header(std::string_view fileName, abi_configuration const& config
     write_cpp_interface_forward_declarations(w, types);
     write_cpp_generic_definitions(w, types);
     write_cpp_dependency_forward_declarations(w, types);
-    write_cpp_type_definitions(w, types);
+    auto const cTypeDefinitions = write_type_definitions(w, types);
 
     // C interface
     w.write("#else // !defined(__cplusplus)\n");
@@ -466,7 +594,10 @@ void write_abi_header(std::string_view fileName, abi_configuration const& config
     write_c_interface_forward_declarations(w, types);
     write_c_generic_definitions(w, types);
     write_c_dependency_forward_declarations(w, types);
-    write_c_type_definitions(w, types);
+    for (auto const& definition : cTypeDefinitions)
+    {
+        w.write(definition);
+    }
 
     w.write("#endif // defined(__cplusplus)");
 
@@ -480,6 +611,96 @@ void write_abi_header(std::string_view fileName, abi_configuration const& config
         w.write(strings::deprecated_header_end);
     }
     w.write(strings::include_guard_end, bind<write_include_guard>(fileName), bind<write_include_guard>(fileName));
+    w.write_deferred_blocks();
+
+    auto filename{ config.output_directory };
+    filename += fileName;
+    filename += ".h";
+    w.flush_to_file(filename);
+}
+
+void write_shared_generics_header(
+    std::string_view fileName,
+    abi_configuration const& config,
+    std::vector<generic_inst const*> const& instantiations)
+{
+    writer w{ config };
+    w.enable_deferred_blocks(instantiations.size() >= min_concurrent_definitions);
+
+    w.write(strings::file_header);
+    w.write(strings::include_guard_start,
+        bind<write_include_guard>(fileName),
+        bind<write_include_guard>(fileName),
+        bind<write_include_guard>(fileName),
+        bind<write_include_guard>(fileName));
+
+    // Instantiations that belong to other shared headers are either arguments of the ones here, whose headers get
+    // included up front, or dependencies, which the namespaces using them include and which only need declaring here
+    std::set<std::string_view> includes;
+    std::vector<generic_inst const*> arguments;
+    std::vector<generic_inst const*> dependencies;
+    for (auto inst : instantiations)
+    {
+        for (auto param : inst->generic_params())
+        {
+            auto paramInst = dynamic_cast<generic_inst const*>(param);
+            if (paramInst && (paramInst->shared_header_name() != fileName))
+            {
+                includes.insert(paramInst->shared_header_name());
+                arguments.push_back(paramInst);
+            }
+        }
+
+        for (auto dependency : inst->dependencies)
+        {
+            if (dependency->shared_header_name() != fileName)
+            {
+                dependencies.push_back(dependency);
+            }
+        }
+    }
+
+    for (auto include : includes)
+    {
+        w.write(R"^-^(#include "%.h"
+)^-^", include);
+    }
+
+    auto declare = [&](generic_inst const* inst)
+    {
+        if (w.begin_declaration(inst->mangled_name()))
+        {
+            w.end_declaration(inst->mangled_name());
+        }
+    };
+
+    // C++ interface
+    w.write("\n#if defined(__cplusplus) && !defined(CINTERFACE)\n");
+    std::for_each(arguments.begin(), arguments.end(), declare);
+    std::for_each(dependencies.begin(), dependencies.end(), declare);
+    for (auto inst : instantiations)
+    {
+        inst->write_cpp_forward_declaration(w);
+    }
+
+    // C interface
+    w.write("#else // !defined(__cplusplus)\n");
+    w.begin_c_interface();
+    std::for_each(arguments.begin(), arguments.end(), declare);
+    for (auto dependency : dependencies)
+    {
+        w.begin_declaration(dependency->mangled_name());
+        dependency->write_c_forward_declaration(w);
+    }
+
+    for (auto inst : instantiations)
+    {
+        inst->write_c_forward_declaration(w);
+    }
+
+    w.write("#endif // defined(__cplusplus)\n");
+    w.write(strings::include_guard_end, bind<write_include_guard>(fileName), bind<write_include_guard>(fileName));
+    w.write_deferred_blocks();
 
     auto filename{ config.output_directory };
     filename += fileName;
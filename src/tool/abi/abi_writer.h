@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -231,10 +232,25 @@ struct writer : xlang::text::writer_base<writer>
         m_declaredTypes.clear();
     }
 
+    // Type definitions, including those of generic instantiations, don't depend on any of the state above, only on where
+    // they get written. Large headers write them concurrently into separate buffers. Those written through
+    // write_deferred get put off until the rest of the header is done, and then spliced back in where they were deferred
+    void enable_deferred_blocks(bool enable) noexcept;
+    bool defers_blocks() const noexcept
+    {
+        return m_deferBlocks;
+    }
+
+    void write_deferred(std::function<void(writer&)> block);
+    void write_deferred_blocks();
+
 private:
 
     abi_configuration const& m_config;
 
+    bool m_deferBlocks = false;
+    std::vector<std::pair<std::string, std::function<void(writer&)>>> m_deferredBlocks;
+
     std::size_t m_indentation = 0;
     std::vector<std::string_view> m_namespaceStack;
 
@@ -252,3 +268,9 @@ private:
 };
 
 void write_abi_header(std::string_view fileName, abi_configuration const& config, type_cache const& types);
+
+// Writes the generic instantiations that share a header when generics aren't written into each namespace's header
+void write_shared_generics_header(
+    std::string_view fileName,
+    abi_configuration const& config,
+    std::vector<generic_inst const*> const& instantiations);
@@ -181,26 +181,13 @@ inline void write_uuid(writer& w, typedef_base const& type)
 
 inline void write_generated_uuid(writer& w, metadata_type const& type)
 {
-    sha1 signatureHash;
-    static constexpr std::uint8_t namespaceGuidBytes[] =
-    {
-        0x11, 0xf4, 0x7a, 0xd5,
-        0x7b, 0x73,
-        0x42, 0xc0,
-        0xab, 0xae, 0x87, 0x8b, 0x1e, 0x16, 0xad, 0xee
-    };
-    signatureHash.append(namespaceGuidBytes, std::size(namespaceGuidBytes));
-    type.append_signature(signatureHash);
-
-    auto iidHash = signatureHash.finalize();
-    iidHash[6] = (iidHash[6] & 0x0F) | 0x50;
-    iidHash[8] = (iidHash[8] & 0x3F) | 0x80;
+    auto const& iid = type.generated_iid();
     w.write_printf("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-        iidHash[0], iidHash[1], iidHash[2], iidHash[3],
-        iidHash[4], iidHash[5],
-        iidHash[6], iidHash[7],
-        iidHash[8], iidHash[9],
-        iidHash[10], iidHash[11], iidHash[12], iidHash[13], iidHash[14], iidHash[15]);
+        iid[0], iid[1], iid[2], iid[3],
+        iid[4], iid[5],
+        iid[6], iid[7],
+        iid[8], iid[9],
+        iid[10], iid[11], iid[12], iid[13], iid[14], iid[15]);
 }
 
 inline void write_uuid(writer& w, generic_inst const& type)
@@ -26,6 +26,7 @@ struct abi_configuration
     bool enum_class = false;
     bool lowercase_include_guard = false;
     bool enable_header_deprecation = false;
+    bool shared_generics = false;
 
     std::string output_directory;
 };
@@ -205,19 +206,11 @@ struct deprecation_info
     std::string_view message;
 };
 
-template <typename T>
-inline std::optional<deprecation_info> is_deprecated(T const& type)
+inline std::optional<deprecation_info> decode_deprecation(xlang::meta::reader::CustomAttribute const& deprecatedAttr)
 {
-    using namespace std::literals;
     using namespace xlang::meta::reader;
 
-    auto attr = get_attribute(type, metadata_namespace, "DeprecatedAttribute"sv);
-    if (!attr)
-    {
-        return std::nullopt;
-    }
-
-    auto sig = attr.Value();
+    auto sig = deprecatedAttr.Value();
     auto const& fixedArgs = sig.FixedArgs();
 
     // There are three DeprecatedAttribute constructors, two of which deal with version numbers which we don't care
@@ -1,5 +1,11 @@
 #include "pch.h"
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <set>
+#include <thread>
+
 #include "abi_writer.h"
 #include "common.h"
 #include "metadata_cache.h"
@@ -47,7 +53,8 @@ int main(int const argc, char** argv)
             { "ns-prefix", 0, 1 },
             { "enum-class", 0, 0 },
             { "lowercase-include-guard", 0, 0 },
-            { "enable-header-deprecation", 0, 0 }
+            { "enable-header-deprecation", 0, 0 },
+            { "shared-generics", 0, 0 }
         };
 
         reader args{ argc, argv, options };
@@ -63,6 +70,7 @@ int main(int const argc, char** argv)
         config.enum_class = args.exists("enum-class");
         config.lowercase_include_guard = args.exists("lowercase-include-guard");
         config.enable_header_deprecation = args.exists("enable-header-deprecation");
+        config.shared_generics = args.exists("shared-generics");
 
         if (args.exists("ns-prefix"))
         {
@@ -148,7 +156,7 @@ int main(int const argc, char** argv)
         }
 
         filter f{ include, args.values("exclude") };
-        task_group group;
+        std::vector<std::function<void()>> headers;
         auto filter_includes = [&](namespace_cache const& types)
         {
             auto includes = [&](auto const& vector)
@@ -174,21 +182,37 @@ int main(int const argc, char** argv)
             return false;
         };
 
+        // When generics are shared, each instantiation used by any of the headers gets written once, to the shared header
+        // that it belongs to, rather than to every header that uses it
+        std::map<std::string_view, std::vector<generic_inst const*>> sharedGenerics;
+        std::set<generic_inst const*> sharedInstantiations;
+
         bool foundationDependency = false;
         for (auto const& [ns, nsTypes] : mdCache.namespaces)
         {
             // Headers are all or nothing. If the consumer is wanting one type in a namespace, they get everything
             if (filter_includes(nsTypes))
             {
+                if (config.shared_generics)
+                {
+                    for (auto const& inst : nsTypes.compiled.generic_instantiations)
+                    {
+                        if (sharedInstantiations.insert(&inst.get()).second)
+                        {
+                            sharedGenerics[inst.get().shared_header_name()].push_back(&inst.get());
+                        }
+                    }
+                }
+
                 if ((ns == foundation_namespace) || (ns == collections_namespace))
                 {
                     foundationDependency = true;
                 }
                 else
                 {
-                    group.add([&, ns = ns]()
+                    headers.push_back([&, ns = ns, &nsTypes = nsTypes]()
                     {
-                        write_abi_header(ns, config, mdCache.compile_namespaces({ ns }));
+                        write_abi_header(ns, config, nsTypes.compiled);
                     });
                 }
             }
@@ -196,7 +220,7 @@ int main(int const argc, char** argv)
 
         if (foundationDependency)
         {
-            group.add([&]()
+            headers.push_back([&]()
             {
                 // Write the 'Windows.Foundation.h' header. This is a merge of the 'Windows.Foundation' and the
                 // 'Windows.Foundation.Collections' namespacess
@@ -224,6 +248,30 @@ int main(int const argc, char** argv)
             });
         }
 
+        for (auto const& [name, instantiations] : sharedGenerics)
+        {
+            headers.push_back([&, name = name, &instantiations = instantiations]()
+            {
+                write_shared_generics_header(name, config, instantiations);
+            });
+        }
+
+        // Each header is buffered in memory until it is complete, so only write as many of them at a time as there are
+        // threads to write them on. Otherwise the peak memory use is the size of all of the headers combined
+        std::atomic<std::size_t> nextHeader{ 0 };
+        std::size_t const taskCount = (std::min)(headers.size(),
+            static_cast<std::size_t>((std::max)(1u, std::thread::hardware_concurrency())));
+        task_group group;
+        for (std::size_t task = 0; task < taskCount; ++task)
+        {
+            group.add([&]()
+            {
+                for (auto i = nextHeader++; i < headers.size(); i = nextHeader++)
+                {
+                    headers[i]();
+                }
+            });
+        }
         group.get();
 
         if (config.verbose)
@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <thread>
+
 #include "abi_writer.h"
 #include "code_writers.h"
 #include "metadata_cache.h"
@@ -45,6 +47,38 @@ metadata_cache::metadata_cache(xlang::meta::reader::cache const& c)
         });
     }
     group.get();
+
+    // Signatures and generated IIDs are cached on the types without any synchronization, so compute them for every
+    // generic instantiation now, before the headers get written in parallel. Nested instantiations and their arguments
+    // get cached along the way and are only hashed once
+    for (auto const& [key, inst] : m_genericInstantiations)
+    {
+        inst.generated_iid();
+    }
+
+    // Compile the contents of each namespace's header up front so that writing the headers only needs to stream
+    // through the sorted lists. Compiling a single namespace is cheap compared to starting a task, so each task takes
+    // an interleaved share of the namespaces
+    std::vector<std::pair<std::string_view const, namespace_cache>*> compileTargets;
+    compileTargets.reserve(namespaces.size());
+    for (auto& entry : namespaces)
+    {
+        compileTargets.push_back(&entry);
+    }
+
+    std::size_t const taskCount = (std::min)(compileTargets.size(),
+        static_cast<std::size_t>((std::max)(1u, std::thread::hardware_concurrency())));
+    for (std::size_t task = 0; task < taskCount; ++task)
+    {
+        group.add([&, task]()
+        {
+            for (auto i = task; i < compileTargets.size(); i += taskCount)
+            {
+                compileTargets[i]->second.compiled = compile_namespaces({ compileTargets[i]->first });
+            }
+        });
+    }
+    group.get();
 }
 
 void metadata_cache::process_namespace_types(
@@ -177,19 +211,23 @@ void metadata_cache::process_namespace_dependencies(namespace_cache& target)
     }
 }
 
-template <typename T>
-static void process_contract_dependencies(namespace_cache& target, T const& type)
+static void process_contract_dependencies(namespace_cache& target, versioning_info const* versioning)
 {
-    if (auto attr = get_contract_history(type))
+    if (!versioning)
     {
-        target.dependent_namespaces.emplace(decompose_type(attr->current_contract.type_name).first);
-        for (auto const& prevContract : attr->previous_contracts)
+        return;
+    }
+
+    if (auto const& history = versioning->history)
+    {
+        target.dependent_namespaces.emplace(decompose_type(history->current_contract.type_name).first);
+        for (auto const& prevContract : history->previous_contracts)
         {
             target.dependent_namespaces.emplace(decompose_type(prevContract.type_name).first);
         }
     }
 
-    if (auto info = is_deprecated(type))
+    if (auto const& info = versioning->deprecation)
     {
         target.dependent_namespaces.emplace(decompose_type(info->contract_type).first);
     }
@@ -199,28 +237,28 @@ void metadata_cache::process_enum_dependencies(init_state& state, enum_type& typ
 {
     // There's no pre-processing that we need to do for enums. Just take note of the namespace dependencies that come
     // from contract version(s)/deprecations
-    process_contract_dependencies(*state.target, type.type());
+    process_contract_dependencies(*state.target, &type.versioning());
 
     for (auto const& field : type.type().FieldList())
     {
-        process_contract_dependencies(*state.target, field);
+        process_contract_dependencies(*state.target, type.versioning(field));
     }
 }
 
 void metadata_cache::process_struct_dependencies(init_state& state, struct_type& type)
 {
-    process_contract_dependencies(*state.target, type.type());
+    process_contract_dependencies(*state.target, &type.versioning());
 
     for (auto const& field : type.type().FieldList())
     {
-        process_contract_dependencies(*state.target, field);
+        process_contract_dependencies(*state.target, type.versioning(field));
         type.members.push_back(struct_member{ field, &find_dependent_type(state, field.Signature().Type()) });
     }
 }
 
 void metadata_cache::process_delegate_dependencies(init_state& state, delegate_type& type)
 {
-    process_contract_dependencies(*state.target, type.type());
+    process_contract_dependencies(*state.target, &type.versioning());
 
     // We only care about instantiations of generic types, so early exit as we won't be able to resolve references
     if (type.is_generic())
@@ -234,8 +272,8 @@ void metadata_cache::process_delegate_dependencies(init_state& state, delegate_t
         if (method.Name() != ".ctor"sv)
         {
             XLANG_ASSERT(method.Name() == "Invoke"sv);
-            process_contract_dependencies(*state.target, method);
-            type.functions.push_back(process_function(state, method));
+            process_contract_dependencies(*state.target, type.versioning(method));
+            type.functions.push_back(process_function(state, type, method));
             break;
         }
     }
@@ -246,7 +284,7 @@ void metadata_cache::process_delegate_dependencies(init_state& state, delegate_t
 
 void metadata_cache::process_interface_dependencies(init_state& state, interface_type& type)
 {
-    process_contract_dependencies(*state.target, type.type());
+    process_contract_dependencies(*state.target, &type.versioning());
 
     // We only care about instantiations of generic types, so early exit as we won't be able to resolve references
     if (type.is_generic())
@@ -256,20 +294,21 @@ void metadata_cache::process_interface_dependencies(init_state& state, interface
 
     for (auto const& iface : type.type().InterfaceImpl())
     {
-        process_contract_dependencies(*state.target, iface);
+        process_contract_dependencies(*state.target, type.versioning(iface));
         type.required_interfaces.push_back(&find_dependent_type(state, iface.Interface()));
     }
 
+    type.functions.reserve(distance(type.type().MethodList()));
     for (auto const& method : type.type().MethodList())
     {
-        process_contract_dependencies(*state.target, method);
-        type.functions.push_back(process_function(state, method));
+        process_contract_dependencies(*state.target, type.versioning(method));
+        type.functions.push_back(process_function(state, type, method));
     }
 }
 
 void metadata_cache::process_class_dependencies(init_state& state, class_type& type)
 {
-    process_contract_dependencies(*state.target, type.type());
+    process_contract_dependencies(*state.target, &type.versioning());
 
     // We only care about instantiations of generic types, so early exit as we won't be able to resolve references
     if (type.is_generic())
@@ -284,7 +323,7 @@ void metadata_cache::process_class_dependencies(init_state& state, class_type& t
 
     for (auto const& iface : type.type().InterfaceImpl())
     {
-        process_contract_dependencies(*state.target, iface);
+        process_contract_dependencies(*state.target, type.versioning(iface));
         auto ifaceType = &find_dependent_type(state, iface.Interface());
         type.required_interfaces.push_back(ifaceType);
 
@@ -313,19 +352,19 @@ void metadata_cache::process_class_dependencies(init_state& state, class_type& t
             }
 
             // Make sure that this interface reference applies for the same versioning "scheme" as the attribute
-            auto verMatch = match_versioning_scheme(attrVer, ifaceImpl);
+            auto ifaceImplVersioning = type.versioning(ifaceImpl);
+            auto verMatch = ifaceImplVersioning ? match_versioning_scheme(attrVer, *ifaceImplVersioning) : std::nullopt;
             if (!verMatch)
             {
                 // No match on the interface reference is okay so long as there is _no_ versioning information on the
                 // reference. If there's not, then the requirement applies to all versioning schemes, so we look at the
                 // interface for the versioning information
-                if (get_attribute(ifaceImpl, metadata_namespace, "ContractVersionAttribute"sv) ||
-                    get_attribute(ifaceImpl, metadata_namespace, "VersionAttribute"sv))
+                if (ifaceImplVersioning && ifaceImplVersioning->has_version())
                 {
                     continue;
                 }
 
-                verMatch = match_versioning_scheme(attrVer, iface->type());
+                verMatch = match_versioning_scheme(attrVer, iface->versioning());
                 if (!verMatch)
                 {
                     XLANG_ASSERT(false);
@@ -451,34 +490,24 @@ void metadata_cache::process_fastabi_required_interfaces(
     }
 }
 
-function_def metadata_cache::process_function(init_state& state, MethodDef const& def)
+function_def metadata_cache::process_function(init_state& state, typedef_base const& type, MethodDef const& def)
 {
-    auto paramNames = def.ParamList();
     auto sig = def.Signature();
     XLANG_ASSERT(sig.GenericParamCount() == 0);
 
-    std::optional<function_return_type> return_type;
+    function_def result{ def, type.versioning(def) };
     if (sig.ReturnType())
     {
-        std::string_view name = "result"sv;
-        if ((paramNames.first != paramNames.second) && (paramNames.first.Sequence() == 0))
-        {
-            name = paramNames.first.Name();
-            ++paramNames.first;
-        }
-
-        return_type = function_return_type{ sig.ReturnType(), name, &find_dependent_type(state, sig.ReturnType().Type()) };
+        result.return_type = &find_dependent_type(state, sig.ReturnType().Type());
     }
 
-    std::vector<function_param> params;
+    result.param_types.reserve(distance(sig.Params()));
     for (auto const& param : sig.Params())
     {
-        XLANG_ASSERT(paramNames.first != paramNames.second);
-        params.push_back(function_param{ param, paramNames.first.Name(), &find_dependent_type(state, param.Type()) });
-        ++paramNames.first;
+        result.param_types.push_back(&find_dependent_type(state, param.Type()));
     }
 
-    return function_def{ def, std::move(return_type), std::move(params) };
+    return result;
 }
 
 metadata_type const& metadata_cache::find_dependent_type(init_state& state, TypeSig const& type)
@@ -538,10 +567,17 @@ metadata_type const& metadata_cache::find_dependent_type(init_state& state, code
             result = &find(defOrRef.TypeNamespace(), defOrRef.TypeName());
             if (auto typeDef = dynamic_cast<typedef_base const*>(result))
             {
-                state.target->dependent_namespaces.insert(result->clr_abi_namespace());
+                // Dependencies found while constructing a generic instantiation belong to that instantiation since it
+                // gets shared by all namespaces that use it
+                auto& dependentNamespaces = state.parent_generic_inst ?
+                    state.parent_generic_inst->dependent_namespaces : state.target->dependent_namespaces;
+                auto& typeDependencies = state.parent_generic_inst ?
+                    state.parent_generic_inst->type_dependencies : state.target->type_dependencies;
+
+                dependentNamespaces.insert(result->clr_abi_namespace());
                 if (!typeDef->is_generic())
                 {
-                    state.target->type_dependencies.emplace(*typeDef);
+                    typeDependencies.emplace(*typeDef);
                 }
             }
         }});
@@ -549,6 +585,31 @@ metadata_type const& metadata_cache::find_dependent_type(init_state& state, code
     return *result;
 }
 
+static void merge_generic_instantiation(namespace_cache& target, generic_inst const& inst)
+{
+    auto [itr, added] = target.generic_instantiations.emplace(inst.clr_full_name(), inst);
+    if (!added)
+    {
+        return;
+    }
+
+    target.dependent_namespaces.insert(inst.dependent_namespaces.begin(), inst.dependent_namespaces.end());
+    target.type_dependencies.insert(inst.type_dependencies.begin(), inst.type_dependencies.end());
+
+    for (auto param : inst.generic_params())
+    {
+        if (auto paramInst = dynamic_cast<generic_inst const*>(param))
+        {
+            merge_generic_instantiation(target, *paramInst);
+        }
+    }
+
+    for (auto dependency : inst.dependencies)
+    {
+        merge_generic_instantiation(target, *dependency);
+    }
+}
+
 metadata_type const& metadata_cache::find_dependent_type(init_state& state, GenericTypeInstSig const& type)
 {
     auto genericType = dynamic_cast<typedef_base const*>(&find_dependent_type(state, type.GenericType()));
@@ -564,55 +625,62 @@ metadata_type const& metadata_cache::find_dependent_type(init_state& state, Gene
         genericParams.push_back(&find_dependent_type(state, param));
     }
 
-    generic_inst inst{ genericType, std::move(genericParams) };
-    auto [itr, added] = state.target->generic_instantiations.emplace(inst.clr_full_name(), std::move(inst));
-    if (added)
+    generic_inst* inst;
     {
-        auto restore = std::exchange(state.parent_generic_inst, &itr->second);
-        auto check_dependency = [&, &itr = itr](auto const& t)
+        // Instantiations can refer back to themselves (e.g. through an event handler), so the lock needs to be
+        // recursive. Holding it for the whole construction means that other threads only ever see complete entries
+        std::lock_guard lock{ m_genericInstantiationsLock };
+        auto [itr, added] = m_genericInstantiations.try_emplace(generic_inst_key{ genericType, genericParams },
+            genericType, std::move(genericParams));
+        inst = &itr->second;
+        if (added)
         {
-            auto mdType = &find_dependent_type(state, t);
-            if (auto genericType = dynamic_cast<generic_inst const*>(mdType))
+            auto restore = std::exchange(state.parent_generic_inst, inst);
+            auto check_dependency = [&](metadata_type const* mdType)
             {
-                itr->second.dependencies.push_back(genericType);
-            }
-        };
-
-        for (auto const& iface : genericType->type().InterfaceImpl())
-        {
-            check_dependency(iface.Interface());
-        }
+                if (auto genericType = dynamic_cast<generic_inst const*>(mdType))
+                {
+                    inst->dependencies.push_back(genericType);
+                }
+            };
 
-        for (auto const& fn : genericType->type().MethodList())
-        {
-            if (fn.Name() == ".ctor"sv)
+            for (auto const& iface : genericType->type().InterfaceImpl())
             {
-                continue;
+                check_dependency(&find_dependent_type(state, iface.Interface()));
             }
 
-            // TODO: Duplicated effort!
-            itr->second.functions.push_back(process_function(state, fn));
-
-            auto sig = fn.Signature();
-            if (sig.ReturnType())
+            inst->functions.reserve(distance(genericType->type().MethodList()));
+            for (auto const& fn : genericType->type().MethodList())
             {
-                check_dependency(sig.ReturnType().Type());
-            }
+                if (fn.Name() == ".ctor"sv)
+                {
+                    continue;
+                }
 
-            for (auto const& param : sig.Params())
-            {
-                check_dependency(param.Type());
+                // The function already resolved the types of its signature, so check those rather than decoding it again
+                auto const& func = inst->functions.emplace_back(process_function(state, *genericType, fn));
+                check_dependency(func.return_type);
+                for (auto param : func.param_types)
+                {
+                    check_dependency(param);
+                }
             }
+
+            state.parent_generic_inst = restore;
         }
+    }
 
-        state.parent_generic_inst = restore;
+    // Instantiations encountered while constructing another one get merged into the namespace along with it
+    if (!state.parent_generic_inst)
+    {
+        merge_generic_instantiation(*state.target, *inst);
     }
 
-    return itr->second;
+    return *inst;
 }
 
 template <typename T>
-static void merge_into(std::vector<T>& from, std::vector<std::reference_wrapper<T const>>& to)
+static void merge_into(std::vector<T> const& from, std::vector<std::reference_wrapper<T const>>& to)
 {
     std::vector<std::reference_wrapper<T const>> result;
     result.reserve(from.size() + to.size());
@@ -620,7 +688,52 @@ static void merge_into(std::vector<T>& from, std::vector<std::reference_wrapper<
     to.swap(result);
 }
 
-type_cache metadata_cache::compile_namespaces(std::initializer_list<std::string_view> targetNamespaces)
+template <typename T>
+static void sort_by_name(std::vector<std::reference_wrapper<T const>>& types)
+{
+    std::sort(types.begin(), types.end(), [](T const& lhs, T const& rhs)
+    {
+        return lhs.clr_full_name() < rhs.clr_full_name();
+    });
+    types.erase(std::unique(types.begin(), types.end(), [](T const& lhs, T const& rhs)
+    {
+        return &lhs == &rhs;
+    }), types.end());
+}
+
+static void sort_by_category(std::vector<std::reference_wrapper<typedef_base const>>& types)
+{
+    auto category_power = [](category cat)
+    {
+        switch (cat)
+        {
+        case category::enum_type: return 0;
+        case category::struct_type: return 1;
+        case category::delegate_type: return 2;
+        case category::interface_type: return 3;
+        case category::class_type: return 4;
+        default: return 100;
+        }
+    };
+
+    // Getting the category of a type means resolving its base type, so only do that once per type instead of on each
+    // comparison. The input is already sorted by name, which a stable sort preserves within each category
+    std::vector<std::pair<int, std::reference_wrapper<typedef_base const>>> keyed;
+    keyed.reserve(types.size());
+    for (auto const& type : types)
+    {
+        keyed.emplace_back(category_power(type.get().category()), type);
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](auto const& lhs, auto const& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    std::transform(keyed.begin(), keyed.end(), types.begin(), [](auto const& pair) { return pair.second; });
+}
+
+type_cache metadata_cache::compile_namespaces(std::initializer_list<std::string_view> targetNamespaces) const
 {
     type_cache result{ this };
 
@@ -645,18 +758,22 @@ type_cache metadata_cache::compile_namespaces(std::initializer_list<std::string_
         merge_into(itr->second.interfaces, result.interfaces);
         merge_into(itr->second.classes, result.classes);
 
-        // Merge the dependencies together
-        result.dependent_namespaces.insert(
+        // Gather the dependencies together. These get sorted, and any duplicates removed, once all namespaces have
+        // been gathered
+        result.dependent_namespaces.insert(result.dependent_namespaces.end(),
             itr->second.dependent_namespaces.begin(),
             itr->second.dependent_namespaces.end());
 
-        result.generic_instantiations.insert(itr->second.generic_instantiations.begin(), itr->second.generic_instantiations.end());
+        for (auto const& [name, inst] : itr->second.generic_instantiations)
+        {
+            result.generic_instantiations.push_back(inst);
+        }
 
         std::partition_copy(
             itr->second.type_dependencies.begin(),
             itr->second.type_dependencies.end(),
-            std::inserter(result.internal_dependencies, result.internal_dependencies.end()),
-            std::inserter(result.external_dependencies, result.external_dependencies.end()),
+            std::back_inserter(result.internal_dependencies),
+            std::back_inserter(result.external_dependencies),
             [&](auto const& type) { return includes_namespace(type.get().clr_logical_namespace()); });
 
         // Remove any "built-in types" since these are either defined in other header files or are metadata only types
@@ -684,6 +801,16 @@ type_cache metadata_cache::compile_namespaces(std::initializer_list<std::string_
         }
     }
 
+    std::sort(result.dependent_namespaces.begin(), result.dependent_namespaces.end());
+    result.dependent_namespaces.erase(
+        std::unique(result.dependent_namespaces.begin(), result.dependent_namespaces.end()),
+        result.dependent_namespaces.end());
+
+    sort_by_name(result.generic_instantiations);
+    sort_by_name(result.external_dependencies);
+    sort_by_name(result.internal_dependencies);
+    sort_by_category(result.internal_dependencies);
+
     // Structs need all members to be defined prior to the struct definition
     std::pair range{ result.structs.begin(), result.structs.end() };
     while (range.first != range.second)
@@ -18,34 +18,6 @@ struct api_contract
     std::uint32_t current_version;
 };
 
-struct category_compare
-{
-    bool operator()(typedef_base const& lhs, typedef_base const& rhs) const
-    {
-        using namespace xlang::meta::reader;
-        auto leftCat = get_category(lhs.type());
-        auto rightCat = get_category(rhs.type());
-        if (leftCat == rightCat)
-        {
-            return lhs.clr_full_name() < rhs.clr_full_name();
-        }
-
-        auto category_power = [](category cat)
-        {
-            switch (cat)
-            {
-            case category::enum_type: return 0;
-            case category::struct_type: return 1;
-            case category::delegate_type: return 2;
-            case category::interface_type: return 3;
-            case category::class_type: return 4;
-            default: return 100;
-            }
-        };
-        return category_power(leftCat) < category_power(rightCat);
-    }
-};
-
 struct metadata_cache;
 
 struct type_cache
@@ -59,11 +31,12 @@ struct type_cache
     std::vector<std::reference_wrapper<interface_type const>> interfaces;
     std::vector<std::reference_wrapper<class_type const>> classes;
 
-    // Dependencies
-    std::set<std::string_view> dependent_namespaces;
-    std::map<std::string_view, std::reference_wrapper<generic_inst const>> generic_instantiations;
-    std::set<std::reference_wrapper<typedef_base const>> external_dependencies;
-    std::set<std::reference_wrapper<typedef_base const>, category_compare> internal_dependencies;
+    // Dependencies, each sorted in the order that they get written out. Generic instantiations and external
+    // dependencies are sorted by name and internal dependencies by category, then by name
+    std::vector<std::string_view> dependent_namespaces;
+    std::vector<std::reference_wrapper<generic_inst const>> generic_instantiations;
+    std::vector<std::reference_wrapper<typedef_base const>> external_dependencies;
+    std::vector<std::reference_wrapper<typedef_base const>> internal_dependencies;
 };
 
 struct namespace_cache
@@ -78,8 +51,11 @@ struct namespace_cache
 
     // Dependencies
     std::set<std::string_view> dependent_namespaces;
-    std::map<std::string_view, generic_inst> generic_instantiations;
+    std::map<std::string_view, std::reference_wrapper<generic_inst const>> generic_instantiations;
     std::set<std::reference_wrapper<typedef_base const>> type_dependencies;
+
+    // The contents of this namespace's header, compiled once all namespaces have been processed
+    type_cache compiled;
 };
 
 struct metadata_cache
@@ -88,7 +64,7 @@ struct metadata_cache
 
     metadata_cache(xlang::meta::reader::cache const& c);
 
-    type_cache compile_namespaces(std::initializer_list<std::string_view> targetNamespaces);
+    type_cache compile_namespaces(std::initializer_list<std::string_view> targetNamespaces) const;
 
     metadata_type const* try_find(std::string_view typeNamespace, std::string_view typeName) const
     {
@@ -130,7 +106,7 @@ private:
     struct init_state
     {
         namespace_cache* target;
-        generic_inst const* parent_generic_inst = nullptr;
+        generic_inst* parent_generic_inst = nullptr;
     };
 
     void process_namespace_dependencies(namespace_cache& target);
@@ -144,11 +120,17 @@ private:
     using relative_version_map = std::unordered_map<interface_type const*, relative_version>;
     void process_fastabi_required_interfaces(init_state& state, interface_type const* currentInterface, relative_version rank, relative_version_map& interfaceMap);
 
-    function_def process_function(init_state& state, xlang::meta::reader::MethodDef const& def);
+    function_def process_function(init_state& state, typedef_base const& type, xlang::meta::reader::MethodDef const& def);
 
     metadata_type const& find_dependent_type(init_state& state, xlang::meta::reader::TypeSig const& type);
     metadata_type const& find_dependent_type(init_state& state, xlang::meta::reader::coded_index<xlang::meta::reader::TypeDefOrRef> const& type);
     metadata_type const& find_dependent_type(init_state& state, xlang::meta::reader::GenericTypeInstSig const& type);
 
     std::map<std::string_view, std::map<std::string_view, metadata_type const&>> m_typeTable;
+
+    // Generic instantiations are shared by all namespaces that use them. They are interned by their generic type and
+    // arguments so that each one is only constructed once, and namespaces only hold references to them
+    using generic_inst_key = std::pair<typedef_base const*, std::vector<metadata_type const*>>;
+    std::map<generic_inst_key, generic_inst> m_genericInstantiations;
+    std::recursive_mutex m_genericInstantiationsLock;
 };
@@ -3,8 +3,23 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <string_view>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define XLANG_SHA1_INTRINSICS 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define XLANG_SHA1_TARGET
+#else
+#include <cpuid.h>
+#define XLANG_SHA1_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+#endif
+#else
+#define XLANG_SHA1_INTRINSICS 0
+#endif
+
 template <typename T>
 inline constexpr std::uint8_t* bigendian_copy(T value, std::uint8_t* target) noexcept
 {
@@ -33,24 +48,37 @@ struct sha1
         m_state = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
     }
 
-    constexpr void append(std::uint8_t const* data, std::uint64_t count) noexcept
+    void append(std::uint8_t const* data, std::uint64_t count) noexcept
     {
-        while (count > 0)
+        m_sizeBytes += count;
+
+        // Top off a partially filled chunk first, then hash whole chunks straight from the input and buffer the rest
+        if (m_nextChunkByte != 0)
         {
-            auto bytesToCopy = (std::min)(count, chunk_size_bytes - m_nextChunkByte);
-            for (std::size_t i = 0; i < bytesToCopy; ++i)
-            {
-                append_byte(data[i]);
-            }
+            auto bytesToCopy = static_cast<std::size_t>((std::min)(count, chunk_size_bytes - m_nextChunkByte));
+            std::memcpy(m_currentChunk.data() + m_nextChunkByte, data, bytesToCopy);
+            m_nextChunkByte += bytesToCopy;
+            data += bytesToCopy;
+            count -= bytesToCopy;
 
-            if (m_nextChunkByte == chunk_size_bytes)
+            if (m_nextChunkByte < chunk_size_bytes)
             {
-                process_chunk();
+                return;
             }
 
-            count -= bytesToCopy;
-            data += bytesToCopy;
+            process_chunks(m_currentChunk.data(), 1);
+            m_nextChunkByte = 0;
         }
+
+        if (auto chunks = static_cast<std::size_t>(count / chunk_size_bytes))
+        {
+            process_chunks(data, chunks);
+            data += chunks * chunk_size_bytes;
+            count -= chunks * chunk_size_bytes;
+        }
+
+        std::memcpy(m_currentChunk.data(), data, static_cast<std::size_t>(count));
+        m_nextChunkByte = count;
     }
 
     void append(std::string_view str) noexcept
@@ -58,32 +86,24 @@ struct sha1
         append(reinterpret_cast<std::uint8_t const*>(str.data()), str.length());
     }
 
-    constexpr std::array<std::uint8_t, 20> finalize() noexcept
+    std::array<std::uint8_t, 20> finalize() noexcept
     {
         auto const sizeBits = m_sizeBytes * 8;
-        append_byte(0x80);
-
-        constexpr auto sizeOffset = chunk_size_bytes - 8;
-        while (m_nextChunkByte < sizeOffset)
-        {
-            append_byte(0);
-        }
+        m_currentChunk[m_nextChunkByte++] = 0x80;
 
         // We need to append the length to the very end, which means that we may need to process a mostly empty
         // additional chunk
+        constexpr auto sizeOffset = chunk_size_bytes - 8;
         if (m_nextChunkByte > sizeOffset)
         {
-            while (m_nextChunkByte < chunk_size_bytes)
-            {
-                append_byte(0);
-            }
-            process_chunk();
+            std::fill(m_currentChunk.begin() + m_nextChunkByte, m_currentChunk.end(), std::uint8_t{});
+            process_chunks(m_currentChunk.data(), 1);
+            m_nextChunkByte = 0;
         }
 
-        m_currentChunk[chunk_size_ints - 2] = static_cast<std::uint32_t>(sizeBits >> 32);
-        m_currentChunk[chunk_size_ints - 1] = static_cast<std::uint32_t>(sizeBits);
-        m_nextChunkByte = chunk_size_bytes;
-        process_chunk();
+        std::fill(m_currentChunk.begin() + m_nextChunkByte, m_currentChunk.begin() + sizeOffset, std::uint8_t{});
+        bigendian_copy(sizeBits, m_currentChunk.data() + sizeOffset);
+        process_chunks(m_currentChunk.data(), 1);
 
         std::array<std::uint8_t, 20> result = {};
         auto dest = result.data();
@@ -98,23 +118,32 @@ struct sha1
 
 private:
 
-    constexpr void append_byte(std::uint8_t byte) noexcept
+    void process_chunks(std::uint8_t const* data, std::size_t count) noexcept
     {
-        auto index = static_cast<std::size_t>(m_nextChunkByte / 4);
-        auto pos = m_nextChunkByte % 4;
-        auto shift = (3 - pos) * 8;
-        m_currentChunk[index] |= (byte << shift);
-        ++m_nextChunkByte;
-        ++m_sizeBytes;
+#if XLANG_SHA1_INTRINSICS
+        if (has_sha_extensions())
+        {
+            process_chunks_sha_extensions(data, count);
+            return;
+        }
+#endif
+
+        for (; count > 0; --count, data += chunk_size_bytes)
+        {
+            process_chunk(data);
+        }
     }
 
-    constexpr void process_chunk() noexcept
+    constexpr void process_chunk(std::uint8_t const* data) noexcept
     {
-        XLANG_ASSERT(m_nextChunkByte == chunk_size_bytes);
         auto chunkState = m_state;
 
         std::array<std::uint32_t, 80> w = {};
-        for (auto i = 0; i < 16; ++i) w[i] = m_currentChunk[i];
+        for (auto i = 0; i < 16; ++i)
+        {
+            w[i] = (static_cast<std::uint32_t>(data[i * 4]) << 24) | (static_cast<std::uint32_t>(data[i * 4 + 1]) << 16) |
+                (static_cast<std::uint32_t>(data[i * 4 + 2]) << 8) | static_cast<std::uint32_t>(data[i * 4 + 3]);
+        }
         for (auto i = 16; i < 80; ++i)
         {
             w[i] = lrot(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
@@ -145,10 +174,132 @@ private:
         {
             m_state[i] += chunkState[i];
         }
-        m_nextChunkByte = 0;
-        m_currentChunk = {};
     }
 
+#if XLANG_SHA1_INTRINSICS
+    static bool has_sha_extensions() noexcept
+    {
+        static bool const result = []
+        {
+            // SHA (CPUID.7.0:EBX[29]) along with SSSE3 (CPUID.1:ECX[9]) and SSE4.1 (CPUID.1:ECX[19])
+#if defined(_MSC_VER)
+            int info[4] = {};
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+
+            __cpuid(info, 1);
+            auto const ecx = static_cast<unsigned>(info[2]);
+            __cpuidex(info, 7, 0);
+            auto const ebx = static_cast<unsigned>(info[1]);
+#else
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            {
+                return false;
+            }
+
+            unsigned leaf7ebx = ebx;
+            __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+            ebx = leaf7ebx;
+#endif
+            return ((ebx >> 29) & 1) && ((ecx >> 9) & 1) && ((ecx >> 19) & 1);
+        }();
+
+        return result;
+    }
+
+    XLANG_SHA1_TARGET void process_chunks_sha_extensions(std::uint8_t const* data, std::size_t count) noexcept
+    {
+        // The message words are big endian, so reverse the bytes of each 128-bit load
+        __m128i const mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(m_state.data())), 0x1B);
+        __m128i e0 = _mm_set_epi32(static_cast<int>(m_state[4]), 0, 0, 0);
+
+        for (; count > 0; --count, data += chunk_size_bytes)
+        {
+            __m128i const abcdSave = abcd;
+            __m128i const eSave = e0;
+            __m128i e1;
+
+            // Rounds 0-15 load the message, after which each group of four rounds expands the next four words
+            __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), mask);
+            e0 = _mm_add_epi32(e0, msg0);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+            __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+            __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 32)), mask);
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+            msg0 = _mm_xor_si128(msg0, msg2);
+
+            __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 48)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+            msg1 = _mm_xor_si128(msg1, msg3);
+
+#define XLANG_SHA1_ROUNDS(eNext, eCurrent, current, next, after, previous, func) \
+            eNext = _mm_sha1nexte_epu32(eNext, current); \
+            eCurrent = abcd; \
+            next = _mm_sha1msg2_epu32(next, current); \
+            abcd = _mm_sha1rnds4_epu32(abcd, eNext, func); \
+            previous = _mm_sha1msg1_epu32(previous, current); \
+            after = _mm_xor_si128(after, current);
+
+            XLANG_SHA1_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 0); // 16-19
+            XLANG_SHA1_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1); // 20-23
+            XLANG_SHA1_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 1); // 24-27
+            XLANG_SHA1_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 1); // 28-31
+            XLANG_SHA1_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 1); // 32-35
+            XLANG_SHA1_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1); // 36-39
+            XLANG_SHA1_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2); // 40-43
+            XLANG_SHA1_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 2); // 44-47
+            XLANG_SHA1_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 2); // 48-51
+            XLANG_SHA1_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 2); // 52-55
+            XLANG_SHA1_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2); // 56-59
+            XLANG_SHA1_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 3); // 60-63
+            XLANG_SHA1_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 3); // 64-67
+#undef XLANG_SHA1_ROUNDS
+
+            // Rounds 68-79 no longer need to expand any further message words
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            msg3 = _mm_xor_si128(msg3, msg1);
+
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+            e0 = _mm_sha1nexte_epu32(e0, eSave);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(m_state.data()), _mm_shuffle_epi32(abcd, 0x1B));
+        m_state[4] = static_cast<std::uint32_t>(_mm_extract_epi32(e0, 3));
+    }
+#endif
+
     template <typename T>
     static constexpr T lrot(T value, std::size_t count) noexcept
     {
@@ -170,7 +321,7 @@ private:
 
     std::uint64_t m_sizeBytes = 0;
 
-    std::array<std::uint32_t, 16> m_currentChunk = {};
+    std::array<std::uint8_t, chunk_size_bytes> m_currentChunk = {};
     std::uint64_t m_nextChunkByte = 0;
 
     std::array<std::uint32_t, 5> m_state = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
@@ -11,9 +11,9 @@ inline void write_contract_version(writer& w, unsigned int value)
     w.write("%.%", versionHigh, versionLow);
 }
 
-inline void write_type_banner_version_info(writer& w, xlang::meta::reader::TypeDef const& type)
+inline void write_type_banner_version_info(writer& w, typedef_base const& type)
 {
-    if (auto contractInfo = get_contract_history(type))
+    if (auto const& contractInfo = type.versioning().history)
     {
         w.write(R"^-^( *
  * Introduced to % in version %
@@ -22,7 +22,7 @@ inline void write_type_banner_version_info(writer& w, xlang::meta::reader::TypeD
             xlang::text::bind<write_contract_version>(contractInfo->current_contract.version));
     }
 
-    if (is_experimental(type))
+    if (type.is_experimental())
     {
         w.write(R"^-^( *
  * Type is for evaluation purposes and is subject to change or removal in future updates.
@@ -38,7 +38,7 @@ inline void write_type_banner(writer& w, enum_type const& type)
  * Struct %
 )^-^", type.clr_full_name());
 
-    write_type_banner_version_info(w, type.type());
+    write_type_banner_version_info(w, type);
 
     w.write(R"^-^( *
  */
@@ -52,7 +52,7 @@ inline void write_type_banner(writer& w, struct_type const& type)
  * Struct %
 )^-^", type.clr_full_name());
 
-    write_type_banner_version_info(w, type.type());
+    write_type_banner_version_info(w, type);
 
     w.write(R"^-^( *
  */
@@ -66,7 +66,7 @@ inline void write_type_banner(writer& w, delegate_type const& type)
  * Delegate %
 )^-^", type.clr_full_name());
 
-    write_type_banner_version_info(w, type.type());
+    write_type_banner_version_info(w, type);
 
     w.write(R"^-^( *
  */
@@ -83,7 +83,7 @@ inline void write_type_banner(writer& w, interface_type const& type)
  * Interface %
 )^-^", type.clr_full_name());
 
-    write_type_banner_version_info(w, type.type());
+    write_type_banner_version_info(w, type);
 
     if (auto exclusiveAttr = get_attribute(type.type(), metadata_namespace, "ExclusiveToAttribute"sv))
     {
@@ -125,7 +125,7 @@ inline void write_type_banner(writer& w, class_type const& type)
  * Class %
 )^-^", type.clr_full_name());
 
-    write_type_banner_version_info(w, type.type());
+    write_type_banner_version_info(w, type);
 
     for_each_attribute(type.type(), metadata_namespace, "ActivatableAttribute"sv, [&](bool first, CustomAttribute const& attr)
     {
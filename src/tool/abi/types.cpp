@@ -1,7 +1,12 @@
 #include "pch.h"
 
+#include <memory>
+#include <mutex>
+#include <set>
+
 #include "abi_writer.h"
 #include "code_writers.h"
+#include "sha1.h"
 #include "types.h"
 #include "type_banners.h"
 
@@ -9,18 +14,92 @@ using namespace std::literals;
 using namespace xlang::meta::reader;
 using namespace xlang::text;
 
-template <typename T>
-static std::size_t push_type_contract_guards(writer& w, T const& type)
+// The names and signatures of all types get appended to a list of fixed size blocks that is never freed, so that the
+// views handed out stay valid for the rest of the run
+std::string_view const* lazy_string::intern(std::string_view value)
+{
+    static constexpr std::size_t block_size = 64 * 1024;
+    static std::mutex lock;
+    static std::vector<std::unique_ptr<char[]>> blocks;
+    static char* next = nullptr;
+    static std::size_t remaining = 0;
+
+    // Each entry is a string_view followed by the characters that it refers to, padded to keep the next entry aligned
+    constexpr auto align = alignof(std::string_view);
+    auto const entrySize = sizeof(std::string_view) + (value.size() + align - 1) / align * align;
+    auto emplace = [&](char* entry)
+    {
+        auto chars = entry + sizeof(std::string_view);
+        std::copy(value.begin(), value.end(), chars);
+        return new (entry) std::string_view{ chars, value.size() };
+    };
+
+    std::lock_guard guard{ lock };
+    if (entrySize > remaining)
+    {
+        if (entrySize > block_size / 4)
+        {
+            // Large strings get a block of their own rather than wasting the rest of the current one
+            return emplace(blocks.emplace_back(new char[entrySize]).get());
+        }
+
+        next = blocks.emplace_back(new char[block_size]).get();
+        remaining = block_size;
+    }
+
+    auto result = emplace(next);
+    next += entrySize;
+    remaining -= entrySize;
+    return result;
+}
+
+std::string_view metadata_type::signature() const
 {
-    if (auto vers = get_contract_history(type))
+    return m_signatureCache.get([&](std::string& result) { append_signature(result); });
+}
+
+std::array<std::uint8_t, 16> const& metadata_type::generated_iid() const
+{
+    if (!m_generatedIidCache)
     {
-        w.push_contract_guard(*vers);
+        sha1 signatureHash;
+        static constexpr std::uint8_t namespaceGuidBytes[] =
+        {
+            0x11, 0xf4, 0x7a, 0xd5,
+            0x7b, 0x73,
+            0x42, 0xc0,
+            0xab, 0xae, 0x87, 0x8b, 0x1e, 0x16, 0xad, 0xee
+        };
+        signatureHash.append(namespaceGuidBytes, std::size(namespaceGuidBytes));
+        signatureHash.append(signature());
+
+        auto iidHash = signatureHash.finalize();
+        iidHash[6] = (iidHash[6] & 0x0F) | 0x50;
+        iidHash[8] = (iidHash[8] & 0x3F) | 0x80;
+
+        auto& result = m_generatedIidCache.emplace();
+        std::copy_n(iidHash.begin(), result.size(), result.begin());
+    }
+
+    return *m_generatedIidCache;
+}
+
+static std::size_t push_member_contract_guards(writer& w, versioning_info const* versioning)
+{
+    if (versioning && versioning->history)
+    {
+        w.push_contract_guard(*versioning->history);
         return 1;
     }
 
     return 0;
 }
 
+static deprecation_info const* member_deprecation(versioning_info const* versioning)
+{
+    return versioning ? versioning->deprecation.get() : nullptr;
+}
+
 template <typename T>
 static std::size_t begin_type_definition(writer& w, T const& type)
 {
@@ -45,26 +124,68 @@ static void end_type_definition(writer& w, T const& type, std::size_t contractGu
     w.write('\n');
 }
 
+template <typename T, typename Key>
+static void decode_member_versioning(T const& members, std::vector<std::pair<Key, versioning_info>>& result)
+{
+    for (auto const& member : members)
+    {
+        if (auto info = decode_versioning(member))
+        {
+            using row_type = std::decay_t<decltype(member)>;
+            result.emplace_back(Key{ index_tag_v<HasCustomAttribute, row_type>, member.index() }, std::move(*info));
+        }
+    }
+}
+
 typedef_base::typedef_base(TypeDef const& type) :
     m_type(type),
-    m_clrFullName(::clr_full_name(type)),
-    m_mangledName(::mangled_name<false>(type)),
-    m_genericParamMangledName(::mangled_name<true>(type)),
-    m_contractHistory(get_contract_history(type))
+    m_versioning(decode_versioning(type).value_or(versioning_info{}))
 {
-    for_each_attribute(type, metadata_namespace, "VersionAttribute"sv, [&](bool, CustomAttribute const& attr)
+    // Only decode the members that get written out or that contribute to the dependencies of the type. Methods come
+    // before interface implementations in the 'HasCustomAttribute' ordering, so the records end up sorted
+    switch (get_category(type))
     {
-        m_platformVersions.push_back(decode_platform_version(attr));
+    case category::enum_type:
+    case category::struct_type:
+        decode_member_versioning(type.FieldList(), m_memberVersioning);
+        break;
+    case category::delegate_type:
+        decode_member_versioning(type.MethodList(), m_memberVersioning);
+        break;
+    case category::interface_type:
+        decode_member_versioning(type.MethodList(), m_memberVersioning);
+        decode_member_versioning(type.InterfaceImpl(), m_memberVersioning);
+        break;
+    case category::class_type:
+        decode_member_versioning(type.InterfaceImpl(), m_memberVersioning);
+        break;
+    }
+
+    // Types hold on to these for the lifetime of the cache, so don't hold on to the slack from growing the list too
+    m_memberVersioning.shrink_to_fit();
+    XLANG_ASSERT(std::is_sorted(m_memberVersioning.begin(), m_memberVersioning.end(), [](auto const& lhs, auto const& rhs)
+    {
+        return lhs.first < rhs.first;
+    }));
+}
+
+versioning_info const* typedef_base::member_versioning(member_key key) const noexcept
+{
+    auto itr = std::lower_bound(m_memberVersioning.begin(), m_memberVersioning.end(), key,
+        [](auto const& record, member_key const& value)
+    {
+        return record.first < value;
     });
+    return ((itr != m_memberVersioning.end()) && (itr->first == key)) ? &itr->second : nullptr;
 }
 
 std::size_t typedef_base::push_contract_guards(writer& w) const
 {
     XLANG_ASSERT(!is_generic());
 
-    if (m_contractHistory)
+    if (m_versioning.history)
     {
-        w.push_contract_guard(*m_contractHistory);
+        w.push_contract_guard(*m_versioning.history);
         return 1;
     }
 
@@ -83,7 +204,7 @@ static std::string_view enum_string(writer& w)
 
 void enum_type::write_cpp_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -109,7 +230,7 @@ void enum_type::write_cpp_abi_param(writer& w) const
 
 void enum_type::write_c_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -155,7 +276,8 @@ void enum_type::write_cpp_definition(writer& w) const
                 w.write("#if defined(ENABLE_WINRT_EXPERIMENTAL_TYPES)\n");
             }
 
-            auto fieldContractDepth = push_type_contract_guards(w, field);
+            auto fieldVersioning = versioning(field);
+            auto fieldContractDepth = push_member_contract_guards(w, fieldVersioning);
 
             w.write("%", indent{ 1 });
             if (!w.config().enum_class)
@@ -164,7 +286,7 @@ void enum_type::write_cpp_definition(writer& w) const
             }
             w.write(field.Name());
 
-            if (auto info = ::is_deprecated(field); info && w.config().enable_header_deprecation)
+            if (auto info = member_deprecation(fieldVersioning); info && w.config().enable_header_deprecation)
             {
                 w.write("\n");
                 write_deprecation_message(w, *info, 1, "DEPRECATEDENUMERATOR");
@@ -236,10 +358,11 @@ void enum_type::write_c_definition(writer& w) const
                 w.write("#if defined(ENABLE_WINRT_EXPERIMENTAL_TYPES)\n");
             }
 
-            auto fieldContractDepth = push_type_contract_guards(w, field);
+            auto fieldVersioning = versioning(field);
+            auto fieldContractDepth = push_member_contract_guards(w, fieldVersioning);
 
             w.write("    %_%", cpp_abi_name(), field.Name());
-            if (auto info = ::is_deprecated(field); info && w.config().enable_header_deprecation)
+            if (auto info = member_deprecation(fieldVersioning); info && w.config().enable_header_deprecation)
             {
                 w.write("\n");
                 write_deprecation_message(w, *info, 1, "DEPRECATEDENUMERATOR");
@@ -261,7 +384,7 @@ void enum_type::write_c_definition(writer& w) const
 
 void struct_type::write_cpp_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -286,7 +409,7 @@ void struct_type::write_cpp_abi_param(writer& w) const
 
 void struct_type::write_c_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -322,7 +445,7 @@ void struct_type::write_cpp_definition(writer& w) const
 
     for (auto const& member : members)
     {
-        if (auto info = ::is_deprecated(member.field); info && w.config().enable_header_deprecation)
+        if (auto info = member_deprecation(versioning(member.field)); info && w.config().enable_header_deprecation)
         {
             write_deprecation_message(w, *info, 1);
         }
@@ -357,7 +480,7 @@ void struct_type::write_c_definition(writer& w) const
 
     for (auto const& member : members)
     {
-        if (auto info = ::is_deprecated(member.field); info && w.config().enable_header_deprecation)
+        if (auto info = member_deprecation(versioning(member.field)); info && w.config().enable_header_deprecation)
         {
             write_deprecation_message(w, *info, 1);
         }
@@ -372,7 +495,7 @@ void struct_type::write_c_definition(writer& w) const
 
 void delegate_type::write_cpp_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -382,7 +505,7 @@ void delegate_type::write_cpp_forward_declaration(writer& w) const
 )^-^", bind_mangled_name_macro(*this), bind_mangled_name_macro(*this));
 
     w.push_namespace(clr_abi_namespace());
-    w.write("%interface %;\n", indent{}, m_abiName);
+    w.write("%interface %;\n", indent{}, cpp_abi_name());
     w.pop_namespace();
 
     w.write(R"^-^(#define % %
@@ -391,7 +514,7 @@ void delegate_type::write_cpp_forward_declaration(writer& w) const
 
 )^-^",
         bind_mangled_name_macro(*this),
-        bind_cpp_fully_qualified_type(clr_abi_namespace(), m_abiName),
+        bind_cpp_fully_qualified_type(clr_abi_namespace(), cpp_abi_name()),
         bind_mangled_name_macro(*this));
 }
 
@@ -421,56 +544,131 @@ static std::string_view function_name(MethodDef const& def)
     return fnName;
 }
 
-static void write_cpp_function_declaration(writer& w, function_def const& func)
+// A parameter as it appears in the ABI, where the return value is a trailing out parameter. Arrays get passed as their
+// length followed by a pointer to their first element
+struct abi_param
+{
+    std::string_view name;
+    metadata_type const* type;
+    std::string_view const_mod;
+    std::string_view length_ref_mod;
+    std::string_view ref_mod;
+    bool is_array;
+};
+
+// Everything that the C++ and C declarations of a function, as well as the C macro for calling it, get written from
+struct abi_function
+{
+    std::string_view name;
+    deprecation_info const* deprecation;
+    std::vector<abi_param> params;
+};
+
+// The functions of an interface or delegate, decoded once for both its C++ and C definitions. Interfaces that are
+// extended by a fast ABI class also get the functions of each of the class' supplemental interfaces
+struct abi_functions
 {
-    if (auto info = is_deprecated(func.def); info && w.config().enable_header_deprecation)
+    std::vector<abi_function> functions;
+    std::vector<std::vector<abi_function>> supplemental_functions;
+};
+
+static abi_function decode_function(function_def const& func)
+{
+    auto paramNames = func.def.ParamList();
+    auto sig = func.def.Signature();
+
+    abi_function result{ function_name(func.def), member_deprecation(func.versioning) };
+    result.params.reserve(func.param_types.size() + (sig.ReturnType() ? 1 : 0));
+
+    std::string_view returnName = "result"sv;
+    if (sig.ReturnType() && (paramNames.first != paramNames.second) && (paramNames.first.Sequence() == 0))
     {
-        write_deprecation_message(w, *info, 1);
+        returnName = paramNames.first.Name();
+        ++paramNames.first;
     }
 
-    w.write("%virtual HRESULT STDMETHODCALLTYPE %(", indent{ 1 }, function_name(func.def));
+    XLANG_ASSERT(static_cast<std::size_t>(distance(sig.Params())) == func.param_types.size());
+    auto typeItr = func.param_types.begin();
+    for (auto const& param : sig.Params())
+    {
+        XLANG_ASSERT(paramNames.first != paramNames.second);
+        auto isArray = param.Type().is_szarray();
+        auto lengthRefMod = param.ByRef() ? "*"sv : ""sv;
+        auto refMod = isArray ? (param.ByRef() ? "**"sv : "*"sv) : lengthRefMod;
+        auto constMod = is_const(param) ? "const "sv : ""sv;
+        result.params.push_back(abi_param{ paramNames.first.Name(), *typeItr++, constMod, lengthRefMod, refMod, isArray });
+        ++paramNames.first;
+    }
 
-    std::string_view prefix = "\n"sv;
-    for (auto const& param : func.params)
+    if (sig.ReturnType())
+    {
+        auto isArray = sig.ReturnType().Type().is_szarray();
+        result.params.push_back(abi_param{ returnName, func.return_type, ""sv, "*"sv, isArray ? "**"sv : "*"sv, isArray });
+    }
+
+    return result;
+}
+
+static std::vector<abi_function> decode_functions(std::vector<function_def> const& functions)
+{
+    std::vector<abi_function> result;
+    result.reserve(functions.size());
+    for (auto const& func : functions)
+    {
+        result.push_back(decode_function(func));
+    }
+
+    return result;
+}
+
+template <typename T>
+static abi_functions decode_functions(T const& type)
+{
+    abi_functions result{ decode_functions(type.functions) };
+    if constexpr (std::is_same_v<T, interface_type>)
     {
-        auto refMod = param.signature.ByRef() ? "*"sv : ""sv;
-        if (param.signature.Type().is_szarray())
+        if (type.fast_class)
         {
-            w.write("%%UINT32% %Length", prefix, indent{ 2 }, refMod, param.name);
-            refMod = param.signature.ByRef() ? "**"sv : "*"sv;
-            prefix = ",\n";
+            result.supplemental_functions.reserve(type.fast_class->supplemental_fast_interfaces.size());
+            for (auto [iface, ver] : type.fast_class->supplemental_fast_interfaces)
+            {
+                result.supplemental_functions.push_back(decode_functions(iface->functions));
+            }
         }
+    }
 
-        auto constMod = is_const(param.signature) ? "const "sv : ""sv;
-        w.write("%%%%% %",
-            prefix,
-            indent{ 2 },
-            constMod,
-            [&](writer& w) { param.type->write_cpp_abi_param(w); },
-            refMod,
-            param.name);
-        prefix = ",\n";
+    return result;
+}
+
+static void write_cpp_function_declaration(writer& w, abi_function const& func)
+{
+    if (func.deprecation && w.config().enable_header_deprecation)
+    {
+        write_deprecation_message(w, *func.deprecation, 1);
     }
 
-    if (func.return_type)
+    w.write("%virtual HRESULT STDMETHODCALLTYPE %(", indent{ 1 }, func.name);
+
+    std::string_view prefix = "\n"sv;
+    for (auto const& param : func.params)
     {
-        auto refMod = "*"sv;
-        if (func.return_type->signature.Type().is_szarray())
+        if (param.is_array)
         {
-            w.write("%%UINT32* %Length", prefix, indent{ 2 }, func.return_type->name);
-            refMod = "**"sv;
+            w.write("%%UINT32% %Length", prefix, indent{ 2 }, param.length_ref_mod, param.name);
             prefix = ",\n";
         }
 
-        w.write("%%%% %",
+        w.write("%%%%% %",
             prefix,
             indent{ 2 },
-            [&](writer& w) { func.return_type->type->write_cpp_abi_param(w); },
-            refMod,
-            func.return_type->name);
+            param.const_mod,
+            [&](writer& w) { param.type->write_cpp_abi_param(w); },
+            param.ref_mod,
+            param.name);
+        prefix = ",\n";
     }
 
-    if (func.params.empty() && !func.return_type)
+    if (func.params.empty())
     {
         w.write("void) = 0;\n");
     }
@@ -481,7 +679,7 @@ static void write_cpp_function_declaration(writer& w, function_def const& func)
 }
 
 template <typename T>
-static void write_cpp_interface_definition(writer& w, T const& type)
+static void write_cpp_interface_definition(writer& w, T const& type, abi_functions const& functions)
 {
     constexpr bool is_delegate = std::is_same_v<T, delegate_type>;
     constexpr bool is_interface = std::is_same_v<T, interface_type>;
@@ -492,7 +690,7 @@ static void write_cpp_interface_definition(writer& w, T const& type)
     w.write(R"^-^(%MIDL_INTERFACE("%")
 )^-^", indent{}, bind_uuid(type));
 
-    if (auto info = is_deprecated(type.type()); info && w.config().enable_header_deprecation)
+    if (auto info = type.is_deprecated(); info && w.config().enable_header_deprecation)
     {
         write_deprecation_message(w, *info);
     }
@@ -513,7 +711,7 @@ static void write_cpp_interface_definition(writer& w, T const& type)
 %public:
 )^-^", indent{}, indent{});
 
-    for (auto const& func : type.functions)
+    for (auto const& func : functions.functions)
     {
         write_cpp_function_declaration(w, func);
     }
@@ -541,12 +739,13 @@ static void write_cpp_interface_definition(writer& w, T const& type)
                 w.write("%virtual % base_%() = 0;\n", indent{}, [&](writer& w) { baseClass->write_cpp_abi_param(w); }, baseClass->cpp_logical_name());
             });
 
+            auto supplementalItr = functions.supplemental_functions.begin();
             for (auto [iface, ver] : type.fast_class->supplemental_fast_interfaces)
             {
                 w.write("\n%// Supplemental functions added for the % interface\n", indent{}, iface->clr_full_name());
                 fastContractDepth += w.push_contract_guard(ver) ? 1 : 0;
 
-                for (auto const& func : iface->functions)
+                for (auto const& func : *supplementalItr++)
                 {
                     write_cpp_function_declaration(w, func);
                 }
@@ -621,109 +820,61 @@ static void write_c_iinspectable_interface_macros(writer& w, T const& type)
 }
 
 template <typename TypeName>
-static void write_c_function_declaration(writer& w, TypeName&& typeName, function_def const& func)
+static void write_c_function_declaration(writer& w, TypeName&& typeName, abi_function const& func)
 {
-    if (auto info = is_deprecated(func.def); info && w.config().enable_header_deprecation)
+    if (func.deprecation && w.config().enable_header_deprecation)
     {
-        write_deprecation_message(w, *info, 1);
+        write_deprecation_message(w, *func.deprecation, 1);
     }
 
-    w.write("    HRESULT (STDMETHODCALLTYPE* %)(%* This", function_name(func.def), typeName);
+    w.write("    HRESULT (STDMETHODCALLTYPE* %)(%* This", func.name, typeName);
 
     for (auto const& param : func.params)
     {
-        auto refMod = param.signature.ByRef() ? "*"sv : ""sv;
-        if (param.signature.Type().is_szarray())
+        if (param.is_array)
         {
-            w.write(",\n        UINT32% %Length", refMod, param.name);
-            refMod = param.signature.ByRef() ? "**"sv : "*"sv;
+            w.write(",\n        UINT32% %Length", param.length_ref_mod, param.name);
         }
 
-        auto constMod = is_const(param.signature) ? "const "sv : ""sv;
         w.write(",\n        %%% %",
-            constMod,
+            param.const_mod,
             [&](writer& w) { param.type->write_c_abi_param(w); },
-            refMod,
+            param.ref_mod,
             param.name);
     }
 
-    if (func.return_type)
-    {
-        auto refMod = "*"sv;
-        if (func.return_type->signature.Type().is_szarray())
-        {
-            w.write(",\n        UINT32* %Length", func.return_type->name);
-            refMod = "**"sv;
-        }
-
-        w.write(",\n        %% %",
-            [&](writer& w) { func.return_type->type->write_c_abi_param(w); },
-            refMod,
-            func.return_type->name);
-    }
-
     w.write(");\n");
 }
 
 template <typename T>
-static void write_c_function_declaration_macro(writer& w, T const& type, function_def const& func)
+static void write_c_function_declaration_macro(writer& w, T const& type, abi_function const& func)
 {
-    if (auto info = is_deprecated(func.def); info && w.config().enable_header_deprecation)
+    if (func.deprecation && w.config().enable_header_deprecation)
     {
-        write_deprecation_message(w, *info, 1);
-    }
-
-    auto fnName = function_name(func.def);
-    w.write("#define %_%(This", bind_mangled_name_macro(type), fnName);
-
-    for (auto const& param : func.params)
-    {
-        if (param.signature.Type().is_szarray())
-        {
-            w.write(", %Length", param.name);
-        }
-
-        w.write(", %", param.name);
-    }
-
-    if (func.return_type)
-    {
-        if (func.return_type->signature.Type().is_szarray())
-        {
-            w.write(", %Length", func.return_type->name);
-        }
-
-        w.write(", %", func.return_type->name);
+        write_deprecation_message(w, *func.deprecation, 1);
     }
 
-    w.write(R"^-^() \
-    ((This)->lpVtbl->%(This)^-^", fnName);
-
-    for (auto const& param : func.params)
+    auto write_args = [&](writer& w)
     {
-        if (param.signature.Type().is_szarray())
+        for (auto const& param : func.params)
         {
-            w.write(", %Length", param.name);
-        }
-
-        w.write(", %", param.name);
-    }
+            if (param.is_array)
+            {
+                w.write(", %Length", param.name);
+            }
 
-    if (func.return_type)
-    {
-        if (func.return_type->signature.Type().is_szarray())
-        {
-            w.write(", %Length", func.return_type->name);
+            w.write(", %", param.name);
         }
+    };
 
-        w.write(", %", func.return_type->name);
-    }
+    w.write(R"^-^(#define %_%(This%) \
+    ((This)->lpVtbl->%(This%))
 
-    w.write("))\n\n");
+)^-^", bind_mangled_name_macro(type), func.name, write_args, func.name, write_args);
 }
 
 template <typename T>
-static void write_c_interface_definition(writer& w, T const& type)
+static void write_c_interface_definition(writer& w, T const& type, abi_functions const& functions)
 {
     constexpr bool is_interface = std::is_same_v<T, interface_type>;
     constexpr bool is_delegate = std::is_same_v<T, delegate_type>;
@@ -757,7 +908,7 @@ static void write_c_interface_definition(writer& w, T const& type)
         write_c_iinspectable_interface(w, type);
     }
 
-    for (auto const& func : type.functions)
+    for (auto const& func : functions.functions)
     {
         write_c_function_declaration(w, bind_c_type_name(type), func);
     }
@@ -788,12 +939,13 @@ static void write_c_interface_definition(writer& w, T const& type)
                     bind_c_type_name(type));
             });
 
+            auto supplementalItr = functions.supplemental_functions.begin();
             for (auto [iface, ver] : type.fast_class->supplemental_fast_interfaces)
             {
                 w.write("\n    // Supplemental functions added for the % interface\n", iface->clr_full_name());
                 fastContractDepth += w.push_contract_guard(ver) ? 1 : 0;
 
-                for (auto const& func : iface->functions)
+                for (auto const& func : *supplementalItr++)
                 {
                     write_c_function_declaration(w, bind_c_type_name(type), func);
                 }
@@ -825,7 +977,7 @@ interface %
         write_c_iinspectable_interface_macros(w, type);
     }
 
-    for (auto const& func : type.functions)
+    for (auto const& func : functions.functions)
     {
         write_c_function_declaration_macro(w, type, func);
     }
@@ -857,13 +1009,14 @@ interface %
 )^-^", bind_mangled_name_macro(type), baseClass->cpp_logical_name(), baseClass->cpp_logical_name());
             });
 
+            auto supplementalItr = functions.supplemental_functions.begin();
             for (auto [iface, ver] : type.fast_class->supplemental_fast_interfaces)
             {
                 w.write("// Supplemental functions added for the % interface\n", iface->clr_full_name());
                 fastContractDepth += w.push_contract_guard(ver) ? 1 : 0;
                 w.write("\n");
 
-                for (auto const& func : iface->functions)
+                for (auto const& func : *supplementalItr++)
                 {
                     write_c_function_declaration_macro(w, type, func);
                 }
@@ -883,7 +1036,7 @@ interface %
 
 void delegate_type::write_c_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -907,21 +1060,19 @@ void delegate_type::write_c_abi_param(writer& w) const
     w.write("%*", bind_c_type_name(*this));
 }
 
-static void write_delegate_definition(writer& w, delegate_type const& type, void (*func)(writer&, delegate_type const&))
+static void write_delegate_definition(
+    writer& w,
+    delegate_type const& type,
+    abi_functions const& functions,
+    void (*func)(writer&, delegate_type const&, abi_functions const&))
 {
-    // Generics don't get generated definitions
-    if (type.is_generic())
-    {
-        return;
-    }
-
     auto contractDepth = begin_type_definition(w, type);
 
     w.write(R"^-^(#if !defined(__%_INTERFACE_DEFINED__)
 #define __%_INTERFACE_DEFINED__
 )^-^", bind_mangled_name_macro(type), bind_mangled_name_macro(type));
 
-    func(w, type);
+    func(w, type, functions);
 
     w.write(R"^-^(
 EXTERN_C const IID %;
@@ -931,19 +1082,22 @@ EXTERN_C const IID %;
     end_type_definition(w, type, contractDepth);
 }
 
-void delegate_type::write_cpp_definition(writer& w) const
+void delegate_type::write_definitions(writer& cppWriter, writer& cWriter) const
 {
-    write_delegate_definition(w, *this, &write_cpp_interface_definition<delegate_type>);
-}
+    // Generics don't get generated definitions
+    if (is_generic())
+    {
+        return;
+    }
 
-void delegate_type::write_c_definition(writer& w) const
-{
-    write_delegate_definition(w, *this, &write_c_interface_definition<delegate_type>);
+    auto const functions = decode_functions(*this);
+    write_delegate_definition(cppWriter, *this, functions, &write_cpp_interface_definition<delegate_type>);
+    write_delegate_definition(cWriter, *this, functions, &write_c_interface_definition<delegate_type>);
 }
 
 void interface_type::write_cpp_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -979,7 +1133,7 @@ void interface_type::write_cpp_abi_param(writer& w) const
 
 void interface_type::write_c_forward_declaration(writer& w) const
 {
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -1003,14 +1157,12 @@ void interface_type::write_c_abi_param(writer& w) const
     w.write("%*", bind_c_type_name(*this));
 }
 
-static void write_interface_definition(writer& w, interface_type const& type, void (*func)(writer&, interface_type const&))
+static void write_interface_definition(
+    writer& w,
+    interface_type const& type,
+    abi_functions const& functions,
+    void (*func)(writer&, interface_type const&, abi_functions const&))
 {
-    // Generics don't get generated definitions
-    if (type.is_generic())
-    {
-        return;
-    }
-
     auto contractDepth = begin_type_definition(w, type);
 
     w.write(R"^-^(#if !defined(__%_INTERFACE_DEFINED__)
@@ -1023,7 +1175,7 @@ extern const __declspec(selectany) _Null_terminated_ WCHAR InterfaceName_%_%[] =
         type.cpp_abi_name(),
         type.clr_full_name());
 
-    func(w, type);
+    func(w, type, functions);
 
     w.write(R"^-^(
 EXTERN_C const IID %;
@@ -1033,14 +1185,17 @@ EXTERN_C const IID %;
     end_type_definition(w, type, contractDepth);
 }
 
-void interface_type::write_cpp_definition(writer& w) const
+void interface_type::write_definitions(writer& cppWriter, writer& cWriter) const
 {
-    write_interface_definition(w, *this, &write_cpp_interface_definition<interface_type>);
-}
+    // Generics don't get generated definitions
+    if (is_generic())
+    {
+        return;
+    }
 
-void interface_type::write_c_definition(writer& w) const
-{
-    write_interface_definition(w, *this, &write_c_interface_definition<interface_type>);
+    auto const functions = decode_functions(*this);
+    write_interface_definition(cppWriter, *this, functions, &write_cpp_interface_definition<interface_type>);
+    write_interface_definition(cWriter, *this, functions, &write_c_interface_definition<interface_type>);
 }
 
 void class_type::write_cpp_forward_declaration(writer& w) const
@@ -1048,10 +1203,10 @@ void class_type::write_cpp_forward_declaration(writer& w) const
     if (!default_interface)
     {
         XLANG_ASSERT(false);
-        xlang::throw_invalid("Cannot forward declare class '", m_clrFullName, "' since it has no default interface");
+        xlang::throw_invalid("Cannot forward declare class '", clr_full_name(), "' since it has no default interface");
     }
 
-    if (!w.should_forward_declare(m_mangledName))
+    if (!w.should_forward_declare(mangled_name()))
     {
         return;
     }
@@ -1075,7 +1230,7 @@ void class_type::write_cpp_generic_param_abi_type(writer& w) const
     if (!default_interface)
     {
         XLANG_ASSERT(false);
-        xlang::throw_invalid("Class '", m_clrFullName, "' cannot be used as a generic parameter since it has no "
+        xlang::throw_invalid("Class '", clr_full_name(), "' cannot be used as a generic parameter since it has no "
             "default interface");
     }
 
@@ -1092,7 +1247,7 @@ void class_type::write_cpp_abi_param(writer& w) const
     if (!default_interface)
     {
         XLANG_ASSERT(false);
-        xlang::throw_invalid("Class '", m_clrFullName, "' cannot be used as a function argument since it has no "
+        xlang::throw_invalid("Class '", clr_full_name(), "' cannot be used as a function argument since it has no "
             "default interface");
     }
 
@@ -1104,7 +1259,7 @@ void class_type::write_c_forward_declaration(writer& w) const
     if (!default_interface)
     {
         XLANG_ASSERT(false);
-        xlang::throw_invalid("Cannot forward declare class '", m_clrFullName, "' since it has no default interface");
+        xlang::throw_invalid("Cannot forward declare class '", clr_full_name(), "' since it has no default interface");
     }
 
     default_interface->write_c_forward_declaration(w);
@@ -1115,7 +1270,7 @@ void class_type::write_c_abi_param(writer& w) const
     if (!default_interface)
     {
         XLANG_ASSERT(false);
-        xlang::throw_invalid("Class '", m_clrFullName, "' cannot be used as a function argument since it has no "
+        xlang::throw_invalid("Class '", clr_full_name(), "' cannot be used as a function argument since it has no "
             "default interface");
     }
 
@@ -1168,7 +1323,7 @@ std::size_t generic_inst::push_contract_guards(writer& w) const
 
 void generic_inst::write_cpp_forward_declaration(writer& w) const
 {
-    if (!w.begin_declaration(m_mangledName))
+    if (!w.begin_declaration(mangled_name()))
     {
         return;
     }
@@ -1185,6 +1340,13 @@ void generic_inst::write_cpp_forward_declaration(writer& w) const
         param->write_cpp_forward_declaration(w);
     }
 
+    // Everything else about the definition only depends on this instantiation
+    w.write_deferred([this](writer& w) { write_cpp_definition(w); });
+    w.end_declaration(mangled_name());
+}
+
+void generic_inst::write_cpp_definition(writer& w) const
+{
     auto isExperimental = is_experimental();
     if (isExperimental)
     {
@@ -1197,7 +1359,7 @@ void generic_inst::write_cpp_forward_declaration(writer& w) const
     w.write(R"^-^(#ifndef DEF_%_USE
 #define DEF_%_USE
 #if !defined(RO_NO_TEMPLATE_NAME)
-)^-^", m_mangledName, m_mangledName);
+)^-^", mangled_name(), mangled_name());
 
     w.push_inline_namespace(clr_abi_namespace());
 
@@ -1241,7 +1403,7 @@ struct __declspec(uuid("%"))
 // This allows code which uses the mangled name for the parameterized interface to access the
 // correct parameterized interface specialization.
 typedef % %_t;
-)^-^", m_clrFullName, write_cpp_name, m_mangledName);
+)^-^", clr_full_name(), write_cpp_name, mangled_name());
 
     if (w.config().ns_prefix_state == ns_prefix::optional)
     {
@@ -1250,13 +1412,13 @@ typedef % %_t;
 #else
 #define % @::%_t
 #endif // MIDL_NS_PREFIX
-)^-^", m_mangledName, clr_abi_namespace(), m_mangledName, m_mangledName, clr_abi_namespace(), m_mangledName);
+)^-^", mangled_name(), clr_abi_namespace(), mangled_name(), mangled_name(), clr_abi_namespace(), mangled_name());
     }
     else
     {
         auto nsPrefix = (w.config().ns_prefix_state == ns_prefix::always) ? "ABI::"sv : "";
         w.write(R"^-^(#define % %@::%_t
-)^-^", m_mangledName, nsPrefix, clr_abi_namespace(), m_mangledName);
+)^-^", mangled_name(), nsPrefix, clr_abi_namespace(), mangled_name());
     }
 
     w.pop_inline_namespace();
@@ -1265,7 +1427,7 @@ typedef % %_t;
 #endif // !defined(RO_NO_TEMPLATE_NAME)
 #endif /* DEF_%_USE */
 
-)^-^", m_mangledName);
+)^-^", mangled_name());
 
     w.pop_contract_guards(contractDepth);
     if (isExperimental)
@@ -1274,7 +1436,6 @@ typedef % %_t;
     }
 
     w.write('\n');
-    w.end_declaration(m_mangledName);
 }
 
 void generic_inst::write_cpp_generic_param_logical_type(writer& w) const
@@ -1290,21 +1451,21 @@ void generic_inst::write_cpp_generic_param_abi_type(writer& w) const
 
 void generic_inst::write_cpp_abi_name(writer& w) const
 {
-    w.write(m_mangledName);
+    w.write(mangled_name());
 }
 
 void generic_inst::write_cpp_abi_param(writer& w) const
 {
-    w.write("%*", m_mangledName);
+    w.write("%*", mangled_name());
 }
 
 void generic_inst::write_c_forward_declaration(writer& w) const
 {
-    if (!w.begin_declaration(m_mangledName))
+    if (!w.begin_declaration(mangled_name()))
     {
-        if (w.should_forward_declare(m_mangledName))
+        if (w.should_forward_declare(mangled_name()))
         {
-            w.write("typedef interface % %;\n\n", m_mangledName, m_mangledName);
+            w.write("typedef interface % %;\n\n", mangled_name(), mangled_name());
         }
 
         return;
@@ -1322,6 +1483,12 @@ void generic_inst::write_c_forward_declaration(writer& w) const
         dep->write_c_forward_declaration(w);
     }
 
+    w.write_deferred([this](writer& w) { write_c_definition(w); });
+    w.end_declaration(mangled_name());
+}
+
+void generic_inst::write_c_definition(writer& w) const
+{
     auto isExperimental = is_experimental();
     if (isExperimental)
     {
@@ -1338,13 +1505,13 @@ typedef interface % %;
 //  Declare the parameterized interface IID.
 EXTERN_C const IID IID_%;
 
-)^-^", m_mangledName, m_mangledName, m_mangledName, m_mangledName, m_mangledName);
+)^-^", mangled_name(), mangled_name(), mangled_name(), mangled_name(), mangled_name());
 
-    write_c_interface_definition(w, *this);
+    write_c_interface_definition(w, *this, decode_functions(*this));
 
     w.write(R"^-^(
 #endif // __%_INTERFACE_DEFINED__
-)^-^", m_mangledName);
+)^-^", mangled_name());
 
     w.pop_contract_guards(contractDepth);
     if (isExperimental)
@@ -1353,12 +1520,89 @@ EXTERN_C const IID IID_%;
     }
 
     w.write('\n');
-    w.end_declaration(m_mangledName);
 }
 
 void generic_inst::write_c_abi_param(writer& w) const
 {
-    w.write("%*", m_mangledName);
+    w.write("%*", mangled_name());
+}
+
+static void add_shared_header_namespaces(metadata_type const& type, std::set<std::string_view>& result)
+{
+    if (auto inst = dynamic_cast<generic_inst const*>(&type))
+    {
+        result.insert(inst->generic_type()->clr_abi_namespace());
+        result.insert(inst->dependent_namespaces.begin(), inst->dependent_namespaces.end());
+        for (auto param : inst->generic_params())
+        {
+            add_shared_header_namespaces(*param, result);
+        }
+    }
+    else if (dynamic_cast<typedef_base const*>(&type))
+    {
+        result.insert(type.clr_abi_namespace());
+    }
+}
+
+std::string_view generic_inst::shared_header_name() const
+{
+    // Namespaces beyond the first are only named while the name stays this long, so that file paths stay well within
+    // MAX_PATH however many namespaces an instantiation spans
+    static constexpr std::size_t max_named_length = 96;
+
+    return m_sharedHeaderName.get([&](std::string& result)
+    {
+        std::set<std::string_view> namespaces;
+        add_shared_header_namespaces(*this, namespaces);
+
+        // Every header already depends on the foundation namespaces, so they don't need to be part of the name
+        namespaces.erase(system_namespace);
+        namespaces.erase(foundation_namespace);
+        namespaces.erase(collections_namespace);
+
+        if (namespaces.empty())
+        {
+            result = foundation_namespace;
+        }
+        else
+        {
+            result = *namespaces.begin();
+            for (auto itr = std::next(namespaces.begin()); itr != namespaces.end(); ++itr)
+            {
+                if (result.size() + itr->size() >= max_named_length)
+                {
+                    break;
+                }
+
+                result.push_back('.');
+                result += *itr;
+            }
+        }
+
+        // Joining several namespaces with dots is ambiguous ({A, B.C} and {A.B, C} both give A.B.C) and may leave some
+        // of them out, so such names also get a hash of the whole set. Namespaces can't contain nulls, so terminating
+        // each with one keeps the hashed text unambiguous
+        if (namespaces.size() > 1)
+        {
+            sha1 namespacesHash;
+            for (auto ns : namespaces)
+            {
+                namespacesHash.append(ns);
+                namespacesHash.append(std::string_view{ "\0", 1 });
+            }
+
+            auto hash = namespacesHash.finalize();
+            static constexpr char hex_digits[] = "0123456789abcdef";
+            result.push_back('.');
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                result.push_back(hex_digits[hash[i] >> 4]);
+                result.push_back(hex_digits[hash[i] & 0x0F]);
+            }
+        }
+
+        result += ".generics"sv;
+    });
 }
 
 element_type const& element_type::from_type(xlang::meta::reader::ElementType type)
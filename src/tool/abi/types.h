@@ -1,12 +1,50 @@
 #pragma once
 
+#include <atomic>
+
 #include "meta_reader.h"
-#include "sha1.h"
 #include "type_names.h"
 #include "versioning.h"
 
 struct writer;
 
+// Names and signatures are built the first time that they get used and then live in an arena for the rest of the run, so
+// an unused name only costs a pointer and a used one costs no more than its characters. Building is idempotent, so two
+// threads may race to build the same string, in which case only the first result gets published
+struct lazy_string
+{
+    lazy_string() = default;
+
+    lazy_string(lazy_string&& other) noexcept :
+        m_value(other.m_value.load(std::memory_order_relaxed))
+    {
+    }
+
+    template <typename Builder>
+    std::string_view get(Builder&& build) const
+    {
+        auto value = m_value.load(std::memory_order_acquire);
+        if (!value)
+        {
+            std::string result;
+            build(result);
+            auto interned = intern(result);
+            if (m_value.compare_exchange_strong(value, interned, std::memory_order_acq_rel))
+            {
+                value = interned;
+            }
+        }
+
+        return *value;
+    }
+
+private:
+
+    static std::string_view const* intern(std::string_view value);
+
+    mutable std::atomic<std::string_view const*> m_value{};
+};
+
 struct metadata_type
 {
     virtual std::string_view clr_full_name() const = 0;
@@ -19,7 +57,13 @@ struct metadata_type
     virtual std::string_view mangled_name() const = 0;
     virtual std::string_view generic_param_mangled_name() const = 0;
 
-    virtual void append_signature(sha1& hash) const = 0;
+    // The signature and generated IID of a type are computed on first use and cached, so that generic instantiations
+    // reuse the signatures of their arguments. The IID cache is not synchronized, so metadata_cache fills it in for all
+    // generic instantiations before any headers get written
+    std::string_view signature() const;
+    std::array<std::uint8_t, 16> const& generated_iid() const;
+
+    virtual void append_signature(std::string& result) const = 0;
 
     virtual std::size_t push_contract_guards(writer& w) const = 0;
 
@@ -43,6 +87,11 @@ struct metadata_type
     {
         return std::nullopt;
     }
+
+private:
+
+    lazy_string m_signatureCache;
+    mutable std::optional<std::array<std::uint8_t, 16>> m_generatedIidCache;
 };
 
 inline bool operator<(metadata_type const& lhs, metadata_type const& rhs) noexcept
@@ -118,9 +167,9 @@ struct element_type final : metadata_type
         return m_mangledName;
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
-        hash.append(m_signature);
+        result += m_signature;
     }
 
     virtual std::size_t push_contract_guards(writer&) const override
@@ -217,9 +266,9 @@ struct system_type final : metadata_type
         return m_cppName;
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
-        hash.append(m_signature);
+        result += m_signature;
     }
 
     virtual std::size_t push_contract_guards(writer&) const override
@@ -319,9 +368,9 @@ struct mapped_type final : metadata_type
         return m_mangledName;
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
-        hash.append(m_signature);
+        result += m_signature;
     }
 
     virtual std::size_t push_contract_guards(writer&) const override
@@ -398,7 +447,7 @@ struct typedef_base : metadata_type
 
     virtual std::string_view clr_full_name() const override
     {
-        return m_clrFullName;
+        return m_clrFullName.get([&](std::string& result) { result = ::clr_full_name(m_type); });
     }
 
     virtual std::string_view cpp_abi_name() const override
@@ -415,14 +464,14 @@ struct typedef_base : metadata_type
 
     virtual std::string_view mangled_name() const override
     {
-        return m_mangledName;
+        return m_mangledName.get([&](std::string& result) { result = ::mangled_name<false>(m_type); });
     }
 
     virtual std::string_view generic_param_mangled_name() const override
     {
         // Only generic instantiations should be used as generic params
         XLANG_ASSERT(!is_generic());
-        return m_genericParamMangledName;
+        return m_genericParamMangledName.get([&](std::string& result) { result = ::mangled_name<true>(m_type); });
     }
 
     virtual std::size_t push_contract_guards(writer& w) const override;
@@ -442,14 +491,14 @@ struct typedef_base : metadata_type
 
     virtual std::optional<std::size_t> contract_index(std::string_view typeName, std::size_t version) const override
     {
-        if (!m_contractHistory)
+        if (!m_versioning.history)
         {
             return std::nullopt;
         }
 
         // Start with previous contracts
         std::size_t result = 0;
-        for (auto& prev : m_contractHistory->previous_contracts)
+        for (auto& prev : m_versioning.history->previous_contracts)
         {
             if ((prev.type_name == typeName) && (prev.version_introduced <= version) && (prev.version_removed > version))
             {
@@ -460,7 +509,7 @@ struct typedef_base : metadata_type
         }
 
         // Now the current contract
-        if ((m_contractHistory->current_contract.type_name == typeName) && (m_contractHistory->current_contract.version <= version))
+        if ((m_versioning.history->current_contract.type_name == typeName) && (m_versioning.history->current_contract.version <= version))
         {
             return result;
         }
@@ -470,13 +519,13 @@ struct typedef_base : metadata_type
 
     virtual std::optional<contract_version> contract_from_index(std::size_t index) const override
     {
-        if (!m_contractHistory)
+        if (!m_versioning.history)
         {
             return std::nullopt;
         }
 
         // Start with previous contracts
-        for (auto& prev : m_contractHistory->previous_contracts)
+        for (auto& prev : m_versioning.history->previous_contracts)
         {
             if (index-- == 0)
             {
@@ -486,7 +535,7 @@ struct typedef_base : metadata_type
 
         if (index == 0)
         {
-            return m_contractHistory->current_contract;
+            return m_versioning.history->current_contract;
         }
 
         XLANG_ASSERT(false);
@@ -503,9 +552,22 @@ struct typedef_base : metadata_type
         return ::is_generic(m_type);
     }
 
-    auto is_deprecated() const noexcept
+    deprecation_info const* is_deprecated() const noexcept
+    {
+        return m_versioning.deprecation.get();
+    }
+
+    versioning_info const& versioning() const noexcept
+    {
+        return m_versioning;
+    }
+
+    // The versioning information of a field, method, or interface implementation of this type, or null if it has none
+    template <typename T>
+    versioning_info const* versioning(T const& member) const noexcept
     {
-        return ::is_deprecated(m_type);
+        using namespace xlang::meta::reader;
+        return member_versioning(member_key{ index_tag_v<HasCustomAttribute, T>, member.index() });
     }
 
     xlang::meta::reader::category category() const noexcept
@@ -517,14 +579,21 @@ protected:
 
     xlang::meta::reader::TypeDef m_type;
 
-    // These strings are initialized by the base class
-    std::string m_clrFullName;
-    std::string m_mangledName;
-    std::string m_genericParamMangledName;
+    // These strings are built by the base class on first use
+    lazy_string m_clrFullName;
+    lazy_string m_mangledName;
+    lazy_string m_genericParamMangledName;
+
+    // Versioning information filled in by the base class constructor, which runs in parallel while the metadata cache
+    // is built. Most members have no versioning attributes, so only those that do get a record, ordered by their table
+    // and row
+    using member_key = std::pair<xlang::meta::reader::HasCustomAttribute, std::uint32_t>;
+    versioning_info m_versioning;
+    std::vector<std::pair<member_key, versioning_info>> m_memberVersioning;
 
-    // Versioning information filled in by the base class constructor
-    std::vector<platform_version> m_platformVersions;
-    std::optional<contract_history> m_contractHistory;
+private:
+
+    versioning_info const* member_versioning(member_key key) const noexcept;
 };
 
 struct enum_type final : typedef_base
@@ -534,14 +603,14 @@ struct enum_type final : typedef_base
     {
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
-        hash.append("enum("sv);
-        hash.append(m_clrFullName);
-        hash.append(";"sv);
-        element_type::from_type(underlying_type()).append_signature(hash);
-        hash.append(")"sv);
+        result += "enum("sv;
+        result += clr_full_name();
+        result += ";"sv;
+        result += element_type::from_type(underlying_type()).signature();
+        result += ")"sv;
     }
 
     virtual void write_cpp_forward_declaration(writer& w) const override;
@@ -573,18 +642,18 @@ struct struct_type final : typedef_base
     {
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
         XLANG_ASSERT(members.size() == static_cast<std::size_t>(distance(m_type.FieldList())));
-        hash.append("struct("sv);
-        hash.append(m_clrFullName);
+        result += "struct("sv;
+        result += clr_full_name();
         for (auto const& member : members)
         {
-            hash.append(";");
-            member.type->append_signature(hash);
+            result += ";"sv;
+            result += member.type->signature();
         }
-        hash.append(")"sv);
+        result += ")"sv;
     }
 
     virtual void write_cpp_forward_declaration(writer& w) const override;
@@ -600,25 +669,15 @@ struct struct_type final : typedef_base
     std::vector<struct_member> members;
 };
 
-struct function_return_type
-{
-    xlang::meta::reader::RetTypeSig signature;
-    std::string_view name;
-    metadata_type const* type;
-};
-
-struct function_param
-{
-    xlang::meta::reader::ParamSig signature;
-    std::string_view name;
-    metadata_type const* type;
-};
-
+// Functions only hold on to their method, its versioning information and the types that their return value and
+// parameters resolve to. The parameter names and signatures get decoded from the metadata again whenever the type that
+// they belong to is written
 struct function_def
 {
     xlang::meta::reader::MethodDef def;
-    std::optional<function_return_type> return_type;
-    std::vector<function_param> params;
+    versioning_info const* versioning = nullptr;
+    metadata_type const* return_type = nullptr;
+    std::vector<metadata_type const*> param_types;
 };
 
 struct delegate_type final : typedef_base
@@ -626,30 +685,32 @@ struct delegate_type final : typedef_base
     delegate_type(xlang::meta::reader::TypeDef const& type) :
         typedef_base(type)
     {
-        m_abiName.reserve(1 + type.TypeName().length());
-        details::append_type_prefix(m_abiName, type);
-        m_abiName += type.TypeName();
     }
 
     virtual std::string_view cpp_abi_name() const override
     {
-        return m_abiName;
+        return m_abiName.get([&](std::string& result)
+        {
+            result.reserve(1 + m_type.TypeName().length());
+            details::append_type_prefix(result, m_type);
+            result += m_type.TypeName();
+        });
     }
 
     virtual std::string_view cpp_logical_name() const override
     {
         // Even though the ABI name of delegates is different than their CLR name, the logical name is still the same as
         // the ABI name
-        return m_abiName;
+        return cpp_abi_name();
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
-        hash.append("delegate({"sv);
+        result += "delegate({"sv;
         auto iid = type_iid(m_type);
-        hash.append(std::string_view{ iid.data(), iid.size() - 1 });
-        hash.append("})"sv);
+        result += std::string_view{ iid.data(), iid.size() - 1 };
+        result += "})"sv;
     }
 
     virtual void write_cpp_forward_declaration(writer& w) const override;
@@ -659,14 +720,14 @@ struct delegate_type final : typedef_base
     virtual void write_c_forward_declaration(writer& w) const override;
     virtual void write_c_abi_param(writer& w) const override;
 
-    void write_cpp_definition(writer& w) const;
-    void write_c_definition(writer& w) const;
+    // Writes both the C++ and C definitions, so that the functions only get decoded once for the two of them
+    void write_definitions(writer& cppWriter, writer& cWriter) const;
 
     std::vector<function_def> functions;
 
 private:
 
-    std::string m_abiName;
+    lazy_string m_abiName;
 };
 
 struct class_type;
@@ -678,13 +739,13 @@ struct interface_type final : typedef_base
     {
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
-        hash.append("{"sv);
+        result += "{"sv;
         auto iid = type_iid(m_type);
-        hash.append(std::string_view{ iid.data(), iid.size() - 1 });
-        hash.append("}"sv);
+        result += std::string_view{ iid.data(), iid.size() - 1 };
+        result += "}"sv;
     }
 
     virtual void write_cpp_forward_declaration(writer& w) const override;
@@ -694,8 +755,8 @@ struct interface_type final : typedef_base
     virtual void write_c_forward_declaration(writer& w) const override;
     virtual void write_c_abi_param(writer& w) const override;
 
-    void write_cpp_definition(writer& w) const;
-    void write_c_definition(writer& w) const;
+    // Writes both the C++ and C definitions, so that the functions only get decoded once for the two of them
+    void write_definitions(writer& cppWriter, writer& cWriter) const;
 
     std::vector<metadata_type const*> required_interfaces;
     std::vector<function_def> functions;
@@ -758,7 +819,7 @@ struct class_type final : typedef_base
         return default_interface->cpp_abi_name();
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
         if (!default_interface)
@@ -767,11 +828,11 @@ struct class_type final : typedef_base
                 "does not have a signature");
         }
 
-        hash.append("rc("sv);
-        hash.append(m_clrFullName);
-        hash.append(";"sv);
-        default_interface->append_signature(hash);
-        hash.append(")"sv);
+        result += "rc("sv;
+        result += clr_full_name();
+        result += ";"sv;
+        result += default_interface->signature();
+        result += ")"sv;
     }
 
     virtual void write_cpp_forward_declaration(writer& w) const override;
@@ -801,24 +862,6 @@ struct generic_inst final : metadata_type
         m_genericType(genericType),
         m_genericParams(std::move(genericParams))
     {
-        m_clrFullName = genericType->clr_full_name();
-        m_clrFullName.push_back('<');
-
-        m_mangledName = genericType->mangled_name();
-
-        std::string_view prefix;
-        for (auto param : m_genericParams)
-        {
-            m_clrFullName += prefix;
-            m_clrFullName += param->clr_full_name();
-
-            m_mangledName.push_back('_');
-            m_mangledName += param->generic_param_mangled_name();
-
-            prefix = ", ";
-        }
-
-        m_clrFullName.push_back('>');
     }
 
     virtual std::string_view clr_abi_namespace() const override
@@ -833,42 +876,67 @@ struct generic_inst final : metadata_type
 
     virtual std::string_view clr_full_name() const override
     {
-        return m_clrFullName;
+        return m_clrFullName.get([&](std::string& result)
+        {
+            result = m_genericType->clr_full_name();
+            result.push_back('<');
+
+            std::string_view prefix;
+            for (auto param : m_genericParams)
+            {
+                result += prefix;
+                result += param->clr_full_name();
+                prefix = ", ";
+            }
+
+            result.push_back('>');
+        });
     }
 
     virtual std::string_view cpp_abi_name() const override
     {
-        return m_mangledName;
+        return mangled_name();
     }
 
     virtual std::string_view cpp_logical_name() const override
     {
-        return m_mangledName;
+        return mangled_name();
     }
 
     virtual std::string_view mangled_name() const override
     {
-        return m_mangledName;
+        return m_mangledName.get([&](std::string& result)
+        {
+            result = m_genericType->mangled_name();
+            for (auto param : m_genericParams)
+            {
+                result.push_back('_');
+                result += param->generic_param_mangled_name();
+            }
+        });
     }
 
     virtual std::string_view generic_param_mangled_name() const override
     {
-        return m_mangledName;
+        return mangled_name();
     }
 
-    virtual void append_signature(sha1& hash) const override
+    virtual void append_signature(std::string& result) const override
     {
         using namespace std::literals;
-        hash.append("pinterface({"sv);
-        auto iid = type_iid(m_genericType->type());
-        hash.append(std::string_view{ iid.data(), iid.size() - 1 });
-        hash.append("}"sv);
+        // The cached signature of the generic type is either "{iid}" or "delegate({iid})", so reuse the IID from it
+        // rather than parsing the GuidAttribute again for every instantiation
+        auto genericSignature = m_genericType->signature();
+        auto iidPos = genericSignature.find('{');
+        XLANG_ASSERT(iidPos != std::string_view::npos);
+        result += "pinterface("sv;
+        result += genericSignature.substr(iidPos, genericSignature.find('}', iidPos) + 1 - iidPos);
         for (auto param : m_genericParams)
         {
-            hash.append(";"sv);
-            param->append_signature(hash);
+            result += ";"sv;
+            result += param->signature();
         }
-        hash.append(")"sv);
+        result += ")"sv;
     }
 
     virtual std::size_t push_contract_guards(writer& w) const override;
@@ -882,6 +950,9 @@ struct generic_inst final : metadata_type
     virtual void write_c_forward_declaration(writer& w) const override;
     virtual void write_c_abi_param(writer& w) const override;
 
+    void write_cpp_definition(writer& w) const;
+    void write_c_definition(writer& w) const;
+
     virtual bool is_experimental() const override
     {
         // Generic instances are experimental only if their arguments are experimental
@@ -925,13 +996,23 @@ struct generic_inst final : metadata_type
         return m_genericParams;
     }
 
+    // When generics are shared between headers, each instantiation gets written to a header named after the namespaces
+    // of the types that it is made up of. Any namespace that uses the instantiation depends on all of those already
+    std::string_view shared_header_name() const;
+
     std::vector<generic_inst const*> dependencies;
     std::vector<function_def> functions;
 
+    // Namespaces and types referenced by the functions and required interfaces of this instantiation. These get merged
+    // into each namespace that uses the instantiation
+    std::set<std::string_view> dependent_namespaces;
+    std::set<std::reference_wrapper<typedef_base const>> type_dependencies;
+
 private:
 
     typedef_base const* m_genericType;
     std::vector<metadata_type const*> m_genericParams;
-    std::string m_clrFullName;
-    std::string m_mangledName;
+    lazy_string m_clrFullName;
+    lazy_string m_mangledName;
+    lazy_string m_sharedHeaderName;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "common.h"
 
 // Roughly corresponds to Windows.Foundation.Metadata.Platform enum
@@ -137,67 +139,113 @@ struct contract_history
     std::vector<previous_contract> previous_contracts;
 };
 
-template <typename T>
-inline std::optional<contract_history> get_contract_history(T const& value)
+// The versioning attributes of a type or one of its members. These are decoded once, when the metadata cache is built,
+// and then shared by both the dependency processing and the writing of the headers
+struct versioning_info
 {
-    using namespace std::literals;
-    using namespace xlang::meta::reader;
+    std::optional<contract_history> history;
+    std::vector<platform_version> platform_versions;
+
+    // Few types and members are deprecated, so keep the deprecation out of line rather than paying for it in every record
+    std::unique_ptr<deprecation_info const> deprecation;
 
-    auto contractAttr = get_attribute(value, metadata_namespace, "ContractVersionAttribute"sv);
-    if (!contractAttr)
+    bool has_version() const noexcept
     {
-        return std::nullopt;
+        return history || !platform_versions.empty();
     }
+};
 
-    contract_history result;
-    result.current_contract = decode_contract_version(contractAttr);
+template <typename T>
+inline std::optional<versioning_info> decode_versioning(T const& value)
+{
+    using namespace std::literals;
+    using namespace xlang::meta::reader;
 
-    for_each_attribute(value, metadata_namespace, "PreviousContractVersionAttribute"sv,
-        [&](bool /*first*/, auto const& attr)
+    // Only the first contract version and deprecation attributes count, which is also what 'get_attribute' would find.
+    // Previous contracts only mean something when there's a current contract, so hold on to them until the end
+    versioning_info result;
+    bool foundDeprecation = false;
+    std::vector<previous_contract> previousContracts;
+    for (auto const& attr : value.CustomAttribute())
     {
-        auto prevSig = attr.Value();
-        auto const& prevArgs = prevSig.FixedArgs();
+        auto [ns, name] = attr.TypeNamespaceAndName();
+        if (ns != metadata_namespace)
+        {
+            continue;
+        }
 
-        // The PreviousContractVersionAttribute has two constructors, both of which start with the same three
-        // arguments - the only ones that we care about
-        previous_contract prev =
+        if (name == "ContractVersionAttribute"sv)
         {
-            std::get<std::string_view>(std::get<ElemSig>(prevArgs[0].value).value),
-            decode_integer<std::uint32_t>(std::get<ElemSig>(prevArgs[1].value).value),
-            decode_integer<std::uint32_t>(std::get<ElemSig>(prevArgs[2].value).value),
-        };
-        if (prevArgs.size() == 4)
+            if (!result.history)
+            {
+                result.history.emplace().current_contract = decode_contract_version(attr);
+            }
+        }
+        else if (name == "PreviousContractVersionAttribute"sv)
         {
-            // This contract "came before" a later contract. If we've already added that contract to the list, we
-            // need to insert this one before it
-            auto toName = std::get<std::string_view>(std::get<ElemSig>(prevArgs[3].value).value);
-            auto itr = std::find_if(result.previous_contracts.begin(), result.previous_contracts.end(),
-                [&](auto const& prevContract)
+            auto prevSig = attr.Value();
+            auto const& prevArgs = prevSig.FixedArgs();
+
+            // The PreviousContractVersionAttribute has two constructors, both of which start with the same three
+            // arguments - the only ones that we care about
+            previous_contract prev =
             {
-                return prevContract.type_name == toName;
-            });
-            result.previous_contracts.insert(itr, prev);
+                std::get<std::string_view>(std::get<ElemSig>(prevArgs[0].value).value),
+                decode_integer<std::uint32_t>(std::get<ElemSig>(prevArgs[1].value).value),
+                decode_integer<std::uint32_t>(std::get<ElemSig>(prevArgs[2].value).value),
+            };
+            if (prevArgs.size() == 4)
+            {
+                // This contract "came before" a later contract. If we've already added that contract to the list, we
+                // need to insert this one before it
+                auto toName = std::get<std::string_view>(std::get<ElemSig>(prevArgs[3].value).value);
+                auto itr = std::find_if(previousContracts.begin(), previousContracts.end(), [&](auto const& prevContract)
+                {
+                    return prevContract.type_name == toName;
+                });
+                previousContracts.insert(itr, prev);
+            }
+            else
+            {
+                // This is the last contract that the type was in before moving to its current contract. Always insert
+                // it at the tail
+                previousContracts.push_back(prev);
+            }
         }
-        else
+        else if (name == "VersionAttribute"sv)
         {
-            // This is the last contract that the type was in before moving to its current contract. Always insert
-            // it at the tail
-            result.previous_contracts.push_back(prev);
+            result.platform_versions.push_back(decode_platform_version(attr));
+        }
+        else if (name == "DeprecatedAttribute"sv)
+        {
+            if (!foundDeprecation)
+            {
+                foundDeprecation = true;
+                if (auto info = decode_deprecation(attr))
+                {
+                    result.deprecation = std::make_unique<deprecation_info const>(*info);
+                }
+            }
         }
-    });
+    }
+
+    if (result.history)
+    {
+        result.history->previous_contracts = std::move(previousContracts);
+    }
+    else if (result.platform_versions.empty() && !result.deprecation)
+    {
+        return std::nullopt;
+    }
 
     return result;
 }
 
-template <typename T>
-std::optional<version> match_versioning_scheme(version const& ver, T const& value)
+inline std::optional<version> match_versioning_scheme(version const& ver, versioning_info const& info)
 {
-    using namespace std::literals;
-    using namespace xlang::meta::reader;
-
     if (std::holds_alternative<contract_version>(ver))
     {
-        if (auto history = get_contract_history(value))
+        if (auto const& history = info.history)
         {
             if (history->previous_contracts.empty())
             {
@@ -214,15 +262,14 @@ std::optional<version> match_versioning_scheme(version const& ver, T const& valu
     {
         auto const& plat = std::get<platform_version>(ver);
         std::optional<version> result;
-        for_each_attribute(value, metadata_namespace, "VersionAttribute"sv, [&](bool /*first*/, auto const& attr)
+        for (auto const& possibleMatch : info.platform_versions)
         {
-            auto possibleMatch = decode_platform_version(attr);
             if (possibleMatch.platform == plat.platform)
             {
                 XLANG_ASSERT(!result);
                 result = possibleMatch;
             }
-        });
+        }
 
         return result;
     }
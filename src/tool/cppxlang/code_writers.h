@@ -2683,6 +2683,166 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
             type);
     }
 
+    // Reflection metadata can make up more than half of a namespace header that is mostly structs and
+    // properties, so define XLANG_NO_REFLECTION to skip it where it isn't used.
+    static void write_reflect_namespace(writer& w)
+    {
+        w.write(R"(#ifndef XLANG_NO_REFLECTION
+namespace xlang::experimental::reflect
+{
+)");
+    }
+
+    static void write_close_reflect_namespace(writer& w)
+    {
+        w.write(R"(}
+#endif
+)");
+    }
+
+    static void write_enum_reflection(writer& w, TypeDef const& type)
+    {
+        auto format = R"(    template <> struct get_enumerator_names<xlang::%>
+    {
+        static constexpr std::array<std::string_view, %> value{ % };
+    };
+    template <> struct get_enumerator_values<xlang::%>
+    {
+        static constexpr std::array<xlang::%, %> value{ % };
+    };
+)";
+
+        std::vector<std::string> names;
+        std::vector<std::string> values;
+
+        for (auto&& field : type.FieldList())
+        {
+            if (field.Constant())
+            {
+                names.push_back(w.write_temp("u8\"%\"", field.Name()));
+                values.push_back(w.write_temp("xlang::%::%", type, field.Name()));
+            }
+        }
+
+        w.write(format,
+            type,
+            static_cast<uint32_t>(names.size()),
+            bind_list(", ", names),
+            type,
+            type,
+            static_cast<uint32_t>(values.size()),
+            bind_list(", ", values));
+    }
+
+    static void write_named_property(writer& w, property_info const& property, std::string_view const& target, bool is_field)
+    {
+        auto format = R"(        struct %
+        {
+            struct name { static constexpr std::string_view value{ u8"%" }; };
+            using property_type = %;
+            using target_type = %;
+            using is_readable = std::%_type;
+            using is_writable = std::%_type;
+            using is_static = std::%_type;
+%%        };
+)";
+
+        std::string getter;
+        std::string setter;
+
+        if (is_field)
+        {
+            getter = w.write_temp("            struct getter { property_type const& operator()(target_type const& target) const noexcept { return target.%; } };\n", property.name);
+            setter = w.write_temp("            struct setter { void operator()(target_type& target, property_type const& value) const { target.% = value; } };\n", property.name);
+        }
+        else if (property.is_static)
+        {
+            getter = w.write_temp("            struct getter { property_type operator()() const { return target_type::%(); } };\n", property.name);
+            setter = w.write_temp("            struct setter { void operator()(property_type const& value) const { target_type::%(value); } };\n", property.name);
+        }
+        else
+        {
+            getter = w.write_temp("            struct getter { property_type operator()(target_type const& target) const { return target.%(); } };\n", property.name);
+            setter = w.write_temp("            struct setter { void operator()(target_type const& target, property_type const& value) const { target.%(value); } };\n", property.name);
+        }
+
+        w.write(format,
+            property.name,
+            property.name,
+            property.type,
+            target,
+            property.readable ? "true" : "false",
+            property.writable ? "true" : "false",
+            property.is_static ? "true" : "false",
+            property.readable ? getter : "",
+            property.writable ? setter : "");
+    }
+
+    static void write_properties_reflection(writer& w, TypeDef const& type, std::vector<property_info> const& properties, bool is_field)
+    {
+        if (properties.empty())
+        {
+            return;
+        }
+
+        auto format = R"(    template <> struct named_property<xlang::%>
+    {
+%    };
+    template <> struct properties<xlang::%>
+    {
+        using type = impl::typelist<%>;
+    };
+)";
+
+        std::vector<std::string> names;
+
+        for (auto&& property : properties)
+        {
+            names.push_back(w.write_temp("named_property<xlang::%>::%", type, property.name));
+        }
+
+        auto target = w.write_temp("xlang::%", type);
+
+        w.write(format,
+            type,
+            bind_each<write_named_property>(properties, target, is_field),
+            type,
+            bind_list(", ", names));
+    }
+
+    static void write_struct_reflection(writer& w, TypeDef const& type)
+    {
+        std::vector<property_info> fields;
+
+        for (auto&& field : type.FieldList())
+        {
+            property_info info;
+            info.name = field.Name();
+            info.type = w.write_temp("%", field.Signature().Type());
+            info.readable = true;
+            info.writable = true;
+            fields.push_back(std::move(info));
+        }
+
+        write_properties_reflection(w, type, fields, true);
+    }
+
+    static void write_class_reflection(writer& w, TypeDef const& type)
+    {
+        if (auto base = get_base_class(type))
+        {
+            auto format = R"(    template <> struct base_type<xlang::%>
+    {
+        using type = xlang::%;
+    };
+)";
+
+            w.write(format, type, base);
+        }
+
+        write_properties_reflection(w, type, get_properties(w, type), false);
+    }
+
     static void write_namespace_special(writer& w, std::string_view const& namespace_name, cache const& /*c*/)
     {
         if (namespace_name == "Foundation.Collections")
@@ -24,13 +24,16 @@ namespace xlang
         w.write(strings::base_array);
         w.write(strings::base_weak_ref);
         w.write(strings::base_error);
+        w.write(strings::base_pool);
         w.write(strings::base_delegate);
         w.write(strings::base_events);
         w.write(strings::base_activation);
         w.write(strings::base_implements);
+        w.write(strings::base_async);
         w.write(strings::base_composable);
         w.write(strings::base_chrono);
         w.write(strings::base_std_hash);
+        w.write(strings::base_collections_flat_map);
         w.write(strings::base_reflect);
         w.write(strings::base_natvis);
         w.write(strings::base_version, XLANG_VERSION_STRING);
@@ -182,6 +185,11 @@ namespace xlang
         w.write_each<write_std_hash>(members.interfaces);
         w.write_each<write_std_hash>(members.classes);
         write_close_namespace(w);
+        write_reflect_namespace(w);
+        w.write_each<write_enum_reflection>(members.enums);
+        w.write_each<write_struct_reflection>(members.structs);
+        w.write_each<write_class_reflection>(members.classes);
+        write_close_reflect_namespace(w);
 
         write_close_file_guard(w);
         w.swap();
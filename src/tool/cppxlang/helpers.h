@@ -393,6 +393,84 @@ namespace xlang
         return result;
     }
 
+    struct property_info
+    {
+        std::string_view name;
+        std::string type;
+        bool readable{};
+        bool writable{};
+        bool is_static{};
+    };
+
+    static void get_properties_impl(writer& w, std::vector<property_info>& result, TypeDef const& type, bool is_static)
+    {
+        for (auto&& method : type.MethodList())
+        {
+            bool const getter = method.SpecialName() && starts_with(method.Name(), "get_");
+            bool const setter = is_put_overload(method);
+
+            if (!getter && !setter)
+            {
+                continue;
+            }
+
+            auto name = get_name(method);
+
+            auto found = std::find_if(result.begin(), result.end(), [&](property_info const& info)
+            {
+                return info.name == name;
+            });
+
+            if (found == result.end())
+            {
+                method_signature signature{ method };
+                property_info info;
+                info.name = name;
+                info.type = getter ? w.write_temp("%", signature.return_signature()) : w.write_temp("%", signature.params()[0].second->Type());
+                info.is_static = is_static;
+                found = result.insert(result.end(), std::move(info));
+            }
+            else if (found->is_static != is_static)
+            {
+                // An instance and a static property with the same name can't both be reflected.
+                continue;
+            }
+
+            found->readable = found->readable || getter;
+            found->writable = found->writable || setter;
+        }
+    }
+
+    // Properties that may be called through a class's projection. Properties with the same name on
+    // more than one interface are only reflected once.
+    static auto get_properties(writer& w, TypeDef const& type)
+    {
+        std::vector<property_info> result;
+        w.async_types = false;
+
+        for (auto&& [interface_name, info] : get_interfaces(w, type))
+        {
+            if (info.overridable)
+            {
+                continue;
+            }
+
+            w.generic_param_stack.insert(w.generic_param_stack.end(), info.generic_param_stack.begin(), info.generic_param_stack.end());
+            get_properties_impl(w, result, info.type, false);
+            w.generic_param_stack.resize(w.generic_param_stack.size() - info.generic_param_stack.size());
+        }
+
+        for (auto&& [factory_name, factory] : get_factories(w, type))
+        {
+            if (factory.statics)
+            {
+                get_properties_impl(w, result, factory.type, true);
+            }
+        }
+
+        return result;
+    }
+
     static bool wrap_abi(TypeSig const& signature)
     {
         bool wrap{};
@@ -1,22 +1,20 @@
-
 namespace xlang::impl
 {
     template <typename Async>
     void blocking_suspend(Async const& async)
     {
-        std::mutex m;
-        std::condition_variable cv;
-        bool completed = false;
-        async.Completed([&](auto && ...)
+        std::atomic<uint32_t> completed{ 0 };
+        async.Completed([completed = &completed](auto && ...)
             {
-                {
-                    std::lock_guard const guard(m);
-                    completed = true;
-                }
-                cv.notify_one();
+                completed->store(1, std::memory_order_release);
+
+                // The waiter may already have returned, but waking only uses the address as a key.
+                xlang_wake_by_address_all(completed);
             });
 
-        std::unique_lock guard(m);
-        cv.wait(m, [&] { return completed; });
+        while (completed.load(std::memory_order_acquire) == 0)
+        {
+            xlang_wait_on_address(&completed, 0);
+        }
     }
 }
@@ -121,6 +121,14 @@ namespace xlang::impl
     template <typename K, typename V>
     struct is_key_value_pair<fc::IKeyValuePair<K, V>> : std::true_type {};
 
+    // Containers that expose their storage through data() keep their elements contiguous, as std::vector,
+    // std::array, and array_view do.
+    template <typename Container, typename = std::void_t<>>
+    struct is_contiguous_container : std::false_type {};
+
+    template <typename Container>
+    struct is_contiguous_container<Container, std::void_t<decltype(std::declval<Container&>().data())>> : std::true_type {};
+
     struct input_scope
     {
         void invalidate_scope() noexcept
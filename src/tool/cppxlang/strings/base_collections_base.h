@@ -23,10 +23,29 @@ namespace xlang
 
     protected:
 
+        static constexpr bool is_unwrapped_storage() noexcept
+        {
+            return std::is_same_v<T, std::decay_t<decltype(*std::declval<D const&>().get_container().begin())>>;
+        }
+
+        // Elements are stored as T, with no wrapping, in contiguous memory.
+        static constexpr bool is_contiguous_storage() noexcept
+        {
+            using container_type = std::remove_reference_t<decltype(std::declval<D const&>().get_container())>;
+            return is_unwrapped_storage() && impl::is_contiguous_container<container_type>::value;
+        }
+
         template<typename InputIt, typename Size, typename OutputIt>
         auto copy_n(InputIt first, Size count, OutputIt result) const
         {
-            if constexpr (std::is_same_v<T, decltype(*std::declval<D const>().get_container().begin())> && !impl::is_key_value_pair<T>::value)
+            if constexpr (is_contiguous_storage() && std::is_trivially_copyable_v<T>)
+            {
+                if (count != 0)
+                {
+                    std::memcpy(std::addressof(*result), std::addressof(*first), count * sizeof(T));
+                }
+            }
+            else if constexpr (is_unwrapped_storage() && !impl::is_key_value_pair<T>::value)
             {
                 std::copy_n(first, count, result);
             }
@@ -157,6 +176,15 @@ namespace xlang
             this->copy_n(static_cast<D const&>(*this).get_container().begin() + startIndex, actual, values.begin());
             return actual;
         }
+
+        // Provides direct access to the elements, without copying them, to callers in the same process that
+        // hold the implementation. The view is invalidated by any change to the collection.
+        array_view<T const> get_array_view() const noexcept
+        {
+            static_assert(iterable_base<D, T, Version>::is_contiguous_storage(), "The container must store T contiguously.");
+            auto& container = static_cast<D const&>(*this).get_container();
+            return { container.data(), container.data() + container.size() };
+        }
     };
 
     template <typename D, typename T>
@@ -229,6 +257,16 @@ namespace xlang
             assign(value.begin(), value.end());
         }
 
+        // Replaces the elements by taking over the storage of a container of the implementation's own type,
+        // rather than copying its elements. This is an extension for callers in the same process.
+        template <typename Container, typename Derived = D, std::enable_if_t<!std::is_lvalue_reference_v<Container> &&
+            std::is_same_v<Container, std::remove_reference_t<decltype(std::declval<Derived&>().get_container())>>, int> = 0>
+        void ReplaceAll(Container&& values)
+        {
+            this->increment_version();
+            static_cast<D&>(*this).get_container() = std::move(values);
+        }
+
     private:
 
         template <typename InputIt>
@@ -0,0 +1,439 @@
+
+namespace xlang
+{
+    // A map that keeps its elements sorted by key in one contiguous allocation. Lookups are binary searches,
+    // which suits maps that are built once and read often, while inserting or erasing an element moves the
+    // elements that follow it. The elements are pairs whose keys must not be modified in place.
+    template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K, V>>>
+    struct flat_map
+    {
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using container_type = std::vector<value_type, Allocator>;
+        using size_type = size_t;
+        using iterator = typename container_type::iterator;
+        using const_iterator = typename container_type::const_iterator;
+
+        flat_map() = default;
+
+        // Where the values hold more than one element with the same key, the first of them is kept.
+        explicit flat_map(container_type&& values, Compare const& compare = Compare{}) :
+            m_values(std::move(values)),
+            m_compare(compare)
+        {
+            std::stable_sort(m_values.begin(), m_values.end(), [&](value_type const& left, value_type const& right)
+            {
+                return m_compare(left.first, right.first);
+            });
+
+            m_values.erase(std::unique(m_values.begin(), m_values.end(), [&](value_type const& left, value_type const& right)
+            {
+                return !m_compare(left.first, right.first);
+            }), m_values.end());
+        }
+
+        template <typename InputIt>
+        flat_map(InputIt first, InputIt last, Compare const& compare = Compare{}) :
+            flat_map(container_type(first, last), compare)
+        {
+        }
+
+        flat_map(std::initializer_list<value_type> values, Compare const& compare = Compare{}) :
+            flat_map(container_type(values), compare)
+        {
+        }
+
+        iterator begin() noexcept
+        {
+            return m_values.begin();
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return m_values.begin();
+        }
+
+        iterator end() noexcept
+        {
+            return m_values.end();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return m_values.end();
+        }
+
+        size_type size() const noexcept
+        {
+            return m_values.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_values.empty();
+        }
+
+        void reserve(size_type count)
+        {
+            m_values.reserve(count);
+        }
+
+        void clear() noexcept
+        {
+            m_values.clear();
+        }
+
+        iterator find(K const& key)
+        {
+            auto position = lower_bound(key);
+            return position != m_values.end() && !m_compare(key, position->first) ? position : m_values.end();
+        }
+
+        const_iterator find(K const& key) const
+        {
+            auto position = lower_bound(key);
+            return position != m_values.end() && !m_compare(key, position->first) ? position : m_values.end();
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(K const& key, M&& value)
+        {
+            auto position = lower_bound(key);
+
+            if (position != m_values.end() && !m_compare(key, position->first))
+            {
+                position->second = std::forward<M>(value);
+                return { position, false };
+            }
+
+            return { m_values.emplace(position, key, std::forward<M>(value)), true };
+        }
+
+        size_type erase(K const& key)
+        {
+            auto position = find(key);
+
+            if (position == m_values.end())
+            {
+                return 0;
+            }
+
+            m_values.erase(position);
+            return 1;
+        }
+
+    private:
+
+        iterator lower_bound(K const& key)
+        {
+            return std::lower_bound(m_values.begin(), m_values.end(), key, [&](value_type const& value, K const& match)
+            {
+                return m_compare(value.first, match);
+            });
+        }
+
+        const_iterator lower_bound(K const& key) const
+        {
+            return std::lower_bound(m_values.begin(), m_values.end(), key, [&](value_type const& value, K const& match)
+            {
+                return m_compare(value.first, match);
+            });
+        }
+
+        container_type m_values;
+        Compare m_compare;
+    };
+
+    // A hash map with open addressing. The elements are stored densely in one allocation, in no particular
+    // order, and a separate table of slots maps hashes to elements by linear probing. Each slot records part
+    // of the element's hash, so that a probe rarely compares keys that do not match. Erasing an element moves
+    // the last element into its place and shifts back the slots that follow it, so no tombstones are left.
+    // The elements are pairs whose keys must not be modified in place.
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Allocator = std::allocator<std::pair<K, V>>>
+    struct flat_hash_map
+    {
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using container_type = std::vector<value_type, Allocator>;
+        using size_type = size_t;
+        using iterator = typename container_type::iterator;
+        using const_iterator = typename container_type::const_iterator;
+
+        flat_hash_map() = default;
+
+        // Where the range holds more than one element with the same key, the first of them is kept.
+        template <typename InputIt>
+        flat_hash_map(InputIt first, InputIt last, Hash const& hash = Hash{}, KeyEqual const& equal = KeyEqual{}) :
+            m_hash(hash),
+            m_equal(equal)
+        {
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            {
+                reserve(static_cast<size_type>(std::distance(first, last)));
+            }
+
+            for (; first != last; ++first)
+            {
+                emplace_unique(first->first, first->second);
+            }
+        }
+
+        flat_hash_map(std::initializer_list<value_type> values, Hash const& hash = Hash{}, KeyEqual const& equal = KeyEqual{}) :
+            flat_hash_map(values.begin(), values.end(), hash, equal)
+        {
+        }
+
+        iterator begin() noexcept
+        {
+            return m_values.begin();
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return m_values.begin();
+        }
+
+        iterator end() noexcept
+        {
+            return m_values.end();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return m_values.end();
+        }
+
+        size_type size() const noexcept
+        {
+            return m_values.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_values.empty();
+        }
+
+        void reserve(size_type count)
+        {
+            m_values.reserve(count);
+            m_hashes.reserve(count);
+
+            if (count > capacity_for(slot_count()))
+            {
+                rehash(count);
+            }
+        }
+
+        void clear() noexcept
+        {
+            m_values.clear();
+            m_hashes.clear();
+            std::fill(m_slots.begin(), m_slots.end(), slot{});
+        }
+
+        iterator find(K const& key)
+        {
+            size_t const position = find_slot(key, hash_key(key));
+            return position == npos ? m_values.end() : m_values.begin() + (m_slots[position].index - 1);
+        }
+
+        const_iterator find(K const& key) const
+        {
+            size_t const position = find_slot(key, hash_key(key));
+            return position == npos ? m_values.end() : m_values.begin() + (m_slots[position].index - 1);
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(K const& key, M&& value)
+        {
+            uint32_t const hash = hash_key(key);
+            size_t const position = find_slot(key, hash);
+
+            if (position != npos)
+            {
+                auto existing = m_values.begin() + (m_slots[position].index - 1);
+                existing->second = std::forward<M>(value);
+                return { existing, false };
+            }
+
+            return { insert_new(key, std::forward<M>(value), hash), true };
+        }
+
+        size_type erase(K const& key)
+        {
+            size_t const position = find_slot(key, hash_key(key));
+
+            if (position == npos)
+            {
+                return 0;
+            }
+
+            size_t const index = m_slots[position].index - 1;
+            remove_slot(position);
+
+            size_t const last = m_values.size() - 1;
+
+            if (index != last)
+            {
+                // Move the last element into the hole and point its slot at the new position.
+                size_t moved = home(m_hashes[last]);
+
+                while (m_slots[moved].index != last + 1)
+                {
+                    moved = (moved + 1) & mask();
+                }
+
+                m_slots[moved].index = static_cast<uint32_t>(index + 1);
+                m_values[index] = std::move(m_values[last]);
+                m_hashes[index] = m_hashes[last];
+            }
+
+            m_values.pop_back();
+            m_hashes.pop_back();
+            return 1;
+        }
+
+    private:
+
+        struct slot
+        {
+            // One more than the index of the element, or zero if the slot is empty.
+            uint32_t index;
+            uint32_t hash;
+        };
+
+        static constexpr size_t npos = ~size_t{};
+        static constexpr uint32_t min_slot_bits = 3;
+
+        // Slots are kept at most three quarters full.
+        static constexpr size_type capacity_for(size_type slots) noexcept
+        {
+            return slots - slots / 4;
+        }
+
+        uint32_t hash_key(K const& key) const noexcept
+        {
+            // Fibonacci hashing spreads weak hashes, such as the identity hash of integers, over the high bits.
+            return static_cast<uint32_t>((static_cast<uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15) >> 32);
+        }
+
+        size_t slot_count() const noexcept
+        {
+            return m_slots.size();
+        }
+
+        size_t mask() const noexcept
+        {
+            return m_slots.size() - 1;
+        }
+
+        size_t home(uint32_t hash) const noexcept
+        {
+            return hash >> m_shift;
+        }
+
+        size_t find_slot(K const& key, uint32_t hash) const
+        {
+            if (m_slots.empty())
+            {
+                return npos;
+            }
+
+            for (size_t position = home(hash);; position = (position + 1) & mask())
+            {
+                slot const& current = m_slots[position];
+
+                if (current.index == 0)
+                {
+                    return npos;
+                }
+
+                if (current.hash == hash && m_equal(m_values[current.index - 1].first, key))
+                {
+                    return position;
+                }
+            }
+        }
+
+        template <typename M>
+        iterator insert_new(K const& key, M&& value, uint32_t hash)
+        {
+            if (m_values.size() + 1 > capacity_for(slot_count()))
+            {
+                rehash(m_values.size() + 1);
+            }
+
+            m_values.emplace_back(key, std::forward<M>(value));
+            m_hashes.push_back(hash);
+            place(static_cast<uint32_t>(m_values.size()), hash);
+            return m_values.end() - 1;
+        }
+
+        template <typename M>
+        void emplace_unique(K const& key, M&& value)
+        {
+            uint32_t const hash = hash_key(key);
+
+            if (find_slot(key, hash) == npos)
+            {
+                insert_new(key, std::forward<M>(value), hash);
+            }
+        }
+
+        void place(uint32_t index, uint32_t hash) noexcept
+        {
+            size_t position = home(hash);
+
+            while (m_slots[position].index != 0)
+            {
+                position = (position + 1) & mask();
+            }
+
+            m_slots[position] = { index, hash };
+        }
+
+        void remove_slot(size_t hole) noexcept
+        {
+            // Shift back each following slot whose home does not lie between the hole and the slot itself.
+            for (size_t next = (hole + 1) & mask(); m_slots[next].index != 0; next = (next + 1) & mask())
+            {
+                size_t const distance_from_home = (next - home(m_slots[next].hash)) & mask();
+
+                if (distance_from_home >= ((next - hole) & mask()))
+                {
+                    m_slots[hole] = m_slots[next];
+                    hole = next;
+                }
+            }
+
+            m_slots[hole] = {};
+        }
+
+        void rehash(size_type count)
+        {
+            uint32_t bits = min_slot_bits;
+
+            while (capacity_for(size_t{ 1 } << bits) < count)
+            {
+                ++bits;
+            }
+
+            m_slots.assign(size_t{ 1 } << bits, slot{});
+            m_shift = 32 - bits;
+
+            for (size_t index = 0; index < m_values.size(); ++index)
+            {
+                place(static_cast<uint32_t>(index + 1), m_hashes[index]);
+            }
+        }
+
+        container_type m_values;
+        std::vector<uint32_t, typename std::allocator_traits<Allocator>::template rebind_alloc<uint32_t>> m_hashes;
+        std::vector<slot, typename std::allocator_traits<Allocator>::template rebind_alloc<slot>> m_slots;
+        uint32_t m_shift{ 32 };
+        Hash m_hash;
+        KeyEqual m_equal;
+    };
+}
@@ -72,6 +72,18 @@ namespace xlang::param
         {
         }
 
+        template <typename Compare, typename Allocator>
+        map(flat_map<K, V, Compare, Allocator>&& values) :
+            m_interface(impl::make_input_map<K, V>(std::move(values)))
+        {
+        }
+
+        template <typename Hash, typename KeyEqual, typename Allocator>
+        map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values) :
+            m_interface(impl::make_input_map<K, V>(std::move(values)))
+        {
+        }
+
         map(std::initializer_list<std::pair<K const, V>> values) :
             m_interface(impl::make_input_map<K, V>(std::map<K, V>(values)))
         {
@@ -18,4 +18,69 @@ namespace xlang
     {
         return make<impl::input_map<K, V, std::unordered_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
     }
+
+    template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K, V>>>
+    Foundation::Collections::IMap<K, V> single_threaded_map(flat_map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::input_map<K, V, flat_map<K, V, Compare, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Allocator = std::allocator<std::pair<K, V>>>
+    Foundation::Collections::IMap<K, V> single_threaded_map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::input_map<K, V, flat_hash_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
+}
+
+namespace xlang::impl
+{
+    template <typename K, typename V, typename Container>
+    struct immutable_map_view :
+        implements<immutable_map_view<K, V, Container>, fc::IMapView<K, V>, fc::IIterable<fc::IKeyValuePair<K, V>>>,
+        map_view_base<immutable_map_view<K, V, Container>, K, V>
+    {
+        static_assert(std::is_same_v<Container, std::remove_reference_t<Container>>, "Must be constructed with rvalue.");
+
+        explicit immutable_map_view(Container&& values) : m_values(std::forward<Container>(values))
+        {
+        }
+
+        auto& get_container() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        Container const m_values;
+    };
+}
+
+namespace xlang
+{
+    // Builds a map view that never changes, backed by a flat hash map sized to the range. Since nothing can
+    // modify it, the view may be read from any number of threads at once.
+    template <typename K, typename V, typename InputIt>
+    Foundation::Collections::IMapView<K, V> immutable_map_view(InputIt first, InputIt last)
+    {
+        return make<impl::immutable_map_view<K, V, flat_hash_map<K, V>>>(flat_hash_map<K, V>(first, last));
+    }
+
+    template <typename K, typename V>
+    Foundation::Collections::IMapView<K, V> immutable_map_view(std::initializer_list<std::pair<K, V>> values)
+    {
+        return immutable_map_view<K, V>(values.begin(), values.end());
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+    Foundation::Collections::IMapView<K, V> immutable_map_view(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::immutable_map_view<K, V, flat_hash_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Compare, typename Allocator>
+    Foundation::Collections::IMapView<K, V> immutable_map_view(flat_map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::immutable_map_view<K, V, flat_map<K, V, Compare, Allocator>>>(std::move(values));
+    }
 }
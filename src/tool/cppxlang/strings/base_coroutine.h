@@ -1,5 +1,4 @@
 
-#ifdef _WIN32
 namespace xlang::impl
 {
     template <typename Async>
@@ -14,6 +13,7 @@ namespace xlang::impl
 
         void await_suspend(std::experimental::coroutine_handle<> handle) const
         {
+#ifdef _WIN32
             auto context = capture<IContextCallback>(XLANG_CoGetObjectContext);
 
             async.Completed([handle, context = std::move(context)](auto const&, Foundation::AsyncStatus)
@@ -29,6 +29,13 @@ namespace xlang::impl
 
                 check_hresult(context->ContextCallback(callback, &args, guid_of<impl::ICallbackWithNoReentrancyToApplicationSTA>(), 5, nullptr));
             });
+#else
+            // There is no apartment to return to, so resume on whichever thread completes the operation.
+            async.Completed([handle](auto const&, Foundation::AsyncStatus)
+            {
+                handle();
+            });
+#endif
         }
 
         auto await_resume() const
@@ -153,11 +160,45 @@ namespace xlang::impl
         Promise* m_promise;
     };
 
+    // Coroutine frames for async operations are recycled through an object pool. Define
+    // XLANG_NO_COROUTINE_FRAME_POOL to allocate every frame with the global operator new.
+    struct coroutine_frame_pool_traits
+    {
+        static constexpr uint32_t max_cached = 32;
+    };
+
+    using coroutine_frame_pool = object_pool<coroutine_frame_pool_traits>;
+}
+
+namespace xlang
+{
+    using coroutine_frame_statistics = object_pool_statistics;
+
+    inline coroutine_frame_statistics get_coroutine_frame_statistics() noexcept
+    {
+        return impl::coroutine_frame_pool::statistics();
+    }
+}
+
+namespace xlang::impl
+{
     template <typename Derived, typename AsyncInterface, typename CompletedHandler, typename TProgress = void>
     struct promise_base : implements<Derived, AsyncInterface>
     {
         using AsyncStatus = Foundation::AsyncStatus;
 
+#ifndef XLANG_NO_COROUTINE_FRAME_POOL
+        static void* operator new(size_t size)
+        {
+            return coroutine_frame_pool::allocate(size);
+        }
+
+        static void operator delete(void* pointer, size_t size) noexcept
+        {
+            coroutine_frame_pool::deallocate(pointer, size);
+        }
+#endif
+
         unsigned long XLANG_CALL Release() noexcept
         {
             uint32_t const remaining = this->subtract_reference();
@@ -173,37 +214,50 @@ namespace xlang::impl
 
         void Completed(CompletedHandler const& handler)
         {
-            AsyncStatus status;
+            uint32_t const flags = m_flags.fetch_or(completed_assigned, std::memory_order_acquire);
 
+            if (flags & completed_assigned)
             {
-                std::lock_guard const guard(m_lock);
-
-                if (m_completed_assigned)
-                {
-                    throw hresult_illegal_delegate_assignment();
-                }
-
-                m_completed_assigned = true;
+                throw hresult_illegal_delegate_assignment();
+            }
 
-                if (m_status == AsyncStatus::Started)
+            if (flags & finished)
+            {
+                if (handler)
                 {
-                    m_completed = handler;
-                    return;
+                    handler(*this, Status());
                 }
 
-                status = m_status;
+                return;
             }
 
-            if (handler)
+            m_completed = handler;
+
+            if (m_flags.fetch_or(completed_published, std::memory_order_acq_rel) & finished)
             {
-                handler(*this, status);
+                invoke_completed();
             }
         }
 
         CompletedHandler Completed() noexcept
         {
-            std::lock_guard const guard(m_lock);
-            return m_completed;
+            uint32_t flags = m_flags.load(std::memory_order_relaxed);
+
+            while ((flags & (completed_published | finished)) == completed_published)
+            {
+                if (flags & completed_reading)
+                {
+                    flags = m_flags.load(std::memory_order_relaxed);
+                }
+                else if (m_flags.compare_exchange_weak(flags, flags | completed_reading, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    CompletedHandler handler = m_completed;
+                    m_flags.fetch_and(~completed_reading, std::memory_order_release);
+                    return handler;
+                }
+            }
+
+            return{};
         }
 
         uint32_t Id() const noexcept
@@ -211,18 +265,16 @@ namespace xlang::impl
             return 1;
         }
 
-        AsyncStatus Status() noexcept
+        AsyncStatus Status() const noexcept
         {
-            std::lock_guard const guard(m_lock);
-            return m_status;
+            return m_status.load(std::memory_order_acquire);
         }
 
-        hresult ErrorCode() noexcept
+        hresult ErrorCode() const noexcept
         {
             try
             {
-                std::lock_guard const guard(m_lock);
-                rethrow_if_failed();
+                rethrow_if_failed(Status());
                 return error_ok;
             }
             catch (...)
@@ -233,21 +285,12 @@ namespace xlang::impl
 
         void Cancel() noexcept
         {
-            xlang::delegate<> cancel;
-
-            {
-                std::lock_guard const guard(m_lock);
-
-                if (m_status == AsyncStatus::Started)
-                {
-                    m_status = AsyncStatus::Canceled;
-                    m_exception = std::make_exception_ptr(hresult_canceled());
-                    cancel = std::move(m_cancel);
-                }
-            }
+            AsyncStatus expected = AsyncStatus::Started;
 
-            if (cancel)
+            if (m_status.compare_exchange_strong(expected, AsyncStatus::Canceled, std::memory_order_acq_rel, std::memory_order_relaxed) &&
+                (m_flags.fetch_or(cancel_requested, std::memory_order_acq_rel) & cancel_published))
             {
+                xlang::delegate<> const cancel = std::move(m_cancel);
                 cancel();
             }
         }
@@ -258,15 +301,15 @@ namespace xlang::impl
 
         auto GetResults()
         {
-            std::lock_guard const guard(m_lock);
+            AsyncStatus const status = Status();
 
-            if (m_status == AsyncStatus::Completed)
+            if (status == AsyncStatus::Completed)
             {
                 return static_cast<Derived*>(this)->get_return_value();
             }
 
-            rethrow_if_failed();
-            XLANG_ASSERT(m_status == AsyncStatus::Started);
+            rethrow_if_failed(status);
+            XLANG_ASSERT(status == AsyncStatus::Started);
             throw hresult_illegal_method_call();
         }
 
@@ -281,24 +324,12 @@ namespace xlang::impl
 
         void set_completed() noexcept
         {
-            CompletedHandler handler;
-            AsyncStatus status;
-
-            {
-                std::lock_guard const guard(m_lock);
-
-                if (m_status == AsyncStatus::Started)
-                {
-                    m_status = AsyncStatus::Completed;
-                }
-
-                handler = std::move(this->m_completed);
-                status = this->m_status;
-            }
+            AsyncStatus expected = AsyncStatus::Started;
+            m_status.compare_exchange_strong(expected, AsyncStatus::Completed, std::memory_order_release, std::memory_order_relaxed);
 
-            if (handler)
+            if (m_flags.fetch_or(finished, std::memory_order_acq_rel) & completed_published)
             {
-                handler(*this, status);
+                invoke_completed();
             }
         }
 
@@ -341,21 +372,21 @@ namespace xlang::impl
 
         void unhandled_exception() noexcept
         {
-            std::lock_guard const guard(m_lock);
-            XLANG_ASSERT(m_status == AsyncStatus::Started || m_status == AsyncStatus::Canceled);
-            m_exception = std::current_exception();
+            XLANG_ASSERT(Status() == AsyncStatus::Started || Status() == AsyncStatus::Canceled);
+            std::exception_ptr exception = std::current_exception();
 
             try
             {
-                std::rethrow_exception(m_exception);
+                std::rethrow_exception(exception);
             }
             catch (hresult_canceled const&)
             {
-                m_status = AsyncStatus::Canceled;
+                m_status.store(AsyncStatus::Canceled, std::memory_order_release);
             }
             catch (...)
             {
-                m_status = AsyncStatus::Error;
+                m_exception = std::move(exception);
+                m_status.store(AsyncStatus::Error, std::memory_order_release);
             }
         }
 
@@ -382,36 +413,72 @@ namespace xlang::impl
 
         void cancellation_callback(xlang::delegate<>&& cancel) noexcept
         {
-            {
-                std::lock_guard const guard(m_lock);
+            // Take back ownership of a previously registered callback, unless Cancel has already claimed it.
+            uint32_t flags = m_flags.load(std::memory_order_relaxed);
 
-                if (m_status != AsyncStatus::Canceled)
+            do
+            {
+                if (flags & cancel_requested)
                 {
-                    m_cancel = std::move(cancel);
+                    cancel();
                     return;
                 }
-            }
+            } while (!m_flags.compare_exchange_weak(flags, flags & ~cancel_published, std::memory_order_acquire, std::memory_order_relaxed));
 
-            cancel();
+            m_cancel = std::move(cancel);
+
+            if (m_flags.fetch_or(cancel_published, std::memory_order_acq_rel) & cancel_requested)
+            {
+                xlang::delegate<> const callback = std::move(m_cancel);
+                callback();
+            }
         }
 
     protected:
 
-        void rethrow_if_failed() const
+        // m_flags hands the Completed handler and the cancellation callback over between the thread
+        // that registers one and the thread that completes or cancels the operation. Each side sets
+        // its own bit and only runs the handler if the other side's bit was already set, so it runs
+        // exactly once, without a lock.
+        static constexpr uint32_t completed_assigned = 0x01;
+        static constexpr uint32_t completed_published = 0x02;
+        static constexpr uint32_t completed_reading = 0x04;
+        static constexpr uint32_t finished = 0x08;
+        static constexpr uint32_t cancel_published = 0x10;
+        static constexpr uint32_t cancel_requested = 0x20;
+
+        void invoke_completed()
+        {
+            // Wait for a concurrent call to the Completed getter to finish copying the handler.
+            while (m_flags.load(std::memory_order_acquire) & completed_reading)
+            {
+            }
+
+            CompletedHandler const handler = std::move(m_completed);
+
+            if (handler)
+            {
+                handler(*this, Status());
+            }
+        }
+
+        void rethrow_if_failed(AsyncStatus const status) const
         {
-            if (m_status == AsyncStatus::Error || m_status == AsyncStatus::Canceled)
+            if (status == AsyncStatus::Error)
             {
                 std::rethrow_exception(m_exception);
             }
+
+            if (status == AsyncStatus::Canceled)
+            {
+                throw hresult_canceled();
+            }
         }
 
         std::exception_ptr m_exception{};
-        std::mutex m_lock;
         CompletedHandler m_completed;
         xlang::delegate<> m_cancel;
-        AsyncStatus m_status{ AsyncStatus::Started };
-        bool m_completed_assigned{ false };
+        std::atomic<AsyncStatus> m_status{ AsyncStatus::Started };
+        std::atomic<uint32_t> m_flags{};
     };
 }
-
-#endif
\ No newline at end of file
@@ -1,5 +1,4 @@
 
-#ifdef _WIN32
 namespace xlang
 {
     [[nodiscard]] inline auto resume_background() noexcept
@@ -17,15 +16,12 @@ namespace xlang
 
             void await_suspend(std::experimental::coroutine_handle<> handle) const
             {
-                if (!XLANG_TrySubmitThreadpoolCallback(callback, handle.address(), nullptr))
-                {
-                    throw_last_error();
-                }
+                check_hresult(xlang_submit_threadpool_callback(callback, handle.address()));
             }
 
         private:
 
-            static void XLANG_CALL callback(void*, void* context) noexcept
+            static void XLANG_CALL callback(void* context) noexcept
             {
                 std::experimental::coroutine_handle<>::from_address(context)();
             }
@@ -55,16 +51,12 @@ namespace xlang
             void await_suspend(std::experimental::coroutine_handle<> resume)
             {
                 m_resume = resume;
-
-                if (!XLANG_TrySubmitThreadpoolCallback(callback, this, nullptr))
-                {
-                    throw_last_error();
-                }
+                check_hresult(xlang_submit_threadpool_callback(callback, this));
             }
 
         private:
 
-            static void XLANG_CALL callback(void*, void* context) noexcept
+            static void XLANG_CALL callback(void* context) noexcept
             {
                 auto that = static_cast<awaitable*>(context);
                 auto guard = that->m_context();
@@ -78,40 +70,6 @@ namespace xlang
         return awaitable{ context };
     }
 
-    struct apartment_context
-    {
-        apartment_context()
-        {
-            m_context.capture(XLANG_CoGetObjectContext);
-        }
-
-        bool await_ready() const noexcept
-        {
-            return false;
-        }
-
-        void await_resume() const noexcept
-        {
-        }
-
-        void await_suspend(std::experimental::coroutine_handle<> handle) const
-        {
-            impl::com_callback_args args{};
-            args.data = handle.address();
-            check_hresult(m_context->ContextCallback(callback, &args, guid_of<impl::ICallbackWithNoReentrancyToApplicationSTA>(), 5, nullptr));
-        }
-
-    private:
-
-        static int32_t XLANG_CALL callback(impl::com_callback_args* args) noexcept
-        {
-            std::experimental::coroutine_handle<>::from_address(args->data)();
-            return impl::error_ok;
-        }
-
-        com_ptr<impl::IContextCallback> m_context;
-    };
-
     [[nodiscard]] inline auto resume_after(Foundation::TimeSpan duration) noexcept
     {
         struct awaitable
@@ -128,9 +86,10 @@ namespace xlang
 
             void await_suspend(std::experimental::coroutine_handle<> handle)
             {
-                m_timer.attach(check_pointer(XLANG_CreateThreadpoolTimer(callback, handle.address(), nullptr)));
-                int64_t relative_count = -m_duration.count();
-                XLANG_SetThreadpoolTimer(m_timer.get(), &relative_count, 0, 0);
+                xlang_threadpool_timer timer{};
+                check_hresult(xlang_create_threadpool_timer(callback, handle.address(), &timer));
+                m_timer.attach(timer);
+                xlang_set_threadpool_timer(m_timer.get(), m_duration.count());
             }
 
             void await_resume() const noexcept
@@ -139,18 +98,18 @@ namespace xlang
 
         private:
 
-            static void XLANG_CALL callback(void*, void* context, void*) noexcept
+            static void XLANG_CALL callback(void* context) noexcept
             {
                 std::experimental::coroutine_handle<>::from_address(context)();
             }
 
             struct timer_traits
             {
-                using type = impl::ptp_timer;
+                using type = xlang_threadpool_timer;
 
                 static void close(type value) noexcept
                 {
-                    XLANG_CloseThreadpoolTimer(value);
+                    xlang_close_threadpool_timer(value);
                 }
 
                 static constexpr type invalid() noexcept
@@ -184,39 +143,43 @@ namespace xlang
 
             bool await_ready() const noexcept
             {
+#ifdef _WIN32
                 return XLANG_WaitForSingleObject(m_handle, 0) == 0;
+#else
+                return false;
+#endif
             }
 
             void await_suspend(std::experimental::coroutine_handle<> resume)
             {
                 m_resume = resume;
-                m_wait.attach(check_pointer(XLANG_CreateThreadpoolWait(callback, this, nullptr)));
-                int64_t relative_count = -m_timeout.count();
-                int64_t* file_time = relative_count != 0 ? &relative_count : nullptr;
-                XLANG_SetThreadpoolWait(m_wait.get(), m_handle, file_time);
+                xlang_threadpool_wait wait{};
+                check_hresult(xlang_create_threadpool_wait(callback, this, &wait));
+                m_wait.attach(wait);
+                xlang_set_threadpool_wait(m_wait.get(), m_handle, m_timeout.count());
             }
 
             bool await_resume() const noexcept
             {
-                return m_result == 0;
+                return m_signaled;
             }
 
         private:
 
-            static void XLANG_CALL callback(void*, void* context, void*, uint32_t result) noexcept
+            static void XLANG_CALL callback(void* context, bool signaled) noexcept
             {
                 auto that = static_cast<awaitable*>(context);
-                that->m_result = result;
+                that->m_signaled = signaled;
                 that->m_resume();
             }
 
             struct wait_traits
             {
-                using type = impl::ptp_wait;
+                using type = xlang_threadpool_wait;
 
                 static void close(type value) noexcept
                 {
-                    XLANG_CloseThreadpoolWait(value);
+                    xlang_close_threadpool_wait(value);
                 }
 
                 static constexpr type invalid() noexcept
@@ -228,13 +191,49 @@ namespace xlang
             handle_type<wait_traits> m_wait;
             Foundation::TimeSpan m_timeout;
             void* m_handle;
-            uint32_t m_result{};
+            bool m_signaled{};
             std::experimental::coroutine_handle<> m_resume{ nullptr };
         };
 
         return awaitable{ handle, timeout };
     }
 
+#ifdef _WIN32
+    struct apartment_context
+    {
+        apartment_context()
+        {
+            m_context.capture(XLANG_CoGetObjectContext);
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+        void await_suspend(std::experimental::coroutine_handle<> handle) const
+        {
+            impl::com_callback_args args{};
+            args.data = handle.address();
+            check_hresult(m_context->ContextCallback(callback, &args, guid_of<impl::ICallbackWithNoReentrancyToApplicationSTA>(), 5, nullptr));
+        }
+
+    private:
+
+        static int32_t XLANG_CALL callback(impl::com_callback_args* args) noexcept
+        {
+            std::experimental::coroutine_handle<>::from_address(args->data)();
+            return impl::error_ok;
+        }
+
+        com_ptr<impl::IContextCallback> m_context;
+    };
+
+
     [[nodiscard]] inline auto resume_foreground(
         Windows::UI::Core::CoreDispatcher const& dispatcher,
         Windows::UI::Core::CoreDispatcherPriority const priority = Windows::UI::Core::CoreDispatcherPriority::Normal) noexcept
@@ -314,6 +313,5 @@ namespace xlang
 
         return awaitable{ dispatcher, priority };
     };
-}
-
 #endif
+}
@@ -1,11 +1,44 @@
 
 namespace xlang::impl
 {
+    // Delegates are allocated from an object pool, since handlers tend to be created and released in bursts,
+    // as when subscribing to events or awaiting async operations. Define XLANG_NO_DELEGATE_POOL to allocate
+    // every delegate with the global operator new.
+    struct delegate_pool_traits
+    {
+        static constexpr uint32_t max_cached = 256;
+    };
+
+    using delegate_pool = object_pool<delegate_pool_traits>;
+
     template <typename T, typename H>
     struct implements_delegate : abi_t<T>, H
     {
         implements_delegate(H&& handler) : H(std::forward<H>(handler)) {}
 
+#ifndef XLANG_NO_DELEGATE_POOL
+        static void* operator new(size_t size)
+        {
+            return delegate_pool::allocate(size);
+        }
+
+        // A handler capturing an over-aligned value would otherwise be placed by the overload above, ignoring its alignment.
+        static void* operator new(size_t size, std::align_val_t alignment)
+        {
+            return delegate_pool::allocate(size, alignment);
+        }
+
+        static void operator delete(void* pointer, size_t size) noexcept
+        {
+            delegate_pool::deallocate(pointer, size);
+        }
+
+        static void operator delete(void* pointer, size_t size, std::align_val_t alignment) noexcept
+        {
+            delegate_pool::deallocate(pointer, size, alignment);
+        }
+#endif
+
         int32_t XLANG_CALL QueryInterface(guid const& id, void** result) noexcept final
         {
             if (is_guid_of<T>(id) || is_guid_of<Windows::Foundation::IUnknown>(id))
@@ -59,6 +92,28 @@ namespace xlang::impl
     {
         variadic_delegate(H&& handler) : H(std::forward<H>(handler)) {}
 
+#ifndef XLANG_NO_DELEGATE_POOL
+        static void* operator new(size_t size)
+        {
+            return delegate_pool::allocate(size);
+        }
+
+        static void* operator new(size_t size, std::align_val_t alignment)
+        {
+            return delegate_pool::allocate(size, alignment);
+        }
+
+        static void operator delete(void* pointer, size_t size) noexcept
+        {
+            delegate_pool::deallocate(pointer, size);
+        }
+
+        static void operator delete(void* pointer, size_t size, std::align_val_t alignment) noexcept
+        {
+            delegate_pool::deallocate(pointer, size, alignment);
+        }
+#endif
+
         void invoke(T const&... args) final
         {
             (*this)(args...);
@@ -146,3 +201,11 @@ namespace xlang
         }
     };
 }
+
+namespace xlang
+{
+    inline object_pool_statistics get_delegate_statistics() noexcept
+    {
+        return impl::delegate_pool::statistics();
+    }
+}
@@ -8,6 +8,7 @@
 #include <cinttypes>
 #include <condition_variable>
 #include <cstddef>
+#include <cstring>
 #include <cwchar>
 #include <iterator>
 #include <limits>
@@ -20,6 +21,7 @@
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -267,9 +267,9 @@ namespace xlang::impl
         using pointer = value_type*;
         using iterator = value_type*;
 
-        explicit event_array(uint32_t const count) noexcept : m_size(count)
+        event_array(uint32_t const count, uint32_t const capacity) noexcept : m_size(count), m_capacity(capacity)
         {
-            std::uninitialized_fill_n(data(), count, value_type());
+            std::uninitialized_fill_n(data(), capacity, value_type());
         }
 
         unsigned long AddRef() noexcept
@@ -293,8 +293,8 @@ namespace xlang::impl
 
         reference back() noexcept
         {
-            XLANG_ASSERT(m_size > 0);
-            return*(data() + m_size - 1);
+            XLANG_ASSERT(size() > 0);
+            return*(data() + size() - 1);
         }
 
         iterator begin() noexcept
@@ -304,17 +304,34 @@ namespace xlang::impl
 
         iterator end() noexcept
         {
-            return data() + m_size;
+            return data() + size();
         }
 
         uint32_t size() const noexcept
         {
-            return m_size;
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        // Appends an element to spare capacity, even once the array is published. Only the thread changing
+        // the event may do so, and raisers iterating the array see only the elements it held when they
+        // began, so the new element is raised from the next raise onward.
+        bool try_push_back(value_type const& value) noexcept
+        {
+            uint32_t const count = m_size.load(std::memory_order_relaxed);
+
+            if (count == m_capacity)
+            {
+                return false;
+            }
+
+            *(data() + count) = value;
+            m_size.store(count + 1, std::memory_order_release);
+            return true;
         }
 
         ~event_array() noexcept
         {
-            std::destroy(begin(), end());
+            std::destroy(data(), data() + m_capacity);
         }
 
     private:
@@ -325,20 +342,34 @@ namespace xlang::impl
         }
 
         std::atomic<uint32_t> m_references{ 1 };
-        uint32_t m_size{ 0 };
+        std::atomic<uint32_t> m_size{ 0 };
+        uint32_t const m_capacity{ 0 };
     };
 
     template <typename T>
-    com_ptr<event_array<T>> make_event_array(uint32_t const capacity)
+    com_ptr<event_array<T>> make_event_array(uint32_t const count, uint32_t const capacity)
     {
+        XLANG_ASSERT(count <= capacity);
         void* raw = ::operator new(sizeof(event_array<T>) + (sizeof(T)* capacity));
 #pragma warning(suppress: 6386)
-        return { new(raw) event_array<T>(capacity), take_ownership_from_abi };
+        return { new(raw) event_array<T>(count, capacity), take_ownership_from_abi };
+    }
+
+    // Arrays grow by half again, so that adding handlers one at a time reallocates only
+    // logarithmically often. An event with a single handler gets no spare capacity.
+    inline uint32_t event_array_capacity(uint32_t const count) noexcept
+    {
+        return count <= 1 ? count : count + count / 2;
     }
 }
 
 namespace xlang
 {
+    // Raising an event never takes a lock. Once published, a targets array only grows into its spare
+    // capacity, and raisers announce themselves in one of two reader counts while they take a reference
+    // to it. Changes are serialized by a mutex and, having published a new array, wait until both reader
+    // counts have drained before releasing the old one. Each wait first directs new raisers to the other
+    // count, so that they cannot keep the awaited count from draining.
     template <typename Delegate>
     struct event
     {
@@ -348,9 +379,17 @@ namespace xlang
         event(event<Delegate> const&) = delete;
         event<Delegate>& operator =(event<Delegate> const&) = delete;
 
+        ~event() noexcept
+        {
+            if (auto targets = m_targets.load(std::memory_order_relaxed))
+            {
+                targets->Release();
+            }
+        }
+
         explicit operator bool() const noexcept
         {
-            return m_targets != nullptr;
+            return m_targets.load(std::memory_order_relaxed) != nullptr;
         }
 
         event_token add(delegate_type const& delegate)
@@ -362,18 +401,24 @@ namespace xlang
 
             {
                 std::lock_guard const change_guard(m_change);
-                delegate_array new_targets = impl::make_event_array<delegate_type>((!m_targets) ? 1 : m_targets->size() + 1);
+                delegate_array const old_targets = acquire_targets();
+
+                if (old_targets && old_targets->try_push_back(delegate))
+                {
+                    return get_token(old_targets->back());
+                }
+
+                uint32_t const count = (!old_targets) ? 1 : old_targets->size() + 1;
+                delegate_array new_targets = impl::make_event_array<delegate_type>(count, impl::event_array_capacity(count));
 
-                if (m_targets)
+                if (old_targets)
                 {
-                    std::copy_n(m_targets->begin(), m_targets->size(), new_targets->begin());
+                    std::copy_n(old_targets->begin(), old_targets->size(), new_targets->begin());
                 }
 
                 new_targets->back() = delegate;
                 token = get_token(new_targets->back());
-
-                std::lock_guard const swap_guard(m_swap);
-                temp_targets = std::exchange(m_targets, std::move(new_targets));
+                temp_targets = publish_targets(std::move(new_targets));
             }
 
             return token;
@@ -386,29 +431,30 @@ namespace xlang
 
             {
                 std::lock_guard const change_guard(m_change);
+                delegate_array const old_targets = acquire_targets();
 
-                if (!m_targets)
+                if (!old_targets)
                 {
                     return;
                 }
 
-                uint32_t available_slots = m_targets->size() - 1;
+                uint32_t available_slots = old_targets->size() - 1;
                 delegate_array new_targets;
                 bool removed = false;
 
                 if (available_slots == 0)
                 {
-                    if (get_token(*m_targets->begin()) == token)
+                    if (get_token(*old_targets->begin()) == token)
                     {
                         removed = true;
                     }
                 }
                 else
                 {
-                    new_targets = impl::make_event_array<delegate_type>(available_slots);
+                    new_targets = impl::make_event_array<delegate_type>(available_slots, impl::event_array_capacity(available_slots));
                     auto new_iterator = new_targets->begin();
 
-                    for (delegate_type const& element : *m_targets)
+                    for (delegate_type const& element : *old_targets)
                     {
                         if (!removed && token == get_token(element))
                         {
@@ -430,8 +476,7 @@ namespace xlang
 
                 if (removed)
                 {
-                    std::lock_guard const swap_guard(m_swap);
-                    temp_targets = std::exchange(m_targets, std::move(new_targets));
+                    temp_targets = publish_targets(std::move(new_targets));
                 }
             }
         }
@@ -439,12 +484,7 @@ namespace xlang
         template<typename...Arg>
         void operator()(Arg const&... args)
         {
-            delegate_array temp_targets;
-
-            {
-                std::lock_guard const swap_guard(m_swap);
-                temp_targets = m_targets;
-            }
+            delegate_array temp_targets = acquire_targets();
 
             if (temp_targets)
             {
@@ -476,15 +516,50 @@ namespace xlang
 
     private:
 
+        using delegate_array = com_ptr<impl::event_array<delegate_type>>;
+
         event_token get_token(delegate_type const& delegate) const noexcept
         {
             return event_token{ reinterpret_cast<int64_t>(get_abi(delegate)) };
         }
 
-        using delegate_array = com_ptr<impl::event_array<delegate_type>>;
+        delegate_array acquire_targets() noexcept
+        {
+            std::atomic<uint32_t>& readers = m_readers[m_epoch.load(std::memory_order_relaxed)];
+            readers.fetch_add(1, std::memory_order_seq_cst);
+
+            delegate_array targets;
+            targets.copy_from(m_targets.load(std::memory_order_seq_cst));
+
+            readers.fetch_sub(1, std::memory_order_release);
+            return targets;
+        }
+
+        // Called with m_change held. Returns the previous targets, which no raiser can still be about to acquire.
+        delegate_array publish_targets(delegate_array&& targets) noexcept
+        {
+            delegate_array previous;
+            previous.attach(m_targets.exchange(targets.detach(), std::memory_order_seq_cst));
+
+            // A raiser that counts itself after its count is seen to be zero must load the new targets.
+            // Flipping the epoch before each wait directs new raisers to the other count.
+            for (uint32_t pass = 0; pass < 2; ++pass)
+            {
+                uint32_t const epoch = m_epoch.load(std::memory_order_relaxed);
+                m_epoch.store(epoch ^ 1, std::memory_order_relaxed);
+
+                while (m_readers[epoch].load(std::memory_order_seq_cst) != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            return previous;
+        }
 
-        delegate_array m_targets;
-        std::mutex m_swap;
+        std::atomic<impl::event_array<delegate_type>*> m_targets{};
+        std::atomic<uint32_t> m_epoch{};
+        std::atomic<uint32_t> m_readers[2]{};
         std::mutex m_change;
     };
 }
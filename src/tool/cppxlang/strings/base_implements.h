@@ -360,10 +360,211 @@ namespace xlang::impl
         }
     };
 
+    // QueryInterface finds an implemented interface through a perfect hash of the interface ids, computed
+    // at compile time for each implementation type. A lookup, whether it hits or misses, hashes the id,
+    // compares it with at most one candidate, and adjusts the object pointer. Types implementing more
+    // interfaces than the hash supports, or whose ids no probed seed separates, search the list instead.
+    constexpr bool guid_equal(guid const& left, guid const& right) noexcept
+    {
+        if (left.Data1 != right.Data1 || left.Data2 != right.Data2 || left.Data3 != right.Data3)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            if (left.Data4[i] != right.Data4[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    constexpr uint64_t guid_hash_key(guid const& id) noexcept
+    {
+        uint64_t const first = (uint64_t{ id.Data1 } << 32) | (uint64_t{ id.Data2 } << 16) | id.Data3;
+        uint64_t second{};
+
+        for (uint8_t const value : id.Data4)
+        {
+            second = (second << 8) | value;
+        }
+
+        return first ^ (second * 0x9e3779b97f4a7c15);
+    }
+
+    template <size_t Count>
+    struct interface_hash
+    {
+        static constexpr size_t max_count = 64;
+
+        // The search for a seed is bounded by the work it does, counted as the bitmap words cleared and the
+        // ids placed by each attempt, rather than by a number of attempts. This keeps even a search that
+        // finds no seed well within the compilers' limits on constant evaluation (MSVC defaults to 100K
+        // steps) for any number of interfaces. At 64 interfaces it allows four seeds, after which the
+        // type falls back to the linear search.
+        static constexpr size_t max_work = 512;
+
+        static constexpr uint32_t slot_bits() noexcept
+        {
+            // With at least Count squared slots, a random seed separates the ids with a probability above
+            // one half, so one or two seeds are usually enough.
+            uint32_t bits = 3;
+
+            while ((size_t{ 1 } << bits) < Count * Count)
+            {
+                ++bits;
+            }
+
+            return bits;
+        }
+
+        static constexpr uint32_t shift = 64 - slot_bits();
+        static constexpr size_t slot_count = size_t{ 1 } << slot_bits();
+
+        // Each attempt clears a bitmap of the slots and then places every id.
+        static constexpr size_t used_words = (slot_count + 63) / 64;
+        static constexpr size_t max_attempts = max_work / (used_words + Count);
+
+        constexpr size_t slot(uint64_t key) const noexcept
+        {
+            return static_cast<size_t>((key * seed) >> shift);
+        }
+
+        // Each slot holds one more than the index of its interface, so that zero marks an empty slot and the
+        // table needs no initialization beyond zeroing.
+        uint64_t seed{};
+        uint8_t slots[Count <= max_count ? slot_count : 1]{};
+        bool perfect{};
+    };
+
+    template <size_t Count>
+    constexpr interface_hash<Count> make_interface_hash(guid const (&ids)[Count]) noexcept
+    {
+        using hash_type = interface_hash<Count>;
+        hash_type result{};
+
+        if constexpr (Count > hash_type::max_count)
+        {
+            return result;
+        }
+        else
+        {
+            uint64_t keys[Count]{};
+
+            for (size_t i = 0; i < Count; ++i)
+            {
+                keys[i] = guid_hash_key(ids[i]);
+            }
+
+            uint64_t state{};
+
+            for (size_t attempt = 0; attempt < hash_type::max_attempts; ++attempt)
+            {
+                // Seeds are drawn from the splitmix64 sequence.
+                state += 0x9e3779b97f4a7c15;
+                uint64_t seed = (state ^ (state >> 30)) * 0xbf58476d1ce4e5b9;
+                seed = (seed ^ (seed >> 27)) * 0x94d049bb133111eb;
+                result.seed = (seed ^ (seed >> 31)) | 1;
+
+                uint64_t used[hash_type::used_words]{};
+                bool collided = false;
+
+                for (size_t i = 0; i < Count && !collided; ++i)
+                {
+                    size_t const slot = result.slot(keys[i]);
+                    uint64_t const bit = uint64_t{ 1 } << (slot % 64);
+
+                    if (!(used[slot / 64] & bit))
+                    {
+                        used[slot / 64] |= bit;
+                    }
+                    else
+                    {
+                        // An interface listed more than once keeps its first entry, as with a linear search.
+                        for (size_t previous = 0; previous < i; ++previous)
+                        {
+                            if (result.slot(keys[previous]) == slot)
+                            {
+                                collided = !guid_equal(ids[previous], ids[i]);
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if (!collided)
+                {
+                    for (size_t i = Count; i > 0; --i)
+                    {
+                        // Filled in reverse, so that the first of any repeated interfaces wins.
+                        result.slots[result.slot(keys[i - 1])] = static_cast<uint8_t>(i);
+                    }
+
+                    result.perfect = true;
+                    return result;
+                }
+            }
+
+            return result;
+        }
+    }
+
+    template <typename T, typename List>
+    struct interface_table;
+
+    template <typename T>
+    struct interface_table<T, interface_list<>>
+    {
+        static void* find(const T*, const guid&) noexcept
+        {
+            return nullptr;
+        }
+    };
+
+    template <typename T, typename... I>
+    struct interface_table<T, interface_list<I...>>
+    {
+        static void* find(const T* obj, const guid& iid) noexcept
+        {
+            if constexpr (hash.perfect)
+            {
+                uint8_t const index = hash.slots[hash.slot(guid_hash_key(iid))];
+
+                if (index && ids[index - 1] == iid)
+                {
+                    return getters[index - 1](obj);
+                }
+
+                return nullptr;
+            }
+            else
+            {
+                return interface_list<I...>::find(obj, iid_finder{ iid });
+            }
+        }
+
+    private:
+
+        template <typename Interface>
+        static void* get(const T* obj) noexcept
+        {
+            return to_abi<Interface>(obj);
+        }
+
+        using getter = void* (*)(const T*) noexcept;
+
+        static constexpr guid ids[]{ guid_of<I>()... };
+        static constexpr getter getters[]{ &get<I>... };
+        static constexpr interface_hash<sizeof...(I)> hash = make_interface_hash(ids);
+    };
+
     template <typename T>
     auto find_iid(const T* obj, const guid& iid) noexcept
     {
-        return static_cast<unknown_abi*>(implemented_interfaces<T>::find(obj, iid_finder{ iid }));
+        return static_cast<unknown_abi*>(interface_table<T, implemented_interfaces<T>>::find(obj, iid));
     }
 
     struct xlang_object_finder
@@ -1241,7 +1442,9 @@ namespace xlang
 
         hstring GetObjectInfo_TypeName() const override
         {
-            return impl::runtime_class_name<typename impl::implements_default_interface<D>::type>::get();
+            // The name is interned once per implementation type, so that each query only copies an immortal handle.
+            static hstring const name{ impl::intern_string(std::basic_string_view<xlang_char8>(impl::runtime_class_name<typename impl::implements_default_interface<D>::type>::get())), take_ownership_from_abi };
+            return name;
         }
 
         uint32_t GetObjectInfo_HashCode() const override
@@ -0,0 +1,167 @@
+
+namespace xlang
+{
+    struct object_pool_statistics
+    {
+        // Objects allocated from and returned to the heap, including objects too large to be pooled.
+        uint64_t heap_allocations;
+        uint64_t heap_deallocations;
+
+        // Objects reused from a per-thread pool. Each thread publishes this count in batches, so it
+        // may lag behind by a few hundred allocations per thread.
+        uint64_t pooled_allocations;
+    };
+}
+
+namespace xlang::impl
+{
+    // Small, short-lived heap objects are recycled through per-thread free lists, one for each 64 byte
+    // size class up to 1 KiB. Objects may be freed on a different thread than the one that allocated
+    // them, in which case they join the freeing thread's lists. Each list holds at most
+    // Traits::max_cached objects, and larger or over-aligned objects always come from the heap. Each
+    // Traits type gets its own lists and statistics.
+    template <typename Traits>
+    struct object_pool
+    {
+        static constexpr size_t granularity = 64;
+        static constexpr size_t class_count = 16;
+        static constexpr uint32_t max_cached = Traits::max_cached;
+        static constexpr uint32_t statistics_batch = 256;
+
+        static void* allocate(size_t size)
+        {
+            size_t const index = size_class(size);
+
+            if (index < class_count)
+            {
+                if (thread_cache* cache = local_cache())
+                {
+                    if (free_object* object = cache->objects[index])
+                    {
+                        cache->objects[index] = object->next;
+                        --cache->counts[index];
+
+                        // Pooled allocations are tallied per thread and published in batches, so the
+                        // fast path does not write to memory shared with other threads.
+                        if (++cache->unpublished_allocations == statistics_batch)
+                        {
+                            cache->publish_statistics();
+                        }
+
+                        return object;
+                    }
+                }
+
+                // Allocate the whole size class, so that the block can later be reused by any object of the class.
+                size = (index + 1) * granularity;
+            }
+
+            heap_allocations.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+
+        static void deallocate(void* pointer, size_t size) noexcept
+        {
+            size_t const index = size_class(size);
+
+            if (index < class_count)
+            {
+                thread_cache* cache = local_cache();
+
+                if (cache && cache->counts[index] < max_cached)
+                {
+                    auto object = static_cast<free_object*>(pointer);
+                    object->next = cache->objects[index];
+                    cache->objects[index] = object;
+                    ++cache->counts[index];
+                    return;
+                }
+            }
+
+            heap_deallocations.fetch_add(1, std::memory_order_relaxed);
+            ::operator delete(pointer);
+        }
+
+        // Pooled blocks only have the default alignment, so over-aligned objects always come from the heap.
+        static void* allocate(size_t size, std::align_val_t alignment)
+        {
+            heap_allocations.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size, alignment);
+        }
+
+        static void deallocate(void* pointer, size_t size, std::align_val_t alignment) noexcept
+        {
+            heap_deallocations.fetch_add(1, std::memory_order_relaxed);
+            ::operator delete(pointer, size, alignment);
+        }
+
+        static object_pool_statistics statistics() noexcept
+        {
+            return
+            {
+                heap_allocations.load(std::memory_order_relaxed),
+                heap_deallocations.load(std::memory_order_relaxed),
+                pooled_allocations.load(std::memory_order_relaxed)
+            };
+        }
+
+    private:
+
+        struct free_object
+        {
+            free_object* next;
+        };
+
+        struct thread_cache
+        {
+            ~thread_cache()
+            {
+                publish_statistics();
+                cache_destroyed = true;
+
+                for (free_object* object : objects)
+                {
+                    while (object)
+                    {
+                        free_object* const next = object->next;
+                        heap_deallocations.fetch_add(1, std::memory_order_relaxed);
+                        ::operator delete(object);
+                        object = next;
+                    }
+                }
+            }
+
+            void publish_statistics() noexcept
+            {
+                pooled_allocations.fetch_add(unpublished_allocations, std::memory_order_relaxed);
+                unpublished_allocations = 0;
+            }
+
+            free_object* objects[class_count]{};
+            uint32_t counts[class_count]{};
+            uint32_t unpublished_allocations{};
+        };
+
+        static constexpr size_t size_class(size_t size) noexcept
+        {
+            return size == 0 ? 0 : (size - 1) / granularity;
+        }
+
+        static thread_cache* local_cache() noexcept
+        {
+            // Objects destroyed by other thread_local destructors, after the cache itself is gone, bypass it.
+            if (cache_destroyed)
+            {
+                return nullptr;
+            }
+
+            static thread_local thread_cache cache;
+            return &cache;
+        }
+
+        inline static std::atomic<uint64_t> heap_allocations{};
+        inline static std::atomic<uint64_t> heap_deallocations{};
+        inline static std::atomic<uint64_t> pooled_allocations{};
+        inline static thread_local bool cache_destroyed{};
+    };
+}
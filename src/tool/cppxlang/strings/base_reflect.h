@@ -38,7 +38,7 @@ namespace xlang::experimental::reflect
     using property_name = typename MetaProperty::name;
 
     template <typename MetaProperty>
-    inline constexpr std::wstring_view property_name_v = property_name<MetaProperty>::value;
+    inline constexpr std::string_view property_name_v = property_name<MetaProperty>::value;
 
     template <typename MetaProperty>
     using is_property_readable = typename MetaProperty::is_readable;
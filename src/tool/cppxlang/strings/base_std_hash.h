@@ -28,6 +28,33 @@ namespace xlang::impl
         return std::hash<void*>{}(abi_value);
     }
 
+    // Spreads a 32-bit hash across size_t, so that the bits that a hash table picks its bucket from depend
+    // on all of the input, rather than widening it and leaving the upper half zero.
+    inline size_t mix_hash(uint32_t const value) noexcept
+    {
+        uint64_t const result = value * 0x9e3779b97f4a7c15ull;
+        return static_cast<size_t>(result ^ (result >> 32));
+    }
+
+    // Objects report an identity hash through GetObjectInfo, which avoids querying for IUnknown and the
+    // reference counting that comes with it. An object that fails to report one is hashed by identity.
+    inline size_t hash_xlang_object(Windows::Foundation::IXlangObject const& value) noexcept
+    {
+        if (!value)
+        {
+            return 0;
+        }
+
+        try
+        {
+            return mix_hash(get_HashCode(value));
+        }
+        catch (...)
+        {
+            return hash_unknown(value);
+        }
+    }
+
     template<typename T>
     struct hash_base
     {
@@ -50,6 +77,12 @@ namespace std
     };
 
     template<> struct hash<xlang::Windows::Foundation::IUnknown> : xlang::impl::hash_base<xlang::Windows::Foundation::IUnknown> {};
-    template<> struct hash<xlang::Windows::Foundation::IXlangObject> : xlang::impl::hash_base<xlang::Windows::Foundation::IXlangObject> {};
+    template<> struct hash<xlang::Windows::Foundation::IXlangObject>
+    {
+        size_t operator()(xlang::Windows::Foundation::IXlangObject const& value) const noexcept
+        {
+            return xlang::impl::hash_xlang_object(value);
+        }
+    };
     template<> struct hash<xlang::Windows::Foundation::IActivationFactory> : xlang::impl::hash_base<xlang::Windows::Foundation::IActivationFactory> {};
 }
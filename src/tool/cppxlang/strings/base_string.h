@@ -54,6 +54,24 @@ namespace xlang::impl
         return result;
     }
 
+    // Interned strings are immortal, so copying or releasing one never touches the heap.
+    template <typename char_type, typename = std::enable_if_t<is_char_type_supported<char_type>::value>>
+    inline xlang_string intern_string(std::basic_string_view<char_type> value)
+    {
+        xlang_string result = nullptr;
+        auto const normalized = normalize_char_type(value);
+        auto const length = static_cast<uint32_t>(normalized.size());
+        if constexpr (sizeof(char_type) == sizeof(xlang_char8))
+        {
+            check_hresult(xlang_intern_string_utf8(normalized.data(), length, &result));
+        }
+        else
+        {
+            check_hresult(xlang_intern_string_utf16(normalized.data(), length, &result));
+        }
+        return result;
+    }
+
     struct hstring_traits
     {
         using type = xlang_string;
@@ -11,8 +11,6 @@ namespace xlang::impl
 #endif
 
     using ptp_io = struct tp_io*;
-    using ptp_timer = struct tp_timer*;
-    using ptp_wait = struct tp_wait*;
     using bstr = wchar_t*;
 }
 